@@ -9,6 +9,7 @@
 #include "../../core/eosio/datastream.hpp"
 #include "../../core/eosio/name.hpp"
 #include "../../core/eosio/ignore.hpp"
+#include "../../core/eosio/packed_extension.hpp"
 #include "../../core/eosio/time.hpp"
 
 #include <boost/preprocessor/variadic/size.hpp>
@@ -258,6 +259,45 @@ namespace eosio {
       return internal_use_do_not_use::is_account( n.value );
    }
 
+   /// @cond INTERNAL
+
+   namespace detail {
+      /**
+       *  Send an inline action of size bytes, serialized by write into a buffer on the stack, or
+       *  on the heap when larger than 512 bytes
+       */
+      template<typename Write>
+      void send_action_buffer( size_t size, bool context_free, Write&& write ) {
+         constexpr size_t max_stack_buffer_size = 512;
+         char* buffer = (char*)( max_stack_buffer_size < size ? malloc(size) : alloca(size) );
+         datastream<char*> ds( buffer, size );
+         write( ds );
+         if( context_free )
+            internal_use_do_not_use::send_context_free_inline( buffer, size );
+         else
+            internal_use_do_not_use::send_inline( buffer, size );
+         if( max_stack_buffer_size < size )
+            free( buffer );
+      }
+
+      /**
+       *  Send an inline action whose data is value, serialized with the rest of the action in
+       *  one buffer rather than packed into a vector of its own first
+       */
+      template<typename T>
+      void send_action( name account, name act, const std::vector<permission_level>& auths, const T& value, bool context_free ) {
+         if( context_free )
+            eosio::check( auths.size() == 0, "context free actions cannot have authorizations" );
+         const unsigned_int data_size = pack_size( value );
+         const size_t size = pack_size( account ) + pack_size( act ) + pack_size( auths ) + pack_size( data_size ) + data_size.value;
+         send_action_buffer( size, context_free, [&]( auto& ds ) {
+            ds << account << act << auths << data_size << value;
+         });
+      }
+   }
+
+   /// @endcond
+
    /**
     *  This is the packed representation of an action along with
     *  meta-data about the authorization levels.
@@ -326,8 +366,7 @@ namespace eosio {
        * Send the action as inline action
        */
       void send() const {
-         auto serialize = pack(*this);
-         internal_use_do_not_use::send_inline(serialize.data(), serialize.size());
+         detail::send_action_buffer( pack_size(*this), false, [this]( auto& ds ) { ds << *this; } );
       }
 
       /**
@@ -337,8 +376,7 @@ namespace eosio {
        */
       void send_context_free() const {
          eosio::check( authorization.size() == 0, "context free actions cannot have authorizations");
-         auto serialize = pack(*this);
-         internal_use_do_not_use::send_context_free_inline(serialize.data(), serialize.size());
+         detail::send_action_buffer( pack_size(*this), true, [this]( auto& ds ) { ds << *this; } );
       }
 
       /**
@@ -366,6 +404,9 @@ namespace eosio {
       template <typename T>
       struct unwrap<ignore<T>> { typedef T type; };
 
+      template <typename T>
+      struct unwrap<packed_extension<T>> { typedef T type; };
+
       template <typename R, typename Act, typename... Args>
       auto get_args(R(Act::*p)(Args...)) {
          return std::tuple<std::decay_t<typename unwrap<Args>::type>...>{};
@@ -484,12 +525,14 @@ namespace eosio {
       }
       template <typename... Args>
       void send(Args&&... args)const {
-         to_action(std::forward<Args>(args)...).send();
+         static_assert(detail::type_check<Action, Args...>());
+         detail::send_action(code_name, action_name, permissions, detail::deduced<Action>{std::forward<Args>(args)...}, false);
       }
 
       template <typename... Args>
       void send_context_free(Args&&... args)const {
-         to_action(std::forward<Args>(args)...).send_context_free();
+         static_assert(detail::type_check<Action, Args...>());
+         detail::send_action(code_name, action_name, permissions, detail::deduced<Action>{std::forward<Args>(args)...}, true);
       }
 
    };
@@ -531,12 +574,16 @@ namespace eosio {
 
       template <size_t Variant, typename... Args>
       void send(Args&&... args)const {
-         to_action<Variant>(std::forward<Args>(args)...).send();
+         static_assert(detail::type_check<detail::get_nth<Variant, Actions...>::value, Args...>());
+         unsigned_int var = Variant;
+         detail::send_action(code_name, action_name, permissions, std::tuple_cat(std::make_tuple(var), detail::deduced<detail::get_nth<Variant, Actions...>::value>{std::forward<Args>(args)...}), false);
       }
 
       template <size_t Variant, typename... Args>
       void send_context_free(Args&&... args) const {
-         to_action<Variant>(std::forward<Args>(args)...).send_context_free();
+         static_assert(detail::type_check<detail::get_nth<Variant, Actions...>::value, Args...>());
+         unsigned_int var = Variant;
+         detail::send_action(code_name, action_name, permissions, std::tuple_cat(std::make_tuple(var), detail::deduced<detail::get_nth<Variant, Actions...>::value>{std::forward<Args>(args)...}), true);
       }
 
    };
@@ -545,7 +592,7 @@ namespace eosio {
    void dispatch_inline( name code, name act,
                          std::vector<permission_level> perms,
                          std::tuple<Args...> args ) {
-      action( perms, code, act, std::move(args) ).send();
+      detail::send_action( code, act, perms, args, false );
    }
 
    template<typename, name::raw>
@@ -1,11 +1,15 @@
 #pragma once
 #include "action.hpp"
+#include "../../core/eosio/perfect_hash.hpp"
 
 #include <boost/fusion/adapted/std_tuple.hpp>
 #include <boost/fusion/include/std_tuple.hpp>
 
 #include <boost/mp11/tuple.hpp>
 
+#include <boost/preprocessor/punctuation/comma_if.hpp>
+#include <boost/preprocessor/seq/for_each_i.hpp>
+
 namespace eosio {
 
   /**
@@ -26,6 +30,19 @@ namespace eosio {
       return false;
    }
 
+   namespace detail {
+      template<typename Action, typename = void>
+      struct has_constexpr_action_name : std::false_type {};
+
+      template<typename Action>
+      struct has_constexpr_action_name<Action, std::void_t<std::integral_constant<uint64_t, Action::get_account()>,
+                                                           std::integral_constant<uint64_t, Action::get_name()>>> : std::true_type {};
+
+      constexpr uint64_t dispatch_key( uint64_t code, uint64_t act ) {
+         return act ^ perfect_hash_mix( code );
+      }
+   }
+
    /// @endcond
 
    /**
@@ -37,16 +54,33 @@ namespace eosio {
     *
     * For this to work the Actions must be derived from eosio::contract
     *
+    * When the get_account() and get_name() of every action are constexpr, the action is found
+    * in a perfect_hash of (code, act) built at compile time rather than by comparing each one.
+    *
     * @ingroup dispatcher
     *
     */
    template<typename Contract, typename FirstAction, typename SecondAction, typename... Actions>
    bool dispatch( uint64_t code, uint64_t act ) {
-      if( code == FirstAction::get_account() && FirstAction::get_name() == act ) {
-         Contract().on( unpack_action_data<FirstAction>() );
-         return true;
+      if constexpr( detail::has_constexpr_action_name<FirstAction>::value &&
+                    detail::has_constexpr_action_name<SecondAction>::value &&
+                    (detail::has_constexpr_action_name<Actions>::value && ...) ) {
+         static constexpr uint64_t keys[] = { detail::dispatch_key( FirstAction::get_account(), FirstAction::get_name() ),
+                                              detail::dispatch_key( SecondAction::get_account(), SecondAction::get_name() ),
+                                              detail::dispatch_key( Actions::get_account(), Actions::get_name() )... };
+         static constexpr perfect_hash table( keys );
+         static constexpr bool (*handlers[])( uint64_t, uint64_t ) = { &eosio::dispatch<Contract,FirstAction>,
+                                                                       &eosio::dispatch<Contract,SecondAction>,
+                                                                       &eosio::dispatch<Contract,Actions>... };
+         const size_t i = table.find( detail::dispatch_key( code, act ) );
+         return i < table.size() && handlers[i]( code, act );
+      } else {
+         if( code == FirstAction::get_account() && FirstAction::get_name() == act ) {
+            Contract().on( unpack_action_data<FirstAction>() );
+            return true;
+         }
+         return eosio::dispatch<Contract,SecondAction,Actions...>( code, act );
       }
-      return eosio::dispatch<Contract,SecondAction,Actions...>( code, act );
    }
 
 
@@ -104,11 +138,24 @@ namespace eosio {
  #define EOSIO_DISPATCH_HELPER( TYPE,  MEMBERS ) \
     BOOST_PP_SEQ_FOR_EACH( EOSIO_DISPATCH_INTERNAL, TYPE, MEMBERS )
 
+ // Helper macro for EOSIO_DISPATCH, the name of an action
+ #define EOSIO_DISPATCH_NAME( r, OP, i, elem ) \
+    BOOST_PP_COMMA_IF(i) eosio::name( BOOST_PP_STRINGIZE(elem) ).value
+
+ // Helper macro for EOSIO_DISPATCH, the handler of an action
+ #define EOSIO_DISPATCH_HANDLER( r, OP, i, elem ) \
+    BOOST_PP_COMMA_IF(i) []( uint64_t receiver, uint64_t code ) { \
+       eosio::execute_action( eosio::name(receiver), eosio::name(code), &OP::elem ); \
+    }
+
 /// @endcond
 
 /**
  * Convenient macro to create contract apply handler
  *
+ * The action is found in a perfect_hash of the action names built at compile time, with one
+ * comparison of names whatever the number of actions.
+ *
  * @ingroup dispatcher
  * @note To be able to use this macro, the contract needs to be derived from eosio::contract
  * @param TYPE - The class name of the contract
@@ -124,9 +171,12 @@ extern "C" { \
    [[eosio::wasm_entry]] \
    void apply( uint64_t receiver, uint64_t code, uint64_t action ) { \
       if( code == receiver ) { \
-         switch( action ) { \
-            EOSIO_DISPATCH_HELPER( TYPE, MEMBERS ) \
-         } \
+         static constexpr uint64_t actions[] = { BOOST_PP_SEQ_FOR_EACH_I( EOSIO_DISPATCH_NAME, TYPE, MEMBERS ) }; \
+         static constexpr eosio::perfect_hash table( actions ); \
+         static constexpr void (*handlers[])( uint64_t, uint64_t ) = { BOOST_PP_SEQ_FOR_EACH_I( EOSIO_DISPATCH_HANDLER, TYPE, MEMBERS ) }; \
+         const size_t i = table.find( action ); \
+         if( i < table.size() ) \
+            handlers[i]( receiver, code ); \
          /* does not allow destructor of thiscontract to run: eosio_exit(0); */ \
       } \
    } \
@@ -330,6 +330,49 @@ namespace _multi_index_detail {
       static constexpr eosio::fixed_bytes<32> true_lowest() { return eosio::fixed_bytes<32>(); }
    };
 
+   // byte_checksum256 is packed into the words of idx256 only for the database calls
+   template<>
+   struct secondary_index_db_functions<eosio::byte_checksum<32>> {
+      using words_db = secondary_index_db_functions<eosio::fixed_bytes<32>>;
+
+      static int32_t db_idx_next( int32_t iterator, uint64_t* primary )          { return words_db::db_idx_next( iterator, primary ); }
+      static int32_t db_idx_previous( int32_t iterator, uint64_t* primary )      { return words_db::db_idx_previous( iterator, primary ); }
+      static void    db_idx_remove( int32_t iterator )                           { words_db::db_idx_remove( iterator ); }
+      static int32_t db_idx_end( uint64_t code, uint64_t scope, uint64_t table ) { return words_db::db_idx_end( code, scope, table ); }
+      static int32_t db_idx_store( uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const eosio::byte_checksum<32>& secondary ) {
+         return words_db::db_idx_store( scope, table, payer, id, secondary.to_fixed_bytes() );
+      }
+      static void    db_idx_update( int32_t iterator, uint64_t payer, const eosio::byte_checksum<32>& secondary ) {
+         words_db::db_idx_update( iterator, payer, secondary.to_fixed_bytes() );
+      }
+      static int32_t db_idx_find_primary( uint64_t code, uint64_t scope, uint64_t table, uint64_t primary, eosio::byte_checksum<32>& secondary ) {
+         eosio::fixed_bytes<32> words;
+         auto itr = words_db::db_idx_find_primary( code, scope, table, primary, words );
+         secondary = eosio::byte_checksum<32>( words );
+         return itr;
+      }
+      static int32_t db_idx_find_secondary( uint64_t code, uint64_t scope, uint64_t table, const eosio::byte_checksum<32>& secondary, uint64_t& primary ) {
+         return words_db::db_idx_find_secondary( code, scope, table, secondary.to_fixed_bytes(), primary );
+      }
+      static int32_t db_idx_lowerbound( uint64_t code, uint64_t scope, uint64_t table, eosio::byte_checksum<32>& secondary, uint64_t& primary ) {
+         auto words = secondary.to_fixed_bytes();
+         auto itr = words_db::db_idx_lowerbound( code, scope, table, words, primary );
+         secondary = eosio::byte_checksum<32>( words );
+         return itr;
+      }
+      static int32_t db_idx_upperbound( uint64_t code, uint64_t scope, uint64_t table, eosio::byte_checksum<32>& secondary, uint64_t& primary ) {
+         auto words = secondary.to_fixed_bytes();
+         auto itr = words_db::db_idx_upperbound( code, scope, table, words, primary );
+         secondary = eosio::byte_checksum<32>( words );
+         return itr;
+      }
+   };
+
+   template<>
+   struct secondary_key_traits<eosio::byte_checksum<32>> {
+      static constexpr eosio::byte_checksum<32> true_lowest() { return eosio::byte_checksum<32>(); }
+   };
+
 }
 
 /**
@@ -384,6 +427,7 @@ struct indexed_by {
  *  - double
  *  - long double
  *  - eosio::checksum256
+ *  - eosio::byte_checksum256
  *
  *  @tparam TableName - name of the table
  *  @tparam T - type of the data stored inside the table
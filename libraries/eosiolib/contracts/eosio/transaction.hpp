@@ -134,6 +134,142 @@ namespace eosio {
       EOSLIB_SERIALIZE_DERIVED( transaction, transaction_header, (context_free_actions)(actions)(transaction_extensions) )
    };
 
+   /**
+    *  Class transaction_builder serializes the actions of a deferred transaction as they are added
+    *
+    *  @ingroup transaction
+    *  @details Each action, with its arguments as data, is written once at the end of a single
+    *  buffer rather than packed into an action of its own and copied into the packed transaction.
+    *  Room is kept at the front of the buffer for the header and the number of actions, which
+    *  are written when the transaction is sent. Generated transactions cannot have context free
+    *  actions or extensions, so the builder has neither.
+    *
+    *  **Example:**
+    *  ```
+    *     transaction_builder trx;
+    *     trx.delay_sec = 60;
+    *     for( const auto& payout : payouts )
+    *        trx.add_action( permission_level{get_self(), "active"_n}, "eosio.token"_n, "transfer"_n,
+    *                        get_self(), payout.to, payout.quantity, std::string("payout") );
+    *     trx.send( sender_id, get_self() );
+    *  ```
+    */
+   class transaction_builder : public transaction_header {
+   public:
+
+      /**
+       * Construct a new transaction_builder with an expiration of now + 60 seconds.
+       */
+      transaction_builder(time_point_sec exp = time_point_sec(current_time_point()) + 60)
+         : transaction_header( exp ), _buffer( max_prefix_size ) {}
+
+      /**
+       * Reserve room for size bytes of serialized actions
+       */
+      void reserve( size_t size ) {
+         _buffer.reserve( max_prefix_size + size + 1 );
+      }
+
+      /**
+       * Add an action whose data are the given arguments, serialized in order
+       *
+       * @param auth - The permission that authorizes the action
+       * @param account - The account the action is intended for
+       * @param act - The name of the action
+       * @param args - The arguments of the action
+       */
+      template<typename... Args>
+      transaction_builder& add_action( const permission_level& auth, name account, name act, const Args&... args ) {
+         return append_action( account, act, &auth, 1, args... );
+      }
+
+      /**
+       * Add an action whose data are the given arguments, serialized in order
+       *
+       * @param auths - The permissions that authorize the action
+       * @param account - The account the action is intended for
+       * @param act - The name of the action
+       * @param args - The arguments of the action
+       */
+      template<typename... Args>
+      transaction_builder& add_action( const std::vector<permission_level>& auths, name account, name act, const Args&... args ) {
+         return append_action( account, act, auths.data(), auths.size(), args... );
+      }
+
+      /**
+       * Add the action of an action_wrapper, with the given arguments
+       *
+       * @param wrapper - The action, its account and its permissions
+       * @param args - The arguments of the action
+       */
+      template<eosio::name::raw Name, auto Action, typename... Args>
+      transaction_builder& add_action( const action_wrapper<Name, Action>& wrapper, Args&&... args ) {
+         static_assert(detail::type_check<Action, Args...>());
+         return append_action( wrapper.code_name, wrapper.action_name, wrapper.permissions.data(), wrapper.permissions.size(),
+                               detail::deduced<Action>{std::forward<Args>(args)...} );
+      }
+
+      /**
+       * Add an action already built
+       */
+      transaction_builder& add_action( const action& a ) {
+         const size_t pos = _buffer.size();
+         _buffer.resize( pos + pack_size( a ) );
+         datastream<char*> ds( _buffer.data() + pos, _buffer.size() - pos );
+         ds << a;
+         ++_action_count;
+         return *this;
+      }
+
+      /**
+       * The number of actions added
+       */
+      size_t size()const { return _action_count; }
+
+      /**
+       *  Sends the transaction built as a deferred transaction
+       *
+       *  @param sender_id - ID of sender
+       *  @param payer - Account paying for RAM
+       *  @param replace_existing - Defaults to false, if this is `0`/false then if the provided sender_id is already in use by an in-flight transaction from this contract, which will be a failing assert. If `1` then transaction will atomically cancel/replace the inflight transaction
+       */
+      void send(const uint128_t& sender_id, name payer, bool replace_existing = false) {
+         const unsigned_int action_count = _action_count;
+         const size_t prefix_size = pack_size( static_cast<const transaction_header&>(*this) ) + pack_size( unsigned_int(0) ) + pack_size( action_count );
+         _buffer.push_back( 0 ); // no transaction extensions
+         char* begin = _buffer.data() + max_prefix_size - prefix_size;
+         datastream<char*> ds( begin, prefix_size );
+         ds << static_cast<const transaction_header&>(*this) << unsigned_int(0) << action_count;
+         internal_use_do_not_use::send_deferred(sender_id, payer.value, begin, _buffer.data() + _buffer.size() - begin, replace_existing);
+         _buffer.pop_back();
+      }
+
+   private:
+      // The largest header (expiration, ref_block_num, ref_block_prefix, max_net_usage_words,
+      // max_cpu_usage_ms, delay_sec), no context free actions and the number of actions
+      static constexpr size_t max_prefix_size = 4 + 2 + 4 + 5 + 1 + 5 + 1 + 5;
+
+      template<typename... Args>
+      transaction_builder& append_action( name account, name act, const permission_level* auths, size_t auth_count, const Args&... args ) {
+         const unsigned_int data_size = (pack_size( args ) + ... + 0);
+         const size_t size = pack_size( account ) + pack_size( act ) + pack_size( unsigned_int(auth_count) ) + auth_count * pack_size( permission_level{} )
+                           + pack_size( data_size ) + data_size.value;
+         const size_t pos = _buffer.size();
+         _buffer.resize( pos + size );
+         datastream<char*> ds( _buffer.data() + pos, size );
+         ds << account << act << unsigned_int(auth_count);
+         for( size_t i = 0; i < auth_count; ++i )
+            ds << auths[i];
+         ds << data_size;
+         (ds << ... << args);
+         ++_action_count;
+         return *this;
+      }
+
+      std::vector<char> _buffer;
+      uint32_t          _action_count = 0;
+   };
+
    /**
     *  Struct onerror contains and sender id and packed transaction
     *
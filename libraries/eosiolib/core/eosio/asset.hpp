@@ -3,15 +3,28 @@
 #include "serialize.hpp"
 #include "print.hpp"
 #include "check.hpp"
+#include "powers.hpp"
 #include "symbol.hpp"
 
+#include <algorithm>
 #include <tuple>
 #include <limits>
+#include <string_view>
 
 namespace eosio {
 
    char* write_decimal( char* begin, char* end, bool dry_run, uint64_t number, uint8_t num_decimal_places, bool negative );
 
+   /**
+    *  The number of characters write_decimal writes for the same arguments
+    */
+   inline uint16_t decimal_length( uint64_t number, uint8_t num_decimal_places, bool negative ) {
+      const auto& powers_of_ten = powers_of_base<10, uint64_t>;
+      const uint16_t num_digits = std::upper_bound( powers_of_ten.begin(), powers_of_ten.end(), number ) - powers_of_ten.begin();
+      // at least one digit before the decimal point
+      return std::max<uint16_t>( num_digits, num_decimal_places + 1 ) + (num_decimal_places > 0) + negative;
+   }
+
    /**
     *  @defgroup asset Asset
     *  @ingroup core
@@ -39,7 +52,7 @@ namespace eosio {
        */
       static constexpr int64_t max_amount    = (1LL << 62) - 1;
 
-      asset() {}
+      constexpr asset() {}
 
       /**
        * Construct a new asset given the symbol name and the amount
@@ -47,11 +60,11 @@ namespace eosio {
        * @param a - The amount of the asset
        * @param s - The name of the symbol
        */
-      asset( int64_t a, class symbol s )
+      constexpr asset( int64_t a, class symbol s )
       :amount(a),symbol{s}
       {
-         eosio::check( is_amount_within_range(), "magnitude of asset amount must be less than 2^62" );
-         eosio::check( symbol.is_valid(),        "invalid symbol name" );
+         if( !is_amount_within_range() ) eosio::check( false, "magnitude of asset amount must be less than 2^62" );
+         if( !symbol.is_valid() )        eosio::check( false, "invalid symbol name" );
       }
 
       /**
@@ -60,7 +73,7 @@ namespace eosio {
        * @return true - if the amount doesn't exceed the max amount
        * @return false - otherwise
        */
-      bool is_amount_within_range()const { return -max_amount <= amount && amount <= max_amount; }
+      constexpr bool is_amount_within_range()const { return -max_amount <= amount && amount <= max_amount; }
 
       /**
        * Check if the asset is valid. %A valid asset has its amount <= max_amount and its symbol name valid
@@ -68,7 +81,7 @@ namespace eosio {
        * @return true - if the asset is valid
        * @return false - otherwise
        */
-      bool is_valid()const               { return is_amount_within_range() && symbol.is_valid(); }
+      constexpr bool is_valid()const     { return is_amount_within_range() && symbol.is_valid(); }
 
       /**
        * Set the amount of the asset
@@ -337,17 +350,26 @@ namespace eosio {
          uint64_t abs_amount = static_cast<uint64_t>(negative ? -amount : amount);
          // 0 <= abs_amount <= std::numeric_limits<int64_t>::max() < 10^19 < std::numeric_limits<uint64_t>::max()
 
-         uint8_t precision = symbol.precision();
+         const uint8_t precision = symbol.precision();
+         char* end_of_number = begin + decimal_length( abs_amount, precision, negative );
+         char* actual_end = symbol.code().write_as_string( end_of_number + 1, end, true );
+         if( dry_run || (actual_end < begin) || (actual_end > end) ) return actual_end;
 
-         int sufficient_size = std::max(static_cast<int>(precision), 19) + 11;
-         if( dry_run || (begin + sufficient_size < begin) || (begin + sufficient_size > end) ) {
-            char* start_of_symbol = write_decimal( begin, end, true, abs_amount, precision, negative ) + 1;
-            char* actual_end = symbol.code().write_as_string( start_of_symbol, end, true );
-            if( dry_run || (actual_end < begin) || (actual_end > end) ) return actual_end;
+         // the length is known: write the digits from the last one, in a single pass
+         char* pos = end_of_number;
+         for( uint8_t i = 0; i < precision; ++i ) {
+            *--pos = '0' + abs_amount % 10;
+            abs_amount /= 10;
          }
-
-         char* end_of_number = write_decimal( begin, end, false, abs_amount, precision, negative );
-         *(end_of_number) = ' ';
+         if( precision > 0 )
+            *--pos = '.';
+         do {
+            *--pos = '0' + abs_amount % 10;
+            abs_amount /= 10;
+         } while( pos > begin + negative );
+         if( negative )
+            *--pos = '-';
+         *end_of_number = ' ';
 
          return symbol.code().write_as_string( end_of_number + 1, end );
       }
@@ -495,4 +517,55 @@ namespace eosio {
 
       EOSLIB_SERIALIZE( extended_asset, (quantity)(contract) )
    };
+
+   namespace detail {
+      /**
+       * Parses an asset of the form "-1.0000 EOS", its precision being the number of decimal places
+       */
+      constexpr asset parse_asset( std::string_view str ) {
+         const auto space = str.find( ' ' );
+         if( space == std::string_view::npos )
+            eosio::check( false, "asset must be an amount and a symbol code separated by a space" );
+         const bool negative = str[0] == '-';
+         const auto number = str.substr( negative, space - negative );
+         const auto dot = number.find( '.' );
+         if( number.empty() || dot == 0 || dot + 1 == number.size() )
+            eosio::check( false, "amount of asset must be a decimal number" );
+
+         int64_t amount = 0;
+         for( size_t i = 0; i < number.size(); ++i ) {
+            if( i == dot )
+               continue;
+            const char c = number[i];
+            if( static_cast<uint8_t>(c - '0') > 9 )
+               eosio::check( false, "amount of asset must be a decimal number" );
+            if( amount > (asset::max_amount - (c - '0')) / 10 )
+               eosio::check( false, "magnitude of asset amount must be less than 2^62" );
+            amount = amount * 10 + (c - '0');
+         }
+         const size_t precision = dot == std::string_view::npos ? 0 : number.size() - dot - 1;
+         if( precision > 18 )
+            eosio::check( false, "precision of symbol must be at most 18" );
+         return asset{ negative ? -amount : amount, symbol{ symbol_code{ str.substr( space + 1 ) }, static_cast<uint8_t>(precision) } };
+      }
+   } /// namespace detail
 }
+
+/// @cond IMPLEMENTATIONS
+
+/**
+ * %asset literal operator
+ *
+ * @ingroup asset
+ * @brief "1.0000 EOS"_a is a shortcut for asset(10000, symbol("EOS", 4)), validated at compile time
+ */
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wgnu-string-literal-operator-template"
+template <typename T, T... Str>
+inline constexpr eosio::asset operator""_a() {
+   constexpr auto x = eosio::detail::parse_asset(std::string_view{eosio::detail::to_const_char_arr<Str...>::value, sizeof...(Str)});
+   return x;
+}
+#pragma clang diagnostic pop
+
+/// @endcond
@@ -6,6 +6,7 @@
 
 #include <alloca.h>
 #include <string>
+#include <type_traits>
 
 namespace eosio {
 
@@ -110,6 +111,30 @@ namespace eosio {
       }
    }
 
+   /**
+    *  Assert if the predicate fails and use the message produced by the supplied callable.
+    *  The callable is only invoked when the predicate fails, so building the message costs nothing on success.
+    *
+    *  @ingroup system
+    *  @param pred - The predicate
+    *  @param make_msg - Callable returning either a null terminated `const char*` or an object providing `data()` and `size()` (e.g. `std::string`)
+    *
+    *  Example:
+    *  @code
+    *  eosio::check(a == b, [&]() { return "a does not equal " + std::to_string(b); });
+    *  @endcode
+    */
+   template<typename F, std::enable_if_t<std::is_invocable<F&>::value, int> = 0>
+   inline void check(bool pred, F&& make_msg) {
+      if (!pred) {
+         const auto& msg = make_msg();
+         if constexpr (std::is_convertible<decltype(msg), const char*>::value)
+            internal_use_do_not_use::eosio_assert(false, msg);
+         else
+            internal_use_do_not_use::eosio_assert_message(false, msg.data(), msg.size());
+      }
+   }
+
     /**
     *  Assert if the predicate fails and use the supplied error code.
     *
@@ -0,0 +1,152 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+
+#include "fixed_bytes.hpp"
+#include "name.hpp"
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <utility>
+
+namespace eosio {
+
+   /**
+    *  @defgroup composite_key Composite Key
+    *  @ingroup core
+    *  @brief Builds 256-bit secondary keys out of several values
+    *
+    *  @details A composite key packs names and integers, most significant first, into a
+    *  checksum256 whose order is the order of its parts: by the first part, then by the second
+    *  and so on. The key is built at compile time for constant parts and with a copy otherwise,
+    *  and the secondary index idx256 sorts it as the tuple of its parts. A key of the leading
+    *  parts only bounds every key starting with them.
+    *
+    *  Unsigned integers are stored as they are, signed integers with their sign bit flipped so
+    *  that negative values sort first, and names as their 64-bit value.
+    *
+    *  **Example:**
+    *  ```
+    *     // offers indexed by (market, owner, id)
+    *     checksum256 by_market_owner()const { return make_composite_key( market, owner, id ); }
+    *
+    *     // every offer of owner in market
+    *     auto idx = offers.get_index<"bymarketown"_n>();
+    *     auto [first, last] = composite_key_range( idx, market, owner );
+    *     for( auto itr = first; itr != last; ++itr ) ...
+    *  ```
+    */
+
+   /// @cond IMPLEMENTATIONS
+
+   namespace detail {
+      template<typename T>
+      constexpr size_t composite_key_part_size() {
+         if constexpr( std::is_same_v<T, name> ) {
+            return sizeof(uint64_t);
+         } else {
+            static_assert( std::is_integral_v<T> && !std::is_same_v<T, bool>, "composite key parts must be names or integers" );
+            return sizeof(T);
+         }
+      }
+
+      using composite_key_words = std::array<checksum256::word_t, checksum256::num_words()>;
+
+      constexpr size_t composite_key_word_size = sizeof(checksum256::word_t);
+
+      // Writes the part at byte pos of the big-endian words of the key, split over two words if it straddles them
+      template<typename T>
+      constexpr void write_composite_key_part( composite_key_words& key, size_t& pos, T part ) {
+         if constexpr( std::is_same_v<T, name> ) {
+            write_composite_key_part( key, pos, part.value );
+         } else {
+            using U = std::make_unsigned_t<T>;
+            U value = static_cast<U>(part);
+            if constexpr( std::is_signed_v<T> )
+               value ^= U(1) << (8 * sizeof(T) - 1);
+
+            const size_t word  = pos / composite_key_word_size;
+            const size_t avail = composite_key_word_size - pos % composite_key_word_size;
+            if( sizeof(T) <= avail ) {
+               key[word] |= static_cast<checksum256::word_t>(value) << (8 * (avail - sizeof(T)));
+            } else {
+               const size_t rest = sizeof(T) - avail;
+               key[word]     |= static_cast<checksum256::word_t>(value >> (8 * rest));
+               key[word + 1] |= static_cast<checksum256::word_t>(value) << (8 * (composite_key_word_size - rest));
+            }
+            pos += sizeof(T);
+         }
+      }
+
+      template<typename... Parts>
+      constexpr checksum256 build_composite_key( uint8_t fill, Parts... parts ) {
+         static_assert( (composite_key_part_size<Parts>() + ... + 0) <= 32, "composite key parts exceed 32 bytes" );
+         composite_key_words key{};
+         size_t pos = 0;
+         (write_composite_key_part( key, pos, parts ), ...);
+
+         // the fill byte repeated over a word, masked to the bytes following the parts
+         const checksum256::word_t fill_word = ~checksum256::word_t{0} / 0xff * fill;
+         for( size_t word = pos / composite_key_word_size; word < key.size(); ++word ) {
+            const size_t avail = (word + 1) * composite_key_word_size - std::max( pos, word * composite_key_word_size );
+            if( avail == composite_key_word_size )
+               key[word] |= fill_word;
+            else
+               key[word] |= fill_word & ((checksum256::word_t{1} << (8 * avail)) - 1);
+         }
+         return checksum256( key );
+      }
+   }
+
+   /// @endcond
+
+   /**
+    *  The composite key of the given parts, followed by zeros
+    *
+    *  @ingroup composite_key
+    *  @param parts - Names and integers of at most 32 bytes in total
+    */
+   template<typename... Parts>
+   constexpr checksum256 make_composite_key( Parts... parts ) {
+      return detail::build_composite_key( 0x00, parts... );
+   }
+
+   /**
+    *  The lowest composite key starting with the given parts
+    *
+    *  @ingroup composite_key
+    *  @param prefix - The leading parts of the key
+    */
+   template<typename... Parts>
+   constexpr checksum256 composite_key_lower_bound( Parts... prefix ) {
+      return detail::build_composite_key( 0x00, prefix... );
+   }
+
+   /**
+    *  The highest composite key starting with the given parts
+    *
+    *  @ingroup composite_key
+    *  @param prefix - The leading parts of the key
+    */
+   template<typename... Parts>
+   constexpr checksum256 composite_key_upper_bound( Parts... prefix ) {
+      return detail::build_composite_key( 0xff, prefix... );
+   }
+
+   /**
+    *  The range of an idx256 secondary index over the keys starting with the given parts
+    *
+    *  @ingroup composite_key
+    *  @param idx - The secondary index, from multi_index::get_index
+    *  @param prefix - The leading parts of the keys
+    *  @return The first entry whose key starts with prefix, and the entry past the last one
+    */
+   template<typename Index, typename... Parts>
+   auto composite_key_range( const Index& idx, Parts... prefix ) {
+      return std::make_pair( idx.lower_bound( composite_key_lower_bound( prefix... ) ),
+                             idx.upper_bound( composite_key_upper_bound( prefix... ) ) );
+   }
+}
@@ -244,6 +244,17 @@ namespace eosio {
     */
    void assert_sha256( const char* data, uint32_t length, const eosio::checksum256& hash );
 
+   /**
+    *  Tests if the SHA256 hash generated from data matches the provided digest, handed to the host without a copy.
+    *
+    *  @ingroup crypto
+    *  @param data - Data you want to hash
+    *  @param length - Data length
+    *  @param hash - digest to compare to
+    *  @note This method is optimized to a NO-OP when in fast evaluation mode.
+    */
+   void assert_sha256( const char* data, uint32_t length, const eosio::byte_checksum256& hash );
+
    /**
     *  Tests if the SHA1 hash generated from data matches the provided digest.
     *
@@ -255,6 +266,17 @@ namespace eosio {
     */
    void assert_sha1( const char* data, uint32_t length, const eosio::checksum160& hash );
 
+   /**
+    *  Tests if the SHA1 hash generated from data matches the provided digest, handed to the host without a copy.
+    *
+    *  @ingroup crypto
+    *  @param data - Data you want to hash
+    *  @param length - Data length
+    *  @param hash - digest to compare to
+    *  @note This method is optimized to a NO-OP when in fast evaluation mode.
+    */
+   void assert_sha1( const char* data, uint32_t length, const eosio::byte_checksum160& hash );
+
    /**
     *  Tests if the SHA512 hash generated from data matches the provided digest.
     *
@@ -266,6 +288,17 @@ namespace eosio {
     */
    void assert_sha512( const char* data, uint32_t length, const eosio::checksum512& hash );
 
+   /**
+    *  Tests if the SHA512 hash generated from data matches the provided digest, handed to the host without a copy.
+    *
+    *  @ingroup crypto
+    *  @param data - Data you want to hash
+    *  @param length - Data length
+    *  @param hash - digest to compare to
+    *  @note This method is optimized to a NO-OP when in fast evaluation mode.
+    */
+   void assert_sha512( const char* data, uint32_t length, const eosio::byte_checksum512& hash );
+
    /**
     *  Tests if the RIPEMD160 hash generated from data matches the provided digest.
     *
@@ -276,6 +309,16 @@ namespace eosio {
     */
    void assert_ripemd160( const char* data, uint32_t length, const eosio::checksum160& hash );
 
+   /**
+    *  Tests if the RIPEMD160 hash generated from data matches the provided digest, handed to the host without a copy.
+    *
+    *  @ingroup crypto
+    *  @param data - Data you want to hash
+    *  @param length - Data length
+    *  @param hash - digest to compare to
+    */
+   void assert_ripemd160( const char* data, uint32_t length, const eosio::byte_checksum160& hash );
+
    /**
     *  Hashes `data` using SHA256.
     *
@@ -286,6 +329,16 @@ namespace eosio {
     */
    eosio::checksum256 sha256( const char* data, uint32_t length );
 
+   /**
+    *  Hashes `data` using SHA256, the host writing the digest straight into the returned bytes.
+    *
+    *  @ingroup crypto
+    *  @param data - Data you want to hash
+    *  @param length - Data length
+    *  @return eosio::byte_checksum256 - Computed digest
+    */
+   eosio::byte_checksum256 sha256_bytes( const char* data, uint32_t length );
+
    /**
     *  Hashes `data` using SHA1.
     *
@@ -297,6 +350,16 @@ namespace eosio {
     */
    eosio::checksum160 sha1( const char* data, uint32_t length );
 
+   /**
+    *  Hashes `data` using SHA1, the host writing the digest straight into the returned bytes.
+    *
+    *  @ingroup crypto
+    *  @param data - Data you want to hash
+    *  @param length - Data length
+    *  @return eosio::byte_checksum160 - Computed digest
+    */
+   eosio::byte_checksum160 sha1_bytes( const char* data, uint32_t length );
+
    /**
     *  Hashes `data` using SHA512.
     *
@@ -307,6 +370,16 @@ namespace eosio {
     */
    eosio::checksum512 sha512( const char* data, uint32_t length );
 
+   /**
+    *  Hashes `data` using SHA512, the host writing the digest straight into the returned bytes.
+    *
+    *  @ingroup crypto
+    *  @param data - Data you want to hash
+    *  @param length - Data length
+    *  @return eosio::byte_checksum512 - Computed digest
+    */
+   eosio::byte_checksum512 sha512_bytes( const char* data, uint32_t length );
+
    /**
     *  Hashes `data` using RIPEMD160.
     *
@@ -317,6 +390,16 @@ namespace eosio {
     */
    eosio::checksum160 ripemd160( const char* data, uint32_t length );
 
+   /**
+    *  Hashes `data` using RIPEMD160, the host writing the digest straight into the returned bytes.
+    *
+    *  @ingroup crypto
+    *  @param data - Data you want to hash
+    *  @param length - Data length
+    *  @return eosio::byte_checksum160 - Computed digest
+    */
+   eosio::byte_checksum160 ripemd160_bytes( const char* data, uint32_t length );
+
    /**
     *  Calculates the public key used for a given signature on a given digest.
     *
@@ -327,6 +410,16 @@ namespace eosio {
     */
    eosio::public_key recover_key( const eosio::checksum256& digest, const eosio::signature& sig );
 
+   /**
+    *  Calculates the public key used for a given signature on a given digest, handed to the host without a copy.
+    *
+    *  @ingroup crypto
+    *  @param digest - Digest of the message that was signed
+    *  @param sig - Signature
+    *  @return eosio::public_key - Recovered public key
+    */
+   eosio::public_key recover_key( const eosio::byte_checksum256& digest, const eosio::signature& sig );
+
    /**
     *  Tests a given public key with the recovered public key from digest and signature.
     *
@@ -336,4 +429,39 @@ namespace eosio {
     *  @param pubkey - Public key
     */
    void assert_recover_key( const eosio::checksum256& digest, const eosio::signature& sig, const eosio::public_key& pubkey );
+
+   /**
+    *  Tests a given public key with the recovered public key from digest and signature, the digest
+    *  handed to the host without a copy.
+    *
+    *  @ingroup crypto
+    *  @param digest - Digest of the message that was signed
+    *  @param sig - Signature
+    *  @param pubkey - Public key
+    */
+   void assert_recover_key( const eosio::byte_checksum256& digest, const eosio::signature& sig, const eosio::public_key& pubkey );
+
+   /**
+    *  Calculates the public keys used for a batch of signatures on their digests.
+    *  Signatures are serialized into a single scratch area that is reused for every pair.
+    *
+    *  @ingroup crypto
+    *  @param digests - Digests of the messages that were signed
+    *  @param sigs - Signatures, one per digest
+    *  @param pubkeys - Destination for the recovered public keys, one per digest
+    *  @param count - Number of (digest, signature) pairs
+    */
+   void recover_keys( const eosio::checksum256* digests, const eosio::signature* sigs, eosio::public_key* pubkeys, size_t count );
+
+   /**
+    *  Tests a batch of public keys against the keys recovered from their digests and signatures.
+    *  Signatures and public keys are serialized into scratch areas that are reused for every pair.
+    *
+    *  @ingroup crypto
+    *  @param digests - Digests of the messages that were signed
+    *  @param sigs - Signatures, one per digest
+    *  @param pubkeys - Public keys, one per digest
+    *  @param count - Number of (digest, signature, public key) triples
+    */
+   void assert_recover_keys( const eosio::checksum256* digests, const eosio::signature* sigs, const eosio::public_key* pubkeys, size_t count );
 }
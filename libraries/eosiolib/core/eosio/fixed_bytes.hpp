@@ -7,6 +7,7 @@
 
 #include <array>
 #include <algorithm>
+#include <cstring>
 #include <functional>
 #include <type_traits>
 
@@ -47,6 +48,9 @@ namespace eosio {
    /**
     *  Fixed size byte array sorted lexicographically
     *
+    *  The bytes are stored in 128-bit words, in big-endian order, as the secondary index idx256
+    *  stores them; byte_view() returns them in the order they are serialized.
+    *
     *  @ingroup fixed_bytes
     *  @tparam Size - Size of the fixed_bytes object
     */
@@ -59,9 +63,9 @@ namespace eosio {
          using all_true = std::is_same< bool_pack<bs..., true>, bool_pack<true, bs...> >;
 
          template<typename Word, size_t NumWords>
-         static void set_from_word_sequence(const Word* arr_begin, const Word* arr_end, fixed_bytes<Size>& key)
+         static constexpr void set_from_word_sequence(const Word* arr_begin, const Word* arr_end, fixed_bytes<Size>& key)
          {
-            auto itr = key._data.begin();
+            size_t itr = 0;
             word_t temp_word = 0;
             const size_t sub_word_shift = 8 * sizeof(Word);
             const size_t num_sub_words = sizeof(word_t) / sizeof(Word);
@@ -74,18 +78,20 @@ namespace eosio {
                    continue;
                }
 
-               eosio::check( sub_words_left == 1, "unexpected error in fixed_bytes constructor" );
+               if( sub_words_left != 1 )
+                  eosio::check( false, "unexpected error in fixed_bytes constructor" );
                temp_word |= static_cast<word_t>(*w_itr);
                sub_words_left = num_sub_words;
 
-               *itr = temp_word;
+               key._data[itr] = temp_word;
                temp_word = 0;
                ++itr;
             }
             if( sub_words_left != num_sub_words ) {
+               // a trailing partial word is left aligned, the padding following the words supplied
                if( sub_words_left > 1 )
-                  temp_word <<= 8 * (sub_words_left-1);
-               *itr = temp_word;
+                  temp_word <<= sub_word_shift * (sub_words_left-1);
+               key._data[itr] = temp_word;
             }
          }
 
@@ -115,10 +121,8 @@ namespace eosio {
          *
          * @param arr    data
          */
-         fixed_bytes(const std::array<word_t, num_words()>& arr)
-         {
-           std::copy(arr.begin(), arr.end(), _data.begin());
-         }
+         constexpr fixed_bytes(const std::array<word_t, num_words()>& arr) : _data(arr)
+         {}
 
          /**
          * Constructor to fixed_bytes object from std::array of Word types smaller in size than word_t
@@ -130,7 +134,7 @@ namespace eosio {
                                                              std::is_unsigned<Word>::value &&
                                                              !std::is_same<Word, bool>::value &&
                                                              std::less<size_t>{}(sizeof(Word), sizeof(word_t))>::type >
-         fixed_bytes(const std::array<Word, NumWords>& arr)
+         constexpr fixed_bytes(const std::array<Word, NumWords>& arr) : _data()
          {
             static_assert( sizeof(word_t) == (sizeof(word_t)/sizeof(Word)) * sizeof(Word),
                            "size of the backing word size is not divisible by the size of the array element" );
@@ -149,7 +153,7 @@ namespace eosio {
                                                              std::is_unsigned<Word>::value &&
                                                              !std::is_same<Word, bool>::value &&
                                                              std::less<size_t>{}(sizeof(Word), sizeof(word_t))>::type >
-         fixed_bytes(const Word(&arr)[NumWords])
+         constexpr fixed_bytes(const Word(&arr)[NumWords]) : _data()
          {
             static_assert( sizeof(word_t) == (sizeof(word_t)/sizeof(Word)) * sizeof(Word),
                            "size of the backing word size is not divisible by the size of the array element" );
@@ -192,6 +196,17 @@ namespace eosio {
           */
          const auto& get_array()const { return _data; }
 
+         /**
+          * Get the contained bytes in the order they are serialized, the bytes of the words padding
+          * the last one left out
+          */
+         constexpr std::array<uint8_t, Size> byte_view()const {
+            std::array<uint8_t, Size> arr{};
+            for( size_t i = 0; i < Size; ++i )
+               arr[i] = static_cast<uint8_t>(_data[i / sizeof(word_t)] >> (8 * (sizeof(word_t) - 1 - i % sizeof(word_t))));
+            return arr;
+         }
+
          /**
           * Get the underlying data of the contained std::array
           */
@@ -218,29 +233,7 @@ namespace eosio {
           * @return - the extracted data as array of bytes
           */
          std::array<uint8_t, Size> extract_as_byte_array()const {
-            std::array<uint8_t, Size> arr;
-
-            const size_t num_sub_words = sizeof(word_t);
-
-            auto arr_itr  = arr.begin();
-            auto data_itr = _data.begin();
-
-            for( size_t counter = _data.size(); counter > 0; --counter, ++data_itr ) {
-               size_t sub_words_left = num_sub_words;
-
-               auto temp_word = *data_itr;
-               if( counter == 1 ) { // If last word in _data array...
-                  sub_words_left -= padded_bytes();
-                  temp_word >>= 8*padded_bytes();
-               }
-               for( ; sub_words_left > 0; --sub_words_left ) {
-                  *(arr_itr + sub_words_left - 1) = static_cast<uint8_t>(temp_word & 0xFF);
-                  temp_word >>= 8;
-               }
-               arr_itr += num_sub_words;
-            }
-
-            return arr;
+            return byte_view();
          }
 
          /**
@@ -249,7 +242,7 @@ namespace eosio {
           * @param val to be printed
           */
          inline void print()const {
-            auto arr = extract_as_byte_array();
+            auto arr = byte_view();
             printhex(static_cast<const void*>(arr.data()), arr.size());
          }
 
@@ -353,6 +346,126 @@ namespace eosio {
    using checksum256 = fixed_bytes<32>;
    using checksum512 = fixed_bytes<64>;
 
+   /**
+    *  Fixed size digest stored as the bytes it is serialized and hashed as
+    *
+    *  Unlike fixed_bytes, which keeps the big-endian 128-bit words the secondary index idx256 works on,
+    *  byte_checksum keeps the bytes themselves: it is filled by the hash intrinsics in place, views and
+    *  serializes its bytes without a copy and compares them with memcmp. The order is the same as the
+    *  one of the fixed_bytes of the same size; the bytes are packed into words only when needed, by
+    *  to_fixed_bytes() or at the idx256 database calls of multi_index.
+    *
+    *  @ingroup fixed_bytes
+    *  @tparam Size - Size of the byte_checksum object
+    */
+   template<size_t Size>
+   class byte_checksum {
+      public:
+
+         /**
+         * Default constructor to byte_checksum object which initializes all bytes to zero
+         */
+         constexpr byte_checksum() : _data() {}
+
+         /**
+         * Constructor to byte_checksum object from the bytes of a digest, such as the hash of a capi_checksum
+         *
+         * @param bytes - Source data
+         */
+         explicit byte_checksum(const uint8_t(&bytes)[Size]) {
+            memcpy( _data.data(), bytes, Size );
+         }
+
+         /**
+         * Constructor to byte_checksum object from std::array of bytes
+         *
+         * @param bytes - Source data
+         */
+         constexpr explicit byte_checksum(const std::array<uint8_t, Size>& bytes) : _data(bytes) {}
+
+         /**
+         * Constructor to byte_checksum object from the fixed_bytes of the same size
+         *
+         * @param fb - Source data
+         */
+         constexpr explicit byte_checksum(const fixed_bytes<Size>& fb) : _data(fb.byte_view()) {}
+
+         /**
+          * Get the contained bytes, without a copy
+          */
+         const std::array<uint8_t, Size>& byte_view()const { return _data; }
+
+         /**
+          * Get the contained bytes
+          */
+         uint8_t* data() { return _data.data(); }
+
+         /// @cond INTERNAL
+
+         /**
+          * Get the contained bytes
+          */
+         const uint8_t* data()const { return _data.data(); }
+
+         /// @endcond
+
+         /**
+          * Get the number of contained bytes
+          */
+         static constexpr size_t size() { return Size; }
+
+         /**
+          * Pack the contained bytes into the words of a fixed_bytes
+          *
+          * @return - the fixed_bytes holding the same bytes
+          */
+         constexpr fixed_bytes<Size> to_fixed_bytes()const { return fixed_bytes<Size>( _data ); }
+
+         /**
+          * Prints byte_checksum as a hexidecimal string
+          */
+         inline void print()const {
+            printhex(static_cast<const void*>(_data.data()), Size);
+         }
+
+         /// @cond OPERATORS
+
+         friend bool operator ==(const byte_checksum& c1, const byte_checksum& c2) {
+            return memcmp( c1._data.data(), c2._data.data(), Size ) == 0;
+         }
+
+         friend bool operator !=(const byte_checksum& c1, const byte_checksum& c2) {
+            return memcmp( c1._data.data(), c2._data.data(), Size ) != 0;
+         }
+
+         friend bool operator >(const byte_checksum& c1, const byte_checksum& c2) {
+            return memcmp( c1._data.data(), c2._data.data(), Size ) > 0;
+         }
+
+         friend bool operator <(const byte_checksum& c1, const byte_checksum& c2) {
+            return memcmp( c1._data.data(), c2._data.data(), Size ) < 0;
+         }
+
+         friend bool operator >=(const byte_checksum& c1, const byte_checksum& c2) {
+            return memcmp( c1._data.data(), c2._data.data(), Size ) >= 0;
+         }
+
+         friend bool operator <=(const byte_checksum& c1, const byte_checksum& c2) {
+            return memcmp( c1._data.data(), c2._data.data(), Size ) <= 0;
+         }
+
+         /// @endcond
+
+      private:
+
+         // aligned as the capi_checksum structures, so that the hash intrinsics can write into it
+         alignas(16) std::array<uint8_t, Size> _data;
+   };
+
+   using byte_checksum160 = byte_checksum<20>;
+   using byte_checksum256 = byte_checksum<32>;
+   using byte_checksum512 = byte_checksum<64>;
+
    /**
     *  Serialize a fixed_bytes into a stream
     *
@@ -364,7 +477,7 @@ namespace eosio {
     */
    template<typename DataStream, size_t Size>
    inline DataStream& operator<<(DataStream& ds, const fixed_bytes<Size>& d) {
-      auto arr = d.extract_as_byte_array();
+      auto arr = d.byte_view();
       ds.write( (const char*)arr.data(), arr.size() );
       return ds;
    }
@@ -386,5 +499,35 @@ namespace eosio {
       return ds;
    }
 
+   /**
+    *  Serialize a byte_checksum into a stream
+    *
+    *  @brief Serialize a byte_checksum
+    *  @param ds - The stream to write
+    *  @param d - The value to serialize
+    *  @tparam DataStream - Type of datastream buffer
+    *  @return DataStream& - Reference to the datastream
+    */
+   template<typename DataStream, size_t Size>
+   inline DataStream& operator<<(DataStream& ds, const byte_checksum<Size>& d) {
+      ds.write( (const char*)d.data(), d.size() );
+      return ds;
+   }
+
+   /**
+    *  Deserialize a byte_checksum from a stream
+    *
+    *  @brief Deserialize a byte_checksum
+    *  @param ds - The stream to read
+    *  @param d - The destination for deserialized value
+    *  @tparam DataStream - Type of datastream buffer
+    *  @return DataStream& - Reference to the datastream
+    */
+   template<typename DataStream, size_t Size>
+   inline DataStream& operator>>(DataStream& ds, byte_checksum<Size>& d) {
+      ds.read( (char*)d.data(), d.size() );
+      return ds;
+   }
+
    /// @endcond
 }
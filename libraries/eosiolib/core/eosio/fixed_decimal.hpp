@@ -0,0 +1,256 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+
+#include "asset.hpp"
+#include "check.hpp"
+#include "numeric.hpp"
+#include "print.hpp"
+#include "serialize.hpp"
+
+#include <limits>
+#include <string>
+
+namespace eosio {
+
+   /**
+    *  @defgroup fixed_decimal Fixed Decimal
+    *  @ingroup core
+    *  @brief Decimal fixed point numbers over 128-bit integers
+    *
+    *  @details fixed_decimal<Precision> holds a number as an int128_t count of 10^-Precision, as
+    *  an asset holds its amount, and replaces `double` and `long double` (softfloat in wasm) in
+    *  fractional math. Addition and subtraction are exact; multiplication and division round
+    *  the exact result to the nearest representable number, halves away from zero, or as
+    *  requested with mul and div. Every operation is constexpr and checked for overflow. A
+    *  fixed_decimal serializes as its raw int128 value, which is also its ABI type.
+    *
+    *  **Example:**
+    *  ```
+    *     // price of the pool, then the tokens out for quantity in
+    *     auto price = fixed_decimal<8>::from_fraction( pool_out.amount, pool_in.amount );
+    *     asset out = (price * fixed_decimal<8>::from_asset( quantity )).to_asset( pool_out.symbol, rounding::down );
+    *  ```
+    */
+
+   /**
+    *  Decimal fixed point number with Precision decimal places
+    *
+    *  @ingroup fixed_decimal
+    *  @tparam Precision - The number of decimal places, at most 18
+    */
+   template<uint8_t Precision>
+   class fixed_decimal {
+      static_assert( Precision <= 18, "fixed_decimal supports up to 18 decimal places" );
+
+      public:
+         /**
+          * The number of decimal places
+          */
+         static constexpr uint8_t precision = Precision;
+
+         /**
+          * 10^Precision, the raw value of 1
+          */
+         static constexpr int64_t scale = ipow( int64_t{10}, Precision );
+
+         /**
+          * Construct a new fixed_decimal of value 0
+          */
+         constexpr fixed_decimal() = default;
+
+         /**
+          * Construct a new fixed_decimal from an integer
+          *
+          * @param integer - The value
+          */
+         template<typename T, typename = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= 8>>
+         constexpr fixed_decimal( T integer )
+         : _value( detail::checked_multiply( int128_t(integer), int128_t(scale) ) ) {}
+
+         /**
+          * The fixed_decimal of the given raw value, a count of 10^-Precision
+          */
+         static constexpr fixed_decimal from_raw( int128_t raw ) {
+            fixed_decimal result;
+            result._value = raw;
+            return result;
+         }
+
+         /**
+          * The fixed_decimal nearest to numerator / denominator, or rounded as requested
+          */
+         static constexpr fixed_decimal from_fraction( int128_t numerator, int128_t denominator, rounding mode = rounding::nearest ) {
+            return from_raw( muldiv( numerator, int128_t(scale), denominator, mode ) );
+         }
+
+         /**
+          * The amount of an asset, rounded as requested if its symbol has more decimal places
+          */
+         static constexpr fixed_decimal from_asset( const asset& a, rounding mode = rounding::nearest ) {
+            return from_scaled( a.amount, a.symbol.precision(), mode );
+         }
+
+         /**
+          * The raw value, a count of 10^-Precision
+          */
+         constexpr int128_t raw()const { return _value; }
+
+         /**
+          * The integer nearest to the value, or rounded as requested
+          */
+         constexpr int128_t to_integer( rounding mode = rounding::nearest )const {
+            return muldiv( _value, int128_t(1), int128_t(scale), mode );
+         }
+
+         /**
+          * The value as an amount of the given symbol, rounded as requested if the symbol has
+          * fewer decimal places
+          */
+         asset to_asset( const symbol& sym, rounding mode = rounding::nearest )const {
+            const int128_t amount = rescale_raw( sym.precision(), mode );
+            detail::check_numeric( amount <= asset::max_amount && amount >= -asset::max_amount, "magnitude of asset amount must be less than 2^62" );
+            return asset( int64_t(amount), sym );
+         }
+
+         /**
+          * The value with P decimal places, rounded as requested if P < Precision
+          */
+         template<uint8_t P>
+         constexpr fixed_decimal<P> rescale( rounding mode = rounding::nearest )const {
+            return fixed_decimal<P>::from_raw( rescale_raw( P, mode ) );
+         }
+
+         /**
+          * The product, rounded as requested
+          */
+         constexpr fixed_decimal mul( const fixed_decimal& b, rounding mode )const {
+            return from_raw( muldiv( _value, b._value, int128_t(scale), mode ) );
+         }
+
+         /**
+          * The quotient, rounded as requested
+          */
+         constexpr fixed_decimal div( const fixed_decimal& b, rounding mode )const {
+            return from_raw( muldiv( _value, int128_t(scale), b._value, mode ) );
+         }
+
+         constexpr fixed_decimal operator-()const {
+            detail::check_numeric( _value != std::numeric_limits<int128_t>::min(), "negation overflow" );
+            return from_raw( -_value );
+         }
+
+         constexpr fixed_decimal& operator+=( const fixed_decimal& b ) {
+            constexpr int128_t max = std::numeric_limits<int128_t>::max(), min = std::numeric_limits<int128_t>::min();
+            detail::check_numeric( b._value >= 0 ? _value <= max - b._value : _value >= min - b._value, "addition overflow" );
+            _value += b._value;
+            return *this;
+         }
+
+         constexpr fixed_decimal& operator-=( const fixed_decimal& b ) {
+            constexpr int128_t max = std::numeric_limits<int128_t>::max(), min = std::numeric_limits<int128_t>::min();
+            detail::check_numeric( b._value >= 0 ? _value >= min + b._value : _value <= max + b._value, "subtraction overflow" );
+            _value -= b._value;
+            return *this;
+         }
+
+         constexpr fixed_decimal& operator*=( const fixed_decimal& b ) { return *this = mul( b, rounding::nearest ); }
+         constexpr fixed_decimal& operator/=( const fixed_decimal& b ) { return *this = div( b, rounding::nearest ); }
+
+         friend constexpr fixed_decimal operator+( fixed_decimal a, const fixed_decimal& b ) { return a += b; }
+         friend constexpr fixed_decimal operator-( fixed_decimal a, const fixed_decimal& b ) { return a -= b; }
+         friend constexpr fixed_decimal operator*( const fixed_decimal& a, const fixed_decimal& b ) { return a.mul( b, rounding::nearest ); }
+         friend constexpr fixed_decimal operator/( const fixed_decimal& a, const fixed_decimal& b ) { return a.div( b, rounding::nearest ); }
+
+         friend constexpr bool operator==( const fixed_decimal& a, const fixed_decimal& b ) { return a._value == b._value; }
+         friend constexpr bool operator!=( const fixed_decimal& a, const fixed_decimal& b ) { return a._value != b._value; }
+         friend constexpr bool operator<( const fixed_decimal& a, const fixed_decimal& b ) { return a._value < b._value; }
+         friend constexpr bool operator<=( const fixed_decimal& a, const fixed_decimal& b ) { return a._value <= b._value; }
+         friend constexpr bool operator>( const fixed_decimal& a, const fixed_decimal& b ) { return a._value > b._value; }
+         friend constexpr bool operator>=( const fixed_decimal& a, const fixed_decimal& b ) { return a._value >= b._value; }
+
+         /**
+          * Writes the number as a string to the provided char buffer, with all its decimal places
+          *
+          * @pre The range [begin, end) must be a valid range of memory to write to.
+          * @param begin - The start of the char buffer
+          * @param end - Just past the end of the char buffer
+          * @param dry_run - If true, do not actually write anything into the range.
+          * @return char* - Just past the end of the last character that would be written assuming dry_run == false and end was large enough to provide sufficient space. (Meaning only applies if returned pointer >= begin.)
+          */
+         char* write_as_string( char* begin, char* end, bool dry_run = false )const {
+            const bool negative = _value < 0;
+            const uint128_t magnitude = detail::magnitude( _value );
+            if( (magnitude >> 64) == 0 )
+               return write_decimal( begin, end, dry_run, uint64_t(magnitude), Precision, negative );
+
+            // at most 2^127: the digits above the 19 lowest fit in 64 bits, and the decimal
+            // point falls within the lowest
+            constexpr uint64_t ten_pow_19 = 10000000000000000000ull;
+            detail::words<2> high, low;
+            detail::divide( detail::to_words( magnitude ), detail::to_words( ten_pow_19 ), high, low );
+            char* end_of_high = write_decimal( begin, end, true, high.w[0], 0, negative );
+            char* actual_end = end_of_high + 19 + (Precision > 0);
+            if( dry_run || (actual_end < begin) || (actual_end > end) ) return actual_end;
+
+            write_decimal( begin, end, false, high.w[0], 0, negative );
+            uint64_t digits = low.w[0];
+            char* pos = actual_end;
+            for( uint8_t i = 0; i < 19; ++i ) {
+               if( i == Precision && Precision > 0 )
+                  *--pos = '.';
+               *--pos = char('0' + digits % 10);
+               digits /= 10;
+            }
+            return actual_end;
+         }
+
+         /**
+          * The number as a string, with all its decimal places
+          */
+         std::string to_string()const {
+            char buffer[buffer_size];
+            char* end = write_as_string( buffer, buffer + buffer_size );
+            check( end <= buffer + buffer_size, "insufficient space in buffer" ); // should never fail
+            return {buffer, end};
+         }
+
+         /**
+          * %Print the number, with all its decimal places
+          */
+         void print()const {
+            char buffer[buffer_size];
+            char* end = write_as_string( buffer, buffer + buffer_size );
+            check( end <= buffer + buffer_size, "insufficient space in buffer" ); // should never fail
+            if( buffer < end )
+               printl( buffer, (end-buffer) );
+         }
+
+         EOSLIB_SERIALIZE( fixed_decimal, (_value) )
+
+      private:
+         template<uint8_t P>
+         friend class fixed_decimal;
+
+         // sign, 39 digits and the decimal point
+         static constexpr int buffer_size = 41;
+
+         static constexpr fixed_decimal from_scaled( int128_t value, uint8_t decimals, rounding mode ) {
+            if( decimals <= Precision )
+               return from_raw( detail::checked_multiply( value, int128_t(ipow( int64_t{10}, Precision - decimals )) ) );
+            return from_raw( muldiv( value, int128_t(1), int128_t(ipow( int64_t{10}, decimals - Precision )), mode ) );
+         }
+
+         // The value as a count of 10^-decimals, decimals being at most 18
+         constexpr int128_t rescale_raw( uint8_t decimals, rounding mode )const {
+            detail::check_numeric( decimals <= 18, "fixed_decimal supports up to 18 decimal places" );
+            if( decimals >= Precision )
+               return detail::checked_multiply( _value, int128_t(ipow( int64_t{10}, decimals - Precision )) );
+            return muldiv( _value, int128_t(1), int128_t(ipow( int64_t{10}, Precision - decimals )), mode );
+         }
+
+         int128_t _value = 0;
+   };
+}
@@ -0,0 +1,310 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+
+#include "asset.hpp"
+#include "check.hpp"
+#include "name.hpp"
+#include "print.hpp"
+#include "symbol.hpp"
+
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace eosio {
+
+   /**
+    *  @defgroup format Format
+    *  @ingroup core
+    *  @brief Defines allocation-free formatting into caller provided buffers
+    *
+    *  @details Formats strings, integers, names, symbols, assets and any type providing
+    *  `char* write_as_string(char* begin, char* end, bool dry_run)const` into a single buffer, without
+    *  building temporary `std::string` objects.
+    *
+    *  **Example:**
+    *  ```
+    *     check( from_balance >= quantity, format<64>("overdrawn balance: ", from_balance) );
+    *  ```
+    */
+
+   /// @cond IMPLEMENTATIONS
+
+   namespace detail {
+
+      // The longest value rendered aside to be truncated; every library type is shorter
+      constexpr size_t max_truncated_writable_size = 128;
+
+      // Writes a value through its write_as_string member, truncating it at end if necessary
+      template<typename T>
+      char* format_writable( char* begin, char* end, const T& value ) {
+         char* actual_end = value.write_as_string( begin, end );
+         if( actual_end >= begin && actual_end <= end )
+            return actual_end;
+
+         // does not fit: render into scratch space and keep the leading part, or leave out
+         // a value too long to render aside
+         char scratch[max_truncated_writable_size];
+         size_t size = value.write_as_string( scratch, scratch, true ) - scratch;
+         if( size > sizeof(scratch) )
+            return begin;
+         value.write_as_string( scratch, scratch + size );
+         return format_chars( begin, end, scratch, size );
+      }
+
+      inline char* format_arg( char* begin, char* end, const char* str ) {
+         return format_chars( begin, end, str, strlen(str) );
+      }
+
+      inline char* format_arg( char* begin, char* end, std::string_view str ) {
+         return format_chars( begin, end, str.data(), str.size() );
+      }
+
+      inline char* format_arg( char* begin, char* end, const std::string& str ) {
+         return format_chars( begin, end, str.data(), str.size() );
+      }
+
+      inline char* format_arg( char* begin, char* end, char c ) {
+         return format_chars( begin, end, &c, 1 );
+      }
+
+      inline char* format_arg( char* begin, char* end, bool b ) {
+         return b ? format_chars( begin, end, "true", 4 ) : format_chars( begin, end, "false", 5 );
+      }
+
+      inline char* format_arg( char* begin, char* end, const symbol& sym ) {
+         begin = format_unsigned( begin, end, static_cast<uint64_t>(sym.precision()), false );
+         begin = format_chars( begin, end, ",", 1 );
+         return format_writable( begin, end, sym.code() );
+      }
+
+      inline char* format_arg( char* begin, char* end, const extended_symbol& sym ) {
+         begin = format_arg( begin, end, sym.get_symbol() );
+         begin = format_chars( begin, end, "@", 1 );
+         return format_writable( begin, end, sym.get_contract() );
+      }
+
+      inline char* format_arg( char* begin, char* end, const extended_asset& a ) {
+         begin = format_writable( begin, end, a.quantity );
+         begin = format_chars( begin, end, "@", 1 );
+         return format_writable( begin, end, a.contract );
+      }
+
+      template<typename T>
+      std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value && !std::is_same<T, char>::value, char*>
+      format_arg( char* begin, char* end, T value ) {
+         return format_integer( begin, end, value );
+      }
+
+      template<typename T>
+      std::enable_if_t<has_write_as_string<T>::value, char*>
+      format_arg( char* begin, char* end, const T& value ) {
+         return format_writable( begin, end, value );
+      }
+
+   } // namespace detail
+
+   /// @endcond
+
+   /**
+    *  Formats the arguments one after another into the provided char buffer
+    *
+    *  @ingroup format
+    *  @pre The range [begin, end) must be a valid range of memory to write to.
+    *  @param begin - The start of the char buffer
+    *  @param end - Just past the end of the char buffer
+    *  @param args - Strings, characters, booleans, integers, symbols or values providing write_as_string
+    *  @return char* - Just past the end of the last character written
+    *  @post The range [begin, returned pointer) contains the formatted arguments. Output that does not fit is truncated at end; a value written through write_as_string that is longer than 128 characters is left out rather than truncated.
+    */
+   template<typename... Args>
+   char* format_to( char* begin, char* end, const Args&... args ) {
+      ((begin = detail::format_arg( begin, end, args )), ...);
+      return begin;
+   }
+
+   /**
+    *  Fixed capacity string stored in place, for building messages without heap allocation
+    *
+    *  @ingroup format
+    *  @tparam N - Maximum number of characters; appended output beyond it is truncated
+    */
+   template<size_t N>
+   class static_string {
+      public:
+         /**
+          * Construct an empty static_string
+          */
+         constexpr static_string() : _data{}, _size(0) {}
+
+         /**
+          * Maximum number of characters the static_string can hold
+          */
+         static constexpr size_t capacity() { return N; }
+
+         /**
+          * Number of characters currently held
+          */
+         constexpr size_t size()const { return _size; }
+
+         /**
+          * Whether the static_string holds no characters
+          */
+         constexpr bool empty()const { return _size == 0; }
+
+         /**
+          * Pointer to the held characters
+          */
+         constexpr const char* data()const { return _data; }
+
+         /**
+          * Pointer to the held characters followed by a null terminator
+          */
+         constexpr const char* c_str()const { return _data; }
+
+         /**
+          * Remove all the held characters
+          */
+         void clear() {
+            _size = 0;
+            _data[0] = '\0';
+         }
+
+         /**
+          * Format the arguments at the end of the held characters
+          *
+          * @param args - Arguments accepted by format_to
+          * @return static_string& - Reference to this static_string
+          */
+         template<typename... Args>
+         static_string& append( const Args&... args ) {
+            _size = format_to( _data + _size, _data + N, args... ) - _data;
+            _data[_size] = '\0';
+            return *this;
+         }
+
+         /**
+          * View of the held characters
+          */
+         constexpr operator std::string_view()const { return {_data, _size}; }
+
+         /**
+          *  Writes the held characters to the provided char buffer
+          *
+          *  @pre The range [begin, end) must be a valid range of memory to write to.
+          *  @param begin - The start of the char buffer
+          *  @param end - Just past the end of the char buffer
+          *  @param dry_run - If true, do not actually write anything into the range.
+          *  @return char* - Just past the end of the last character that would be written assuming dry_run == false and end was large enough to provide sufficient space.
+          *  @post Nothing is written if dry_run == true or returned pointer > end (insufficient space).
+          */
+         char* write_as_string( char* begin, char* end, bool dry_run = false )const {
+            char* actual_end = begin + _size;
+            if( dry_run || (actual_end < begin) || (actual_end > end) ) return actual_end;
+            memcpy( begin, _data, _size );
+            return actual_end;
+         }
+
+         /**
+          * Prints the held characters
+          */
+         void print()const {
+            printl( _data, _size );
+         }
+
+      private:
+         char   _data[N + 1];
+         size_t _size;
+   };
+
+   /**
+    *  Formats the arguments into a new static_string
+    *
+    *  @ingroup format
+    *  @tparam N - Capacity of the returned static_string
+    *  @param args - Arguments accepted by format_to
+    *  @return static_string<N> - The formatted, possibly truncated, string
+    *
+    *  Example:
+    *  @code
+    *  auto msg = eosio::format<32>("balance of ", "alice"_n, " is ", balance);
+    *  @endcode
+    */
+   template<size_t N = 128, typename... Args>
+   static_string<N> format( const Args&... args ) {
+      static_string<N> result;
+      result.append( args... );
+      return result;
+   }
+
+   /// @cond IMPLEMENTATIONS
+
+   namespace detail {
+      // strings are captured as views and small trivially copyable values by value, anything else by reference
+      template<typename T>
+      auto defer_format_arg( const T& arg ) {
+         if constexpr( std::is_convertible<const T&, std::string_view>::value )
+            return std::string_view( arg );
+         else if constexpr( std::is_trivially_copyable<T>::value && sizeof(T) <= 2 * sizeof(uint64_t) )
+            return arg;
+         else
+            return std::cref( arg );
+      }
+
+      template<typename T>
+      const T& deferred_format_arg( const T& arg ) { return arg; }
+
+      template<typename T>
+      const T& deferred_format_arg( std::reference_wrapper<const T> arg ) { return arg.get(); }
+   } // namespace detail
+
+   /// @endcond
+
+   /**
+    *  Captures format arguments and formats them only when invoked. Passed to check(), the message
+    *  is formatted only if the predicate fails.
+    *
+    *  Building the callable never allocates: strings are captured as std::string_view, small trivially
+    *  copyable values such as integers, names and assets by value, and other arguments by reference.
+    *  The callable must therefore not outlive its arguments; pass it straight to check().
+    *
+    *  @ingroup format
+    *  @tparam N - Capacity of the static_string produced on invocation
+    *  @param args - Arguments accepted by format_to
+    *  @return A callable returning static_string<N>
+    *
+    *  Example:
+    *  @code
+    *  eosio::check(balance >= quantity, eosio::defer_format("overdrawn balance: ", balance));
+    *  @endcode
+    */
+   template<size_t N = 128, typename... Args>
+   auto defer_format( const Args&... args ) {
+      return [captured = std::make_tuple( detail::defer_format_arg( args )... )]() {
+         return std::apply( []( const auto&... a ) { return format<N>( detail::deferred_format_arg( a )... ); }, captured );
+      };
+   }
+
+   /**
+    *  Assert if the predicate fails and use the supplied message, passing its length to the host.
+    *
+    *  @ingroup system
+    *
+    *  Example:
+    *  @code
+    *  eosio::check(a == b, eosio::format<64>(a, " does not equal ", b));
+    *  @endcode
+    */
+   template<size_t N>
+   inline void check( bool pred, const static_string<N>& msg ) {
+      if (!pred) {
+         internal_use_do_not_use::eosio_assert_message(false, msg.data(), msg.size());
+      }
+   }
+}
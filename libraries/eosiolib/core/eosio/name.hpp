@@ -7,6 +7,7 @@
 #include "check.hpp"
 #include "serialize.hpp"
 
+#include <array>
 #include <string>
 #include <string_view>
 
@@ -18,6 +19,31 @@ namespace eosio {
       }
    }
 
+   namespace detail {
+      /// Marks characters outside of the %name character set in name_char_values
+      constexpr uint8_t invalid_name_char = 0xFF;
+
+      constexpr std::array<uint8_t, 256> make_name_char_values() {
+         std::array<uint8_t, 256> values{};
+         for( auto& v : values )
+            v = invalid_name_char;
+         values['.'] = 0;
+         for( char c = '1'; c <= '5'; ++c )
+            values[static_cast<uint8_t>(c)] = (c - '1') + 1;
+         for( char c = 'a'; c <= 'z'; ++c )
+            values[static_cast<uint8_t>(c)] = (c - 'a') + 6;
+         return values;
+      }
+
+      /// Base32 value of every character, or invalid_name_char if it may not appear in a %name
+      inline constexpr std::array<uint8_t, 256> name_char_values = make_name_char_values();
+
+      /// Character for every Base32 value of a %name
+      inline constexpr std::array<char, 32> name_charmap = {{ '.', '1', '2', '3', '4', '5', 'a', 'b', 'c', 'd', 'e',
+                                                             'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p',
+                                                             'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z' }};
+   } /// namespace detail
+
    /**
     * @defgroup name
     * @ingroup core
@@ -84,9 +110,15 @@ namespace eosio {
          }
 
          auto n = std::min( (uint32_t)str.size(), (uint32_t)12u );
+         uint8_t invalid = 0;
          for( decltype(n) i = 0; i < n; ++i ) {
+            uint8_t v = detail::name_char_values[static_cast<uint8_t>(str[i])];
+            invalid |= v;
             value <<= 5;
-            value |= char_to_value( str[i] );
+            value |= (v & 0x1Full);
+         }
+         if( invalid == detail::invalid_name_char ) {
+            eosio::check( false, "character is not in allowed character set for names" );
          }
          value <<= ( 4 + 5*(12 - n) );
          if( str.size() == 13 ) {
@@ -105,36 +137,24 @@ namespace eosio {
        *  @return constexpr char - Converted value
        */
       static constexpr uint8_t char_to_value( char c ) {
-         if( c == '.')
-            return 0;
-         else if( c >= '1' && c <= '5' )
-            return (c - '1') + 1;
-         else if( c >= 'a' && c <= 'z' )
-            return (c - 'a') + 6;
-         else
+         uint8_t v = detail::name_char_values[static_cast<uint8_t>(c)];
+         if( v == detail::invalid_name_char )
             eosio::check( false, "character is not in allowed character set for names" );
 
-         return 0; // control flow will never reach here; just added to suppress warning
+         return v;
       }
 
       /**
        *  Returns the length of the %name
        */
       constexpr uint8_t length()const {
-         constexpr uint64_t mask = 0xF800000000000000ull;
-
          if( value == 0 )
             return 0;
+         if( value & 0x0Full )
+            return 13;
 
-         uint8_t l = 0;
-         uint8_t i = 0;
-         for( auto v = value; i < 13; ++i, v <<= 5 ) {
-            if( (v & mask) > 0 ) {
-               l = i;
-            }
-         }
-
-         return l + 1;
+         // the lowest set bit belongs to the last non-dot character; character i occupies bits [59-5i, 63-5i]
+         return static_cast<uint8_t>((63 - __builtin_ctzll(value)) / 5 + 1);
       }
 
       /**
@@ -195,24 +215,20 @@ namespace eosio {
        *  @post If the output string fits within the range [begin, end) and dry_run == false, the range [begin, returned pointer) contains the string representation of the %name. Nothing is written if dry_run == true or returned pointer > end (insufficient space) or if returned pointer < begin (overflow in calculating desired end).
        */
       char* write_as_string( char* begin, char* end, bool dry_run = false )const {
-         static const char* charmap = ".12345abcdefghijklmnopqrstuvwxyz";
-         constexpr uint64_t mask = 0xF800000000000000ull;
-
-         if( dry_run || (begin + 13 < begin) || (begin + 13 > end) ) {
-            char* actual_end = begin + length();
-            if( dry_run || (actual_end < begin) || (actual_end > end) ) return actual_end;
-         }
+         const uint8_t len = length();
+         char* actual_end = begin + len;
+         if( dry_run || (actual_end < begin) || (actual_end > end) ) return actual_end;
 
          auto v = value;
-         for( auto i = 0; i < 13; ++i, v <<= 5 ) {
-            if( v == 0 ) return begin;
-
-            auto indx = (v & mask) >> (i == 12 ? 60 : 59);
-            *begin = charmap[indx];
-            ++begin;
+         const uint8_t n = len < 12 ? len : 12;
+         for( uint8_t i = 0; i < n; ++i, v <<= 5 ) {
+            *begin++ = detail::name_charmap[v >> 59];
+         }
+         if( len == 13 ) {
+            *begin = detail::name_charmap[v >> 60];
          }
 
-         return begin;
+         return actual_end;
       }
 
       /**
@@ -232,7 +248,9 @@ namespace eosio {
        * @param name to be printed
        */
       inline void print()const {
+#ifndef EOSIO_NO_PRINT
         internal_use_do_not_use::printn(value);
+#endif
       }
 
       /// @cond INTERNAL
@@ -271,6 +289,67 @@ namespace eosio {
       EOSLIB_SERIALIZE( name, (value) )
    };
 
+   /**
+    *  Writes a sequence of names as a separated string to the provided char buffer
+    *
+    *  @ingroup name
+    *  @pre The range [begin, end) must be a valid range of memory to write to.
+    *  @param first - The first %name to write
+    *  @param last - Just past the last %name to write
+    *  @param begin - The start of the char buffer
+    *  @param end - Just past the end of the char buffer
+    *  @param separator - Character written between two consecutive names
+    *  @param dry_run - If true, do not actually write anything into the range.
+    *  @return char* - Just past the end of the last character that would be written assuming dry_run == false and end was large enough to provide sufficient space.
+    *  @post Nothing is written if dry_run == true or returned pointer > end (insufficient space) or if returned pointer < begin (overflow in calculating desired end).
+    */
+   inline char* names_to_string( const name* first, const name* last, char* begin, char* end, char separator = ',', bool dry_run = false ) {
+      size_t characters_needed = 0;
+      for( auto itr = first; itr != last; ++itr ) {
+         characters_needed += itr->length();
+      }
+      if( first != last ) {
+         characters_needed += (last - first) - 1;
+      }
+
+      char* actual_end = begin + characters_needed;
+      if( dry_run || (actual_end < begin) || (actual_end > end) ) return actual_end;
+
+      for( auto itr = first; itr != last; ++itr ) {
+         if( itr != first ) {
+            *begin++ = separator;
+         }
+         begin = itr->write_as_string( begin, actual_end );
+      }
+
+      return actual_end;
+   }
+
+   /**
+    *  Parses a separated list of names, validating every character through a single table lookup
+    *
+    *  @ingroup name
+    *  @param str - The separated list of names; an empty string contains no names
+    *  @param out - Destination for the parsed names
+    *  @param capacity - Number of names that fit in out
+    *  @param separator - Character separating two consecutive names
+    *  @return size_t - The number of names written to out
+    */
+   inline size_t parse_names( std::string_view str, name* out, size_t capacity, char separator = ',' ) {
+      if( str.empty() )
+         return 0;
+
+      size_t count = 0;
+      for( ;; ) {
+         auto pos = str.find( separator );
+         eosio::check( count < capacity, "too many names for the provided buffer" );
+         out[count++] = name{ str.substr( 0, pos ) };
+         if( pos == std::string_view::npos )
+            return count;
+         str.remove_prefix( pos + 1 );
+      }
+   }
+
    namespace detail {
       template <char... Str>
       struct to_const_char_arr {
@@ -0,0 +1,650 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+
+#include "check.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace eosio {
+
+   /**
+    *  @defgroup numeric Numeric
+    *  @ingroup core
+    *  @brief Checked wide integer arithmetic for asset and price math
+    *
+    *  @details `muldiv` computes `a * b / c` over an exact double width product with a choice
+    *  of rounding, `int256` is a signed 256-bit integer whose operations check for overflow,
+    *  and `isqrt` and `ipow` take integer square roots and powers. Everything is constexpr and
+    *  works on 64-bit words, so that contracts never call the 128-bit multiplication and
+    *  division builtins. Overflow and division by zero fail with eosio::check.
+    *
+    *  **Example:**
+    *  ```
+    *     // constant product pool: tokens out for `in` tokens in
+    *     uint64_t out = muldiv( pool_out, in, pool_in + in );
+    *     // fees are rounded in favor of the pool
+    *     uint64_t fee = muldiv( in, fee_bps, 10000, rounding::up );
+    *  ```
+    */
+
+   /**
+    *  Rounding of an inexact quotient
+    *
+    *  @ingroup numeric
+    */
+   enum class rounding : uint8_t {
+      down,   ///< toward negative infinity
+      up,     ///< toward positive infinity
+      nearest ///< to the nearest integer, halves away from zero
+   };
+
+   class int256;
+
+   /// @cond IMPLEMENTATIONS
+
+   namespace detail {
+
+      // eosio::check is not constexpr: only call it on failure
+      constexpr void check_numeric( bool pred, const char* msg ) {
+         if( !pred )
+            eosio::check( false, msg );
+      }
+
+      template<typename T>
+      struct identity { using type = T; };
+
+      template<typename T>
+      using identity_t = typename identity<T>::type;
+
+      template<typename T>
+      inline constexpr bool is_wide_integral_v = std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= 16;
+
+      template<typename T>
+      using unsigned_of_t = std::conditional_t<(sizeof(T) > 8), uint128_t, uint64_t>;
+
+      // hi:lo = a * b on 32-bit halves, keeping every product in 64-bit arithmetic
+      constexpr void mul_64x64( uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo ) {
+         if( ((a | b) >> 32) == 0 ) {
+            hi = 0;
+            lo = a * b;
+            return;
+         }
+         const uint64_t a0 = uint32_t(a), a1 = a >> 32;
+         const uint64_t b0 = uint32_t(b), b1 = b >> 32;
+         const uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+         const uint64_t mid = (p00 >> 32) + uint32_t(p01) + uint32_t(p10);
+         lo = (mid << 32) | uint32_t(p00);
+         hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+      }
+
+      // (hi:lo) / d for hi < d: long division on the 32-bit digits of the divisor normalized
+      // to its top bit (Hacker's Delight, divlu)
+      constexpr uint64_t div_128by64( uint64_t hi, uint64_t lo, uint64_t d, uint64_t& rem ) {
+         constexpr uint64_t base = uint64_t(1) << 32;
+         const unsigned s = __builtin_clzll(d);
+         d <<= s;
+         const uint64_t dn1 = d >> 32, dn0 = uint32_t(d);
+         const uint64_t un32 = s ? (hi << s) | (lo >> (64 - s)) : hi;
+         const uint64_t un10 = lo << s;
+         const uint64_t un1 = un10 >> 32, un0 = uint32_t(un10);
+
+         uint64_t q1 = un32 / dn1, rhat = un32 - q1 * dn1;
+         while( q1 >= base || q1 * dn0 > base * rhat + un1 ) {
+            --q1;
+            rhat += dn1;
+            if( rhat >= base )
+               break;
+         }
+         const uint64_t un21 = un32 * base + un1 - q1 * d;
+
+         uint64_t q0 = un21 / dn1;
+         rhat = un21 - q0 * dn1;
+         while( q0 >= base || q0 * dn0 > base * rhat + un0 ) {
+            --q0;
+            rhat += dn1;
+            if( rhat >= base )
+               break;
+         }
+         rem = (un21 * base + un0 - q0 * d) >> s;
+         return q1 * base + q0;
+      }
+
+      // Unsigned integers of N little endian 64-bit words
+      template<size_t N>
+      struct words {
+         uint64_t w[N] = {};
+
+         constexpr bool is_zero()const {
+            for( size_t i = 0; i < N; ++i )
+               if( w[i] )
+                  return false;
+            return true;
+         }
+
+         constexpr size_t size()const {
+            size_t n = N;
+            while( n && !w[n - 1] )
+               --n;
+            return n;
+         }
+
+         constexpr uint32_t digit( size_t i )const { return uint32_t(w[i / 2] >> (i % 2 * 32)); }
+      };
+
+      template<size_t N>
+      constexpr int compare( const words<N>& a, const words<N>& b ) {
+         for( size_t i = N; i-- > 0; )
+            if( a.w[i] != b.w[i] )
+               return a.w[i] < b.w[i] ? -1 : 1;
+         return 0;
+      }
+
+      // a += b, returning the carry out
+      template<size_t N>
+      constexpr bool add_to( words<N>& a, const words<N>& b ) {
+         uint64_t carry = 0;
+         for( size_t i = 0; i < N; ++i ) {
+            const uint64_t sum = a.w[i] + b.w[i];
+            const uint64_t c = sum < a.w[i];
+            a.w[i] = sum + carry;
+            carry = c | (a.w[i] < sum);
+         }
+         return carry;
+      }
+
+      // a -= b, returning the borrow out
+      template<size_t N>
+      constexpr bool subtract_from( words<N>& a, const words<N>& b ) {
+         uint64_t borrow = 0;
+         for( size_t i = 0; i < N; ++i ) {
+            const uint64_t diff = a.w[i] - b.w[i];
+            const uint64_t c = a.w[i] < b.w[i];
+            a.w[i] = diff - borrow;
+            borrow = c | (diff < borrow);
+         }
+         return borrow;
+      }
+
+      template<size_t N>
+      constexpr bool increment( words<N>& a ) {
+         for( size_t i = 0; i < N; ++i )
+            if( ++a.w[i] )
+               return false;
+         return true;
+      }
+
+      template<size_t N>
+      constexpr void negate( words<N>& a ) {
+         for( size_t i = 0; i < N; ++i )
+            a.w[i] = ~a.w[i];
+         increment( a );
+      }
+
+      // The full product of a and b
+      template<size_t N>
+      constexpr words<2 * N> multiply( const words<N>& a, const words<N>& b ) {
+         words<2 * N> product;
+         for( size_t i = 0; i < N; ++i ) {
+            if( !a.w[i] )
+               continue;
+            uint64_t carry = 0;
+            for( size_t j = 0; j < N; ++j ) {
+               uint64_t hi = 0, lo = 0;
+               mul_64x64( a.w[i], b.w[j], hi, lo );
+               lo += carry;
+               hi += lo < carry;
+               product.w[i + j] += lo;
+               hi += product.w[i + j] < lo;
+               carry = hi;
+            }
+            product.w[i + N] = carry;
+         }
+         return product;
+      }
+
+      // q = u / v and r = u % v for a non zero v: one 128/64 division per word of u when v fits
+      // in 64 bits, otherwise Knuth's algorithm D on 32-bit digits (Hacker's Delight, divmnu)
+      template<size_t N>
+      constexpr void divide( const words<N>& u, const words<N>& v, words<N>& q, words<N>& r ) {
+         q = words<N>{};
+         r = words<N>{};
+         if( v.size() <= 1 ) {
+            uint64_t rem = 0;
+            for( size_t i = N; i-- > 0; )
+               q.w[i] = rem ? div_128by64( rem, u.w[i], v.w[0], rem ) : (rem = u.w[i] % v.w[0], u.w[i] / v.w[0]);
+            r.w[0] = rem;
+            return;
+         }
+         if( compare( u, v ) < 0 ) {
+            r = u;
+            return;
+         }
+
+         constexpr uint64_t base = uint64_t(1) << 32;
+         size_t n = v.size() * 2, m = u.size() * 2;
+         if( !v.digit( n - 1 ) )
+            --n;
+         if( !u.digit( m - 1 ) )
+            --m;
+         const unsigned s = __builtin_clz( v.digit( n - 1 ) );
+
+         uint32_t vn[2 * N] = {}, un[2 * N + 1] = {}, qn[2 * N] = {};
+         for( size_t i = n - 1; i > 0; --i )
+            vn[i] = (v.digit( i ) << s) | uint32_t(s ? uint64_t(v.digit( i - 1 )) >> (32 - s) : 0);
+         vn[0] = v.digit( 0 ) << s;
+         un[m] = s ? uint32_t(uint64_t(u.digit( m - 1 )) >> (32 - s)) : 0;
+         for( size_t i = m - 1; i > 0; --i )
+            un[i] = (u.digit( i ) << s) | uint32_t(s ? uint64_t(u.digit( i - 1 )) >> (32 - s) : 0);
+         un[0] = u.digit( 0 ) << s;
+
+         for( size_t j = m - n + 1; j-- > 0; ) {
+            const uint64_t top = (uint64_t(un[j + n]) << 32) | un[j + n - 1];
+            uint64_t qhat = top / vn[n - 1], rhat = top % vn[n - 1];
+            while( qhat >= base || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2]) ) {
+               --qhat;
+               rhat += vn[n - 1];
+               if( rhat >= base )
+                  break;
+            }
+
+            int64_t borrow = 0, t = 0;
+            for( size_t i = 0; i < n; ++i ) {
+               const uint64_t p = qhat * vn[i];
+               t = int64_t(un[i + j]) - borrow - int64_t(p & 0xffffffff);
+               un[i + j] = uint32_t(t);
+               borrow = int64_t(p >> 32) - (t >> 32);
+            }
+            t = int64_t(un[j + n]) - borrow;
+            un[j + n] = uint32_t(t);
+
+            qn[j] = uint32_t(qhat);
+            if( t < 0 ) {
+               --qn[j];
+               uint64_t carry = 0;
+               for( size_t i = 0; i < n; ++i ) {
+                  const uint64_t sum = uint64_t(un[i + j]) + vn[i] + carry;
+                  un[i + j] = uint32_t(sum);
+                  carry = sum >> 32;
+               }
+               un[j + n] += uint32_t(carry);
+            }
+         }
+
+         for( size_t i = 0; i < N; ++i ) {
+            q.w[i] = (uint64_t(qn[2 * i + 1]) << 32) | qn[2 * i];
+            const uint64_t lo = (un[2 * i] >> s) | uint32_t(s ? uint64_t(un[2 * i + 1]) << (32 - s) : 0);
+            const uint64_t hi = (un[2 * i + 1] >> s) | uint32_t(s ? uint64_t(un[2 * i + 2]) << (32 - s) : 0);
+            r.w[i] = (hi << 32) | lo;
+         }
+      }
+
+      constexpr words<2> to_words( uint128_t v ) {
+         words<2> result;
+         result.w[0] = uint64_t(v);
+         result.w[1] = uint64_t(v >> 64);
+         return result;
+      }
+
+      constexpr uint128_t from_words( const words<2>& v ) {
+         return (uint128_t(v.w[1]) << 64) | v.w[0];
+      }
+
+      // The magnitude of an integer, in the unsigned integer of its width
+      template<typename T>
+      constexpr unsigned_of_t<T> magnitude( T v ) {
+         using U = unsigned_of_t<T>;
+         if constexpr( std::is_signed_v<T> )
+            return v < 0 ? U(0) - U(v) : U(v);
+         else
+            return U(v);
+      }
+
+      // The integer of the given sign and magnitude, checked against the range of T
+      template<typename T, typename U>
+      constexpr T from_magnitude( bool negative, U m, const char* msg ) {
+         using limits = std::numeric_limits<T>;
+         if constexpr( std::is_signed_v<T> ) {
+            detail::check_numeric( negative ? m <= U(limits::max()) + 1 : m <= U(limits::max()), msg );
+            return negative ? T(U(0) - m) : T(m);
+         } else {
+            detail::check_numeric( !negative || m == 0, msg );
+            detail::check_numeric( m <= U(limits::max()), msg );
+            return T(m);
+         }
+      }
+
+      constexpr bool round_away( rounding mode, bool negative, bool inexact, bool at_least_half ) {
+         if( !inexact )
+            return false;
+         switch( mode ) {
+            case rounding::down:
+               return negative;
+            case rounding::up:
+               return !negative;
+            default:
+               return at_least_half;
+         }
+      }
+
+      template<typename T>
+      constexpr T checked_multiply( T a, T b ) {
+         const bool negative = std::is_signed_v<T> && ((a < 0) != (b < 0));
+         const auto ma = magnitude( a ), mb = magnitude( b );
+         if constexpr( sizeof(T) <= 8 ) {
+            uint64_t hi = 0, lo = 0;
+            mul_64x64( ma, mb, hi, lo );
+            detail::check_numeric( hi == 0, "multiplication overflow" );
+            return from_magnitude<T>( negative, lo, "multiplication overflow" );
+         } else {
+            const words<4> product = multiply( to_words( ma ), to_words( mb ) );
+            detail::check_numeric( !product.w[2] && !product.w[3], "multiplication overflow" );
+            return from_magnitude<T>( negative, (uint128_t(product.w[1]) << 64) | product.w[0], "multiplication overflow" );
+         }
+      }
+
+      constexpr int256 checked_multiply( const int256& a, const int256& b );
+   }
+
+   /// @endcond
+
+   /**
+    *  Signed 256-bit integer in two's complement, whose arithmetic checks for overflow and
+    *  division by zero
+    *
+    *  @ingroup numeric
+    */
+   class int256 {
+      public:
+         /**
+          * Construct a new int256 of value 0
+          */
+         constexpr int256() = default;
+
+         /**
+          * Construct a new int256 from any integer of up to 128 bits
+          *
+          * @param v - The value
+          */
+         template<typename T, typename = std::enable_if_t<detail::is_wide_integral_v<T>>>
+         constexpr int256( T v ) {
+            const uint64_t extension = std::is_signed_v<T> && v < 0 ? ~uint64_t(0) : 0;
+            _value.w[0] = uint64_t(v);
+            if constexpr( sizeof(T) > 8 )
+               _value.w[1] = uint64_t(v >> 64);
+            else
+               _value.w[1] = extension;
+            _value.w[2] = _value.w[3] = extension;
+         }
+
+         /**
+          * The largest value, 2^255 - 1
+          */
+         static constexpr int256 max() {
+            int256 result;
+            result._value.w[0] = result._value.w[1] = result._value.w[2] = ~uint64_t(0);
+            result._value.w[3] = ~uint64_t(0) >> 1;
+            return result;
+         }
+
+         /**
+          * The smallest value, -2^255
+          */
+         static constexpr int256 min() {
+            int256 result;
+            result._value.w[3] = uint64_t(1) << 63;
+            return result;
+         }
+
+         /**
+          * Check whether the value is negative
+          */
+         constexpr bool is_negative()const { return _value.w[3] >> 63; }
+
+         /**
+          * Convert to an integer type, checking that the value is within its range
+          */
+         template<typename T, typename = std::enable_if_t<detail::is_wide_integral_v<T>>>
+         constexpr explicit operator T()const {
+            detail::check_numeric( int256( std::numeric_limits<T>::min() ) <= *this && *this <= int256( std::numeric_limits<T>::max() ), "int256 overflow" );
+            if constexpr( sizeof(T) > 8 )
+               return T((uint128_t(_value.w[1]) << 64) | _value.w[0]);
+            else
+               return T(_value.w[0]);
+         }
+
+         /**
+          * The 64-bit words of the value, least significant first
+          */
+         constexpr uint64_t word( size_t i )const { return _value.w[i]; }
+
+         constexpr int256 operator-()const {
+            detail::check_numeric( *this != min(), "int256 overflow" );
+            int256 result = *this;
+            detail::negate( result._value );
+            return result;
+         }
+
+         constexpr int256& operator+=( const int256& b ) {
+            const bool negative = is_negative();
+            detail::add_to( _value, b._value );
+            detail::check_numeric( negative != b.is_negative() || negative == is_negative(), "addition overflow" );
+            return *this;
+         }
+
+         constexpr int256& operator-=( const int256& b ) {
+            const bool negative = is_negative();
+            detail::subtract_from( _value, b._value );
+            detail::check_numeric( negative == b.is_negative() || negative == is_negative(), "subtraction overflow" );
+            return *this;
+         }
+
+         constexpr int256& operator*=( const int256& b ) {
+            return *this = detail::checked_multiply( *this, b );
+         }
+
+         /**
+          * Division, truncating toward zero
+          */
+         constexpr int256& operator/=( const int256& b ) {
+            int256 r;
+            divide( *this, b, *this, r );
+            return *this;
+         }
+
+         /**
+          * Remainder of the division truncating toward zero, of the sign of the dividend
+          */
+         constexpr int256& operator%=( const int256& b ) {
+            int256 q;
+            divide( *this, b, q, *this );
+            return *this;
+         }
+
+         friend constexpr int256 operator+( int256 a, const int256& b ) { return a += b; }
+         friend constexpr int256 operator-( int256 a, const int256& b ) { return a -= b; }
+         friend constexpr int256 operator*( const int256& a, const int256& b ) { return detail::checked_multiply( a, b ); }
+         friend constexpr int256 operator/( int256 a, const int256& b ) { return a /= b; }
+         friend constexpr int256 operator%( int256 a, const int256& b ) { return a %= b; }
+
+         friend constexpr bool operator==( const int256& a, const int256& b ) { return detail::compare( a._value, b._value ) == 0; }
+         friend constexpr bool operator!=( const int256& a, const int256& b ) { return !(a == b); }
+         friend constexpr bool operator<( const int256& a, const int256& b ) {
+            if( a.is_negative() != b.is_negative() )
+               return a.is_negative();
+            return detail::compare( a._value, b._value ) < 0;
+         }
+         friend constexpr bool operator>( const int256& a, const int256& b ) { return b < a; }
+         friend constexpr bool operator<=( const int256& a, const int256& b ) { return !(b < a); }
+         friend constexpr bool operator>=( const int256& a, const int256& b ) { return !(a < b); }
+
+      private:
+         friend constexpr int256 detail::checked_multiply( const int256& a, const int256& b );
+
+         // The magnitude of the value, 2^255 for min()
+         constexpr detail::words<4> magnitude()const {
+            detail::words<4> result = _value;
+            if( is_negative() )
+               detail::negate( result );
+            return result;
+         }
+
+         constexpr void set_magnitude( bool negative, const detail::words<4>& m, const char* msg ) {
+            _value = m;
+            if( negative ) {
+               detail::check_numeric( detail::compare( m, min()._value ) <= 0, msg );
+               detail::negate( _value );
+            } else {
+               detail::check_numeric( !is_negative(), msg );
+            }
+         }
+
+         static constexpr void divide( const int256& a, const int256& b, int256& q, int256& r ) {
+            detail::check_numeric( !b._value.is_zero(), "divide by zero" );
+            // q or r may be a
+            const bool negative_a = a.is_negative(), negative_b = b.is_negative();
+            detail::words<4> mq, mr;
+            detail::divide( a.magnitude(), b.magnitude(), mq, mr );
+            q.set_magnitude( negative_a != negative_b, mq, "int256 overflow" );
+            r.set_magnitude( negative_a, mr, "int256 overflow" );
+         }
+
+         detail::words<4> _value;
+   };
+
+   /// @cond IMPLEMENTATIONS
+
+   namespace detail {
+      constexpr int256 checked_multiply( const int256& a, const int256& b ) {
+         const words<8> product = multiply( a.magnitude(), b.magnitude() );
+         detail::check_numeric( !product.w[4] && !product.w[5] && !product.w[6] && !product.w[7], "multiplication overflow" );
+         words<4> m;
+         for( size_t i = 0; i < 4; ++i )
+            m.w[i] = product.w[i];
+         int256 result;
+         result.set_magnitude( a.is_negative() != b.is_negative(), m, "multiplication overflow" );
+         return result;
+      }
+   }
+
+   /// @endcond
+
+   /**
+    *  a * b / c over the exact double width product of a and b, rounded as requested. The
+    *  operands and the result share the type of a, any integer of up to 128 bits.
+    *
+    *  @ingroup numeric
+    *  @param a - The multiplicand
+    *  @param b - The multiplier
+    *  @param c - The divisor
+    *  @param mode - The rounding of an inexact quotient, down by default
+    *  @return The quotient, checked to fit in the type of a
+    *
+    *  Example:
+    *  @code
+    *  int64_t out = muldiv( amount.amount, price, precision, rounding::nearest );
+    *  @endcode
+    */
+   template<typename T>
+   constexpr T muldiv( T a, detail::identity_t<T> b, detail::identity_t<T> c, rounding mode = rounding::down ) {
+      static_assert( detail::is_wide_integral_v<T>, "muldiv requires integers of up to 128 bits" );
+      detail::check_numeric( c != 0, "divide by zero" );
+      const bool negative = std::is_signed_v<T> && (((a < 0) != (b < 0)) != (c < 0)) && a != 0 && b != 0;
+      const auto ma = detail::magnitude( a ), mb = detail::magnitude( b ), mc = detail::magnitude( c );
+
+      if constexpr( sizeof(T) <= 8 ) {
+         uint64_t hi = 0, lo = 0, rem = 0;
+         detail::mul_64x64( ma, mb, hi, lo );
+         detail::check_numeric( hi < mc, "muldiv overflow" );
+         uint64_t q = 0;
+         if( hi ) {
+            q = detail::div_128by64( hi, lo, mc, rem );
+         } else {
+            q = lo / mc;
+            rem = lo % mc;
+         }
+         if( detail::round_away( mode, negative, rem != 0, rem >= mc - rem ) ) {
+            ++q;
+            detail::check_numeric( q != 0, "muldiv overflow" );
+         }
+         return detail::from_magnitude<T>( negative, q, "muldiv overflow" );
+      } else {
+         const detail::words<4> product = detail::multiply( detail::to_words( ma ), detail::to_words( mb ) );
+         detail::words<4> divisor, q, rem;
+         divisor.w[0] = uint64_t(mc);
+         divisor.w[1] = uint64_t(mc >> 64);
+         detail::divide( product, divisor, q, rem );
+         detail::words<4> half = divisor;
+         detail::subtract_from( half, rem );
+         if( detail::round_away( mode, negative, !rem.is_zero(), detail::compare( rem, half ) >= 0 ) )
+            detail::increment( q );
+         detail::check_numeric( !q.w[2] && !q.w[3], "muldiv overflow" );
+         return detail::from_magnitude<T>( negative, (uint128_t(q.w[1]) << 64) | q.w[0], "muldiv overflow" );
+      }
+   }
+
+   /**
+    *  The integer square root, the largest integer whose square is at most n
+    *
+    *  @ingroup numeric
+    *  @param n - A non negative integer of up to 128 bits
+    *
+    *  Example:
+    *  @code
+    *  // liquidity tokens of a new pool
+    *  uint128_t shares = isqrt( uint128_t(amount0) * amount1 );
+    *  @endcode
+    */
+   template<typename T>
+   constexpr T isqrt( T n ) {
+      static_assert( detail::is_wide_integral_v<T>, "isqrt requires integers of up to 128 bits" );
+      if constexpr( std::is_signed_v<T> )
+         detail::check_numeric( n >= 0, "square root of a negative number" );
+      using U = detail::unsigned_of_t<T>;
+      U rem = U(n), root = 0;
+      // digit by digit, with shifts and subtractions only
+      U bit = U(1) << (sizeof(U) * 8 - 2);
+      while( bit > rem )
+         bit >>= 2;
+      while( bit ) {
+         if( rem >= root + bit ) {
+            rem -= root + bit;
+            root = (root >> 1) + bit;
+         } else {
+            root >>= 1;
+         }
+         bit >>= 2;
+      }
+      return T(root);
+   }
+
+   /**
+    *  base raised to exponent, checked for overflow
+    *
+    *  @ingroup numeric
+    *  @param base - An integer of up to 128 bits, or an int256
+    *  @param exponent - The exponent
+    *
+    *  Example:
+    *  @code
+    *  // compound interest over n periods at rate / 10000
+    *  int256 growth = ipow( int256(10000 + rate), n );
+    *  @endcode
+    */
+   template<typename T>
+   constexpr T ipow( T base, uint32_t exponent ) {
+      T result = 1;
+      for( ;; ) {
+         if( exponent & 1 )
+            result = detail::checked_multiply( result, base );
+         exponent >>= 1;
+         if( !exponent )
+            return result;
+         base = detail::checked_multiply( base, base );
+      }
+   }
+}
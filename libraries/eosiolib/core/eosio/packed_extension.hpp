@@ -0,0 +1,174 @@
+#pragma once
+
+#include "asset.hpp"
+#include "check.hpp"
+#include "datastream.hpp"
+#include "fixed_bytes.hpp"
+#include "name.hpp"
+#include "symbol.hpp"
+
+#include <array>
+#include <type_traits>
+
+namespace eosio {
+   /**
+    *  @defgroup packed_extension Packed Extension
+    *  @ingroup core
+    *  @ingroup types
+    *  @brief Trailing field decoded only when it is accessed
+    */
+
+   /// @cond IMPLEMENTATIONS
+
+   namespace detail {
+      /**
+       *  The serialized size of T, for the types whose size does not depend on their value
+       */
+      template<typename T, typename Enable = void>
+      struct fixed_packed_size {
+         static_assert( !std::is_same_v<T, T>, "type does not have a fixed serialized size" );
+      };
+
+      template<typename T>
+      struct fixed_packed_size<T, std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>>> {
+         static constexpr size_t value = sizeof(T);
+      };
+
+      template<>
+      struct fixed_packed_size<name> { static constexpr size_t value = sizeof(uint64_t); };
+
+      template<>
+      struct fixed_packed_size<symbol_code> { static constexpr size_t value = sizeof(uint64_t); };
+
+      template<>
+      struct fixed_packed_size<symbol> { static constexpr size_t value = sizeof(uint64_t); };
+
+      template<>
+      struct fixed_packed_size<asset> { static constexpr size_t value = sizeof(int64_t) + sizeof(uint64_t); };
+
+      template<size_t Size>
+      struct fixed_packed_size<fixed_bytes<Size>> { static constexpr size_t value = Size; };
+
+      template<size_t Size>
+      struct fixed_packed_size<byte_checksum<Size>> { static constexpr size_t value = Size; };
+
+      template<typename T, size_t N>
+      struct fixed_packed_size<std::array<T, N>> { static constexpr size_t value = N * fixed_packed_size<T>::value; };
+   }
+
+   /// @endcond
+
+   /**
+    *  View of a trailing field, as binary_extension, that is decoded only when it is accessed
+    *
+    *  @ingroup packed_extension
+    *  @details Deserializing a packed_extension records where the rest of the buffer starts and
+    *  skips it; value() decodes it on every call. A contract that does not use a large optional
+    *  payload of an action never decodes it, and one that forwards it writes the bytes back as
+    *  they are. The view refers to the buffer it was read from, so it is valid for as long as the
+    *  buffer is: the action data while an action is dispatched. Tables copy rows out of a
+    *  temporary buffer and store binary_extension instead.
+    *
+    *  An action declared as `void update( name user, uint64_t id, packed_extension<profile> p )`
+    *  appears in the ABI with the field `p` of type `profile$`, and is sent with a profile.
+    *
+    *  @tparam T - Contained type
+    */
+   template <typename T>
+   class packed_extension {
+      public:
+         using value_type = T;
+
+         constexpr packed_extension() = default;
+
+         /**
+          * Construct a view of the serialized value in [data, data + size), absent if size is 0
+          */
+         constexpr packed_extension( const char* data, size_t size )
+         :_data(data), _size(size)
+         {}
+
+         /**
+          * The view of the trailing field of a buffer, preceded by fields of fixed size
+          *
+          * @tparam Preceding - The types of the fields before this one, each of a fixed serialized size
+          * @param data - The buffer, such as the action data
+          * @param size - The size of the buffer
+          */
+         template<typename... Preceding>
+         static constexpr packed_extension at( const char* data, size_t size ) {
+            constexpr size_t offset = (detail::fixed_packed_size<Preceding>::value + ... + 0);
+            if( size < offset ) check( false, "buffer ends before packed_extension" );
+            return packed_extension( data + offset, size - offset );
+         }
+
+         /** test if the field is present */
+         constexpr explicit operator bool()const { return _size != 0; }
+         /** test if the field is present */
+         constexpr bool has_value()const { return _size != 0; }
+
+         /** decode the field */
+         T value()const {
+            if( !has_value() ) {
+               check( false, "cannot get value of empty packed_extension" );
+            }
+            T val;
+            datastream<const char*> ds( _data, _size );
+            ds >> val;
+            return val;
+         }
+
+         /** decode the field, or return def if it is absent */
+         T value_or( T def = {} )const {
+            return has_value() ? value() : def;
+         }
+
+         /** the serialized field */
+         constexpr const char* data()const { return _data; }
+         /** the size of the serialized field */
+         constexpr size_t size()const { return _size; }
+
+      private:
+         const char* _data = nullptr;
+         size_t      _size = 0;
+   };
+
+   /// @cond IMPLEMENTATIONS
+
+   /**
+    *  Serialize a packed_extension into a stream
+    *
+    *  @ingroup packed_extension
+    *  @brief Serialize a packed_extension as the bytes it views
+    *  @param ds - The stream to write
+    *  @param pe - The value to serialize
+    *  @tparam DataStream - Type of datastream buffer
+    *  @return DataStream& - Reference to the datastream
+    */
+   template<typename DataStream, typename T>
+   inline DataStream& operator<<(DataStream& ds, const eosio::packed_extension<T>& pe) {
+     ds.write( pe.data(), pe.size() );
+     return ds;
+   }
+
+   /**
+    *  Deserialize a packed_extension from a stream
+    *
+    *  @ingroup packed_extension
+    *  @brief Deserialize a packed_extension by recording the rest of the stream and skipping it
+    *  @param ds - The stream to read
+    *  @param pe - The destination for deserialized value
+    *  @tparam DataStream - Type of datastream buffer
+    *  @return DataStream& - Reference to the datastream
+    */
+   template<typename DataStream, typename T>
+   inline DataStream& operator>>(DataStream& ds, eosio::packed_extension<T>& pe) {
+     const size_t size = ds.remaining();
+     pe = eosio::packed_extension<T>( ds.pos(), size );
+     ds.skip( size );
+     return ds;
+   }
+
+   /// @endcond
+
+} // namespace eosio
@@ -0,0 +1,173 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+
+#include "check.hpp"
+
+#include <array>
+#include <limits>
+
+namespace eosio {
+
+   /**
+    *  @defgroup perfect_hash Perfect Hash
+    *  @ingroup core
+    *  @brief Constant time lookup in a set of 64-bit keys built at compile time
+    */
+
+   /// @cond IMPLEMENTATIONS
+
+   namespace detail {
+      constexpr uint64_t perfect_hash_mix( uint64_t x ) {
+         x ^= x >> 33;
+         x *= 0xff51afd7ed558ccdull;
+         x ^= x >> 33;
+         x *= 0xc4ceb9fe1a85ec53ull;
+         x ^= x >> 33;
+         return x;
+      }
+
+      constexpr size_t perfect_hash_ceil_pow2( size_t n ) {
+         size_t p = 1;
+         while( p < n )
+            p <<= 1;
+         return p;
+      }
+   }
+
+   /// @endcond
+
+   /**
+    *  Perfect hash table over N distinct 64-bit keys, such as action names, built at compile
+    *  time by hash and displace
+    *
+    *  @ingroup perfect_hash
+    *  @details The keys are spread over buckets by their hash, and each bucket is given the
+    *  displacement that sends all its keys to free slots of a table at most half full. A lookup
+    *  hashes the key twice, reads its bucket and its slot, and compares the key found there with
+    *  the one looked up, whatever the number of keys.
+    *
+    *  **Example:**
+    *  ```
+    *     static constexpr uint64_t actions[] = { "transfer"_n.value, "issue"_n.value, "retire"_n.value };
+    *     static constexpr perfect_hash table( actions );
+    *     static_assert( table.find( "issue"_n.value ) == 1 );
+    *  ```
+    *
+    *  @tparam N - The number of keys
+    */
+   template<size_t N>
+   class perfect_hash {
+      static_assert( N < std::numeric_limits<uint16_t>::max(), "perfect_hash supports up to 65534 keys" );
+
+      public:
+         /**
+          * The number of slots, a power of two at least twice the number of keys
+          */
+         static constexpr size_t table_size = detail::perfect_hash_ceil_pow2( 2 * N );
+
+         /**
+          * The number of buckets, a quarter of the slots
+          */
+         static constexpr size_t bucket_count = table_size < 4 ? 1 : table_size / 4;
+
+         /**
+          * Build the table of the given keys, which must be distinct
+          *
+          * @param keys - The keys, whose positions find returns
+          */
+         constexpr perfect_hash( const uint64_t (&keys)[N] ) { build( keys ); }
+
+         /**
+          * Build the table of the given keys, which must be distinct
+          *
+          * @param keys - The keys, whose positions find returns
+          */
+         constexpr perfect_hash( const std::array<uint64_t, N>& keys ) { build( keys ); }
+
+         /**
+          * The number of keys
+          */
+         static constexpr size_t size() { return N; }
+
+         /**
+          * The position of key among the keys the table was built from, or size() if absent
+          *
+          * @param key - The key to look up
+          */
+         constexpr size_t find( uint64_t key )const {
+            const uint64_t h = detail::perfect_hash_mix( key );
+            const size_t i = _slots[slot( h, _displacements[bucket( h )] )];
+            return i < N && _keys[i] == key ? i : N;
+         }
+
+      private:
+         template<typename Keys>
+         constexpr void build( const Keys& keys ) {
+            for( size_t i = 0; i < N; ++i )
+               _keys[i] = keys[i];
+
+            // the keys ordered by bucket, those of bucket b in [start[b], start[b+1])
+            std::array<uint16_t, N> order{};
+            std::array<size_t, bucket_count + 1> start{};
+            for( size_t i = 0; i < N; ++i )
+               ++start[bucket( detail::perfect_hash_mix( keys[i] ) ) + 1];
+            size_t largest = 0;
+            for( size_t b = 0; b < bucket_count; ++b ) {
+               if( start[b + 1] > largest )
+                  largest = start[b + 1];
+               start[b + 1] += start[b];
+            }
+            std::array<size_t, bucket_count> next{};
+            for( size_t b = 0; b < bucket_count; ++b )
+               next[b] = start[b];
+            for( size_t i = 0; i < N; ++i )
+               order[next[bucket( detail::perfect_hash_mix( keys[i] ) )]++] = uint16_t(i);
+
+            for( size_t s = 0; s < table_size; ++s )
+               _slots[s] = uint16_t(N);
+
+            // place the largest buckets first, while most slots are free
+            for( size_t size = largest; size > 0; --size ) {
+               for( size_t b = 0; b < bucket_count; ++b ) {
+                  if( start[b + 1] - start[b] != size )
+                     continue;
+                  // equal keys share their bucket
+                  for( size_t i = start[b]; i < start[b + 1]; ++i )
+                     for( size_t j = start[b]; j < i; ++j )
+                        if( keys[order[i]] == keys[order[j]] ) check( false, "duplicate key in perfect_hash" );
+                  for( uint32_t d = 0; ; ++d ) {
+                     if( d > std::numeric_limits<uint16_t>::max() ) check( false, "perfect_hash could not place the keys" );
+                     size_t placed = start[b];
+                     for( ; placed < start[b + 1]; ++placed ) {
+                        const size_t s = slot( detail::perfect_hash_mix( keys[order[placed]] ), uint16_t(d) );
+                        if( _slots[s] != N )
+                           break;
+                        _slots[s] = order[placed];
+                     }
+                     if( placed == start[b + 1] ) {
+                        _displacements[b] = uint16_t(d);
+                        break;
+                     }
+                     while( placed-- > start[b] )
+                        _slots[slot( detail::perfect_hash_mix( keys[order[placed]] ), uint16_t(d) )] = uint16_t(N);
+                  }
+               }
+            }
+         }
+
+         static constexpr size_t bucket( uint64_t h ) {
+            return size_t( h & (bucket_count - 1) );
+         }
+
+         static constexpr size_t slot( uint64_t h, uint16_t displacement ) {
+            return size_t( detail::perfect_hash_mix( h + displacement ) & (table_size - 1) );
+         }
+
+         std::array<uint64_t, N>              _keys{};
+         std::array<uint16_t, bucket_count>   _displacements{};
+         std::array<uint16_t, table_size>     _slots{};
+   };
+}
@@ -3,9 +3,12 @@
  *  @copyright defined in eos/LICENSE
  */
 #pragma once
-#include <utility>
+#include <algorithm>
+#include <cstring>
 #include <string>
-
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 
 namespace eosio {
@@ -65,8 +68,85 @@ namespace eosio {
     *  There are two ways to overload print:
     *  1. implement void print( const T& )
     *  2. implement T::print()const
+    *
+    *  @section batching Batched Output
+    *
+    *  Printing several values in one `print()` call formats them into a local buffer which is
+    *  handed to the host with a single `prints_l`. Use eosio::print_buffer directly to batch
+    *  the output of a whole action.
+    *
+    *  Defining `EOSIO_NO_PRINT` (`eosio-cpp -fno-print`) compiles all of the console functions
+    *  below, and the print() members of the library types, to empty inline functions, removing
+    *  both the formatting code and the host calls.
     */
 
+   /// @cond IMPLEMENTATIONS
+
+   namespace detail {
+
+      template<typename T, typename = void>
+      struct has_write_as_string : std::false_type {};
+
+      template<typename T>
+      struct has_write_as_string<T, std::void_t<decltype(std::declval<const T&>().write_as_string(std::declval<char*>(), std::declval<char*>(), true))>>
+         : std::true_type {};
+
+      inline char* format_chars( char* begin, char* end, const char* str, size_t len ) {
+         size_t n = std::min( len, static_cast<size_t>(end - begin) );
+         memcpy( begin, str, n );
+         return begin + n;
+      }
+
+      // Writes an unsigned integer of up to 128 bits, most significant digit first
+      template<typename T>
+      char* format_unsigned( char* begin, char* end, T value, bool negative ) {
+         char digits[40];
+         char* pos = digits + sizeof(digits);
+         do {
+            *--pos = '0' + static_cast<char>(value % 10);
+            value /= 10;
+         } while( value != 0 );
+         if( negative )
+            *--pos = '-';
+         return format_chars( begin, end, pos, (digits + sizeof(digits)) - pos );
+      }
+
+      // Writes a signed or unsigned integer of up to 128 bits
+      template<typename T>
+      char* format_integer( char* begin, char* end, T value ) {
+         if constexpr( std::is_signed<T>::value ) {
+            using unsigned_t = std::make_unsigned_t<T>;
+            bool negative = value < 0;
+            // negate in the unsigned domain so the minimum value does not overflow
+            unsigned_t magnitude = negative ? unsigned_t(0) - static_cast<unsigned_t>(value) : static_cast<unsigned_t>(value);
+            return format_unsigned( begin, end, magnitude, negative );
+         } else {
+            return format_unsigned( begin, end, value, false );
+         }
+      }
+
+   } // namespace detail
+
+   /// @endcond
+
+#ifdef EOSIO_NO_PRINT
+
+   /// @cond IMPLEMENTATIONS
+
+   inline void printhex( const void*, uint32_t ) {}
+
+   inline void printl( const char*, size_t ) {}
+
+   template<typename... Args>
+   inline void print( Args&&... ) {}
+
+   template<typename... Args>
+   inline void print_f( const char*, Args&&... ) {}
+
+   /// @endcond
+
+#else
+
    /**
     *  Prints a block of bytes in hexadecimal
     *
@@ -209,8 +289,137 @@ namespace eosio {
       }
    }
 
+#endif
+
+   /// @cond IMPLEMENTATIONS
+
+   namespace detail {
+      // Called from outside print_buffer so that unqualified lookup is not hidden by print_buffer::print
+      template<typename T>
+      inline void print_unbuffered( T&& t ) {
+         print( std::forward<T>(t) );
+      }
+   }
+
+   /// @endcond
+
+   /**
+    *  Collects console output in a local buffer and hands it to the host with a single prints_l
+    *  when the buffer fills up, on flush() and on destruction.
+    *
+    *  Strings, characters, booleans, integers up to 64 bits and types providing write_as_string
+    *  (name, symbol_code, asset, ...) are formatted into the buffer. Other values flush the
+    *  buffer and are printed through their usual print() overload, so the output order is kept.
+    *
+    *  @ingroup console
+    *  @tparam N - Size of the buffer in bytes
+    *
+    *  Example:
+    *  @code
+    *  eosio::print_buffer<> out;
+    *  out.print("from: ", from, " to: ", to);
+    *  out.print(" quantity: ", quantity);
+    *  // one prints_l when out goes out of scope
+    *  @endcode
+    */
+   template<size_t N = 256>
+   class print_buffer {
+      public:
+         print_buffer() = default;
+         print_buffer( const print_buffer& ) = delete;
+         print_buffer& operator=( const print_buffer& ) = delete;
+
+         ~print_buffer() { flush(); }
+
+         /**
+          * Append the values to the buffer
+          *
+          * @param args - The values to be printed
+          * @return print_buffer& - Reference to this print_buffer
+          */
+         template<typename... Args>
+         print_buffer& print( Args&&... args ) {
+#ifndef EOSIO_NO_PRINT
+            (append( std::forward<Args>(args) ), ...);
+#endif
+            return *this;
+         }
+
+         /**
+          * Hand the buffered output to the host and empty the buffer
+          */
+         void flush() {
+#ifndef EOSIO_NO_PRINT
+            if( _size > 0 ) {
+               internal_use_do_not_use::prints_l( _data, _size );
+               _size = 0;
+            }
+#endif
+         }
+
+         /**
+          * Number of bytes currently buffered
+          */
+         size_t size()const { return _size; }
+
+      private:
+         void append_chars( const char* str, size_t len ) {
+            if( len > N - _size ) {
+               flush();
+               if( len > N ) {
+                  internal_use_do_not_use::prints_l( str, len );
+                  return;
+               }
+            }
+            memcpy( _data + _size, str, len );
+            _size += len;
+         }
+
+         template<typename T>
+         void append_writable( const T& t ) {
+            size_t len = t.write_as_string( _data, _data, true ) - _data;
+            if( len > N - _size ) {
+               flush();
+               if( len > N ) {
+                  t.print();
+                  return;
+               }
+            }
+            _size = t.write_as_string( _data + _size, _data + N ) - _data;
+         }
+
+         template<typename T>
+         void append( T&& t ) {
+            using type = std::decay_t<T>;
+            if constexpr( std::is_same<type, const char*>::value || std::is_same<type, char*>::value ) {
+               append_chars( t, strlen(t) );
+            } else if constexpr( std::is_same<type, std::string>::value || std::is_same<type, std::string_view>::value ) {
+               append_chars( t.data(), t.size() );
+            } else if constexpr( std::is_same<type, bool>::value ) {
+               t ? append_chars( "true", 4 ) : append_chars( "false", 5 );
+            } else if constexpr( std::is_same<type, char>::value ) {
+               append_chars( &t, 1 );
+            } else if constexpr( std::is_integral<type>::value && sizeof(type) <= sizeof(uint64_t) ) {
+               char digits[20];
+               append_chars( digits, detail::format_integer( digits, digits + sizeof(digits), t ) - digits );
+            } else if constexpr( detail::has_write_as_string<type>::value && std::is_class<type>::value ) {
+               append_writable( t );
+            } else {
+               // 128-bit integers, floating point and types only providing print()
+               flush();
+               detail::print_unbuffered( std::forward<T>(t) );
+            }
+         }
+
+         char   _data[N];
+         size_t _size = 0;
+   };
+
+#ifndef EOSIO_NO_PRINT
+
     /**
-     *  Print out value / list of values
+     *  Print out value / list of values. The values are collected in a print_buffer, so
+     *  the whole list normally reaches the host in a single prints_l.
      *
      *  @tparam Arg - Type of the value used to replace the format specifier
      *  @tparam Args - Type of the value used to replace the format specifier
@@ -230,10 +439,12 @@ namespace eosio {
      */
    template<typename Arg, typename... Args>
    void print( Arg&& a, Args&&... args ) {
-      print(std::forward<Arg>(a));
-      print(std::forward<Args>(args)...);
+      print_buffer<> buffer;
+      buffer.print( std::forward<Arg>(a), std::forward<Args>(args)... );
    }
 
+#endif
+
    /**
     * Simulate C++ style streams
     *
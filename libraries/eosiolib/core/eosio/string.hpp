@@ -389,8 +389,10 @@ namespace eosio {
       }
 
       inline void print() const {
+#ifndef EOSIO_NO_PRINT
          const char* tmp{(is_literal()) ? std::get<const char*>(_begin) : std::get<uptr>(_begin).get()};
          internal_use_do_not_use::prints_l(tmp, _size);
+#endif
       }
 
       friend bool operator< (const string& lhs, const string& rhs);
@@ -61,12 +61,14 @@ namespace eosio {
          if( str.size() > 7 ) {
             eosio::check( false, "string is too long to be a valid symbol_code" );
          }
+         bool invalid = false;
          for( auto itr = str.rbegin(); itr != str.rend(); ++itr ) {
-            if( *itr < 'A' || *itr > 'Z') {
-               eosio::check( false, "only uppercase letters allowed in symbol_code string" );
-            }
+            invalid |= static_cast<uint8_t>(*itr - 'A') > ('Z' - 'A');
             value <<= 8;
-            value |= *itr;
+            value |= static_cast<uint8_t>(*itr);
+         }
+         if( invalid ) {
+            eosio::check( false, "only uppercase letters allowed in symbol_code string" );
          }
       }
 
@@ -97,13 +99,13 @@ namespace eosio {
        * @return length - character length of the provided symbol
        */
       constexpr uint32_t length()const {
-         auto sym = value;
-         uint32_t len = 0;
-         while (sym & 0xFF && len <= 7) {
-            len++;
-            sym >>= 8;
-         }
-         return len;
+         // the lowest zero byte terminates the code; bytes above it cannot produce a false positive below it
+         constexpr uint64_t lows  = 0x0101010101010101ull;
+         constexpr uint64_t highs = 0x8080808080808080ull;
+         const uint64_t zero_bytes = (value - lows) & ~value & highs;
+         if( zero_bytes == 0 )
+            return 8;
+         return static_cast<uint32_t>(__builtin_ctzll(zero_bytes) / 8);
       }
 
       /**
@@ -136,20 +138,16 @@ namespace eosio {
       char* write_as_string( char* begin, char* end, bool dry_run = false )const {
          constexpr uint64_t mask = 0xFFull;
 
-         if( dry_run || (begin + 7 < begin) || (begin + 7 > end) ) {
-            char* actual_end = begin + length();
-            if( dry_run || (actual_end < begin) || (actual_end > end) ) return actual_end;
-         }
+         const uint32_t len = std::min( length(), 7u );
+         char* actual_end = begin + len;
+         if( dry_run || (actual_end < begin) || (actual_end > end) ) return actual_end;
 
          auto v = value;
-         for( auto i = 0; i < 7; ++i, v >>= 8 ) {
-            if( v == 0 ) return begin;
-
-            *begin = static_cast<char>(v & mask);
-            ++begin;
+         for( uint32_t i = 0; i < len; ++i, v >>= 8 ) {
+            *begin++ = static_cast<char>(v & mask);
          }
 
-         return begin;
+         return actual_end;
       }
 
       /**
@@ -452,4 +450,46 @@ namespace eosio {
 
       EOSLIB_SERIALIZE( extended_symbol, (sym)(contract) )
    };
+
+   namespace detail {
+      /**
+       * Parses a symbol of the form "4,EOS", its precision of at most 18 then its code
+       */
+      constexpr symbol parse_symbol( std::string_view str ) {
+         const auto comma = str.find( ',' );
+         if( comma == std::string_view::npos || comma == 0 || comma > 2 )
+            eosio::check( false, "symbol must be a precision of at most 18 and a code separated by a comma" );
+         uint8_t precision = 0;
+         for( size_t i = 0; i < comma; ++i ) {
+            if( static_cast<uint8_t>(str[i] - '0') > 9 )
+               eosio::check( false, "precision of symbol must be a number" );
+            precision = precision * 10 + (str[i] - '0');
+         }
+         if( precision > 18 )
+            eosio::check( false, "precision of symbol must be at most 18" );
+         const symbol_code code{ str.substr( comma + 1 ) };
+         if( !code.is_valid() )
+            eosio::check( false, "invalid symbol_code" );
+         return symbol{ code, precision };
+      }
+   } /// namespace detail
 }
+
+/// @cond IMPLEMENTATIONS
+
+/**
+ * %symbol literal operator
+ *
+ * @ingroup symbol
+ * @brief "4,EOS"_sym is a shortcut for symbol("EOS", 4), validated at compile time
+ */
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wgnu-string-literal-operator-template"
+template <typename T, T... Str>
+inline constexpr eosio::symbol operator""_sym() {
+   constexpr auto x = eosio::detail::parse_symbol(std::string_view{eosio::detail::to_const_char_arr<Str...>::value, sizeof...(Str)});
+   return x;
+}
+#pragma clang diagnostic pop
+
+/// @endcond
@@ -50,85 +50,210 @@ namespace eosio {
       ::assert_sha256( data, length, reinterpret_cast<const ::capi_checksum256*>(hash_data.data()) );
    }
 
+   void assert_sha256( const char* data, uint32_t length, const eosio::byte_checksum256& hash ) {
+      ::assert_sha256( data, length, reinterpret_cast<const ::capi_checksum256*>(hash.data()) );
+   }
+
    void assert_sha1( const char* data, uint32_t length, const eosio::checksum160& hash ) {
       auto hash_data = hash.extract_as_byte_array();
       ::assert_sha1( data, length, reinterpret_cast<const ::capi_checksum160*>(hash_data.data()) );
    }
 
+   void assert_sha1( const char* data, uint32_t length, const eosio::byte_checksum160& hash ) {
+      ::assert_sha1( data, length, reinterpret_cast<const ::capi_checksum160*>(hash.data()) );
+   }
+
    void assert_sha512( const char* data, uint32_t length, const eosio::checksum512& hash ) {
       auto hash_data = hash.extract_as_byte_array();
       ::assert_sha512( data, length, reinterpret_cast<const ::capi_checksum512*>(hash_data.data()) );
    }
 
+   void assert_sha512( const char* data, uint32_t length, const eosio::byte_checksum512& hash ) {
+      ::assert_sha512( data, length, reinterpret_cast<const ::capi_checksum512*>(hash.data()) );
+   }
+
    void assert_ripemd160( const char* data, uint32_t length, const eosio::checksum160& hash ) {
       auto hash_data = hash.extract_as_byte_array();
       ::assert_ripemd160( data, length, reinterpret_cast<const ::capi_checksum160*>(hash_data.data()) );
    }
 
+   void assert_ripemd160( const char* data, uint32_t length, const eosio::byte_checksum160& hash ) {
+      ::assert_ripemd160( data, length, reinterpret_cast<const ::capi_checksum160*>(hash.data()) );
+   }
+
    eosio::checksum256 sha256( const char* data, uint32_t length ) {
       ::capi_checksum256 hash;
       ::sha256( data, length, &hash );
       return {hash.hash};
    }
 
+   eosio::byte_checksum256 sha256_bytes( const char* data, uint32_t length ) {
+      eosio::byte_checksum256 hash;
+      ::sha256( data, length, reinterpret_cast<::capi_checksum256*>(hash.data()) );
+      return hash;
+   }
+
    eosio::checksum160 sha1( const char* data, uint32_t length ) {
       ::capi_checksum160 hash;
       ::sha1( data, length, &hash );
       return {hash.hash};
    }
 
+   eosio::byte_checksum160 sha1_bytes( const char* data, uint32_t length ) {
+      eosio::byte_checksum160 hash;
+      ::sha1( data, length, reinterpret_cast<::capi_checksum160*>(hash.data()) );
+      return hash;
+   }
+
    eosio::checksum512 sha512( const char* data, uint32_t length ) {
       ::capi_checksum512 hash;
       ::sha512( data, length, &hash );
       return {hash.hash};
    }
 
+   eosio::byte_checksum512 sha512_bytes( const char* data, uint32_t length ) {
+      eosio::byte_checksum512 hash;
+      ::sha512( data, length, reinterpret_cast<::capi_checksum512*>(hash.data()) );
+      return hash;
+   }
+
    eosio::checksum160 ripemd160( const char* data, uint32_t length ) {
       ::capi_checksum160 hash;
       ::ripemd160( data, length, &hash );
       return {hash.hash};
    }
 
-   eosio::public_key recover_key( const eosio::checksum256& digest, const eosio::signature& sig ) {
-      auto digest_data = digest.extract_as_byte_array();
-
-      auto sig_data = eosio::pack(sig);
-
-      char optimistic_pubkey_data[256];
-      size_t pubkey_size = ::recover_key( reinterpret_cast<const capi_checksum256*>(digest_data.data()),
-                                          sig_data.data(), sig_data.size(),
-                                          optimistic_pubkey_data, sizeof(optimistic_pubkey_data) );
-
-      eosio::public_key pubkey;
-      if ( pubkey_size <= sizeof(optimistic_pubkey_data) ) {
-         eosio::datastream<const char*> pubkey_ds( optimistic_pubkey_data, pubkey_size );
-         pubkey_ds >> pubkey;
-      } else {
-         constexpr static size_t max_stack_buffer_size = 512;
-         void* pubkey_data = (max_stack_buffer_size < pubkey_size) ? malloc(pubkey_size) : alloca(pubkey_size);
-
-         ::recover_key( reinterpret_cast<const capi_checksum256*>(digest_data.data()),
-                        sig_data.data(), sig_data.size(),
-                        reinterpret_cast<char*>(pubkey_data), pubkey_size );
-         eosio::datastream<const char*> pubkey_ds( reinterpret_cast<const char*>(pubkey_data), pubkey_size );
-         pubkey_ds >> pubkey;
-
-         if( max_stack_buffer_size < pubkey_size ) {
-            free(pubkey_data);
+   eosio::byte_checksum160 ripemd160_bytes( const char* data, uint32_t length ) {
+      eosio::byte_checksum160 hash;
+      ::ripemd160( data, length, reinterpret_cast<::capi_checksum160*>(hash.data()) );
+      return hash;
+   }
+
+   namespace {
+      /**
+       *  Packs crypto variants into fixed stack storage sized by the largest K1/R1 encoding,
+       *  only spilling to the heap for oversized (e.g. WebAuthN) values. A heap spill is kept
+       *  and reused by later calls on the same scratch object.
+       */
+      template<size_t StackSize>
+      class packed_scratch {
+         public:
+            packed_scratch() = default;
+            packed_scratch( const packed_scratch& ) = delete;
+            packed_scratch& operator=( const packed_scratch& ) = delete;
+
+            ~packed_scratch() {
+               if( _heap_data )
+                  free( _heap_data );
+            }
+
+            template<typename T>
+            size_t pack( const T& value ) {
+               size_t size = eosio::pack_size( value );
+               _data = _stack_data;
+               if( StackSize < size ) {
+                  if( _heap_size < size ) {
+                     _heap_data = reinterpret_cast<char*>(realloc( _heap_data, size ));
+                     _heap_size = size;
+                  }
+                  _data = _heap_data;
+               }
+               eosio::datastream<char*> ds( _data, size );
+               ds << value;
+               return size;
+            }
+
+            const char* data()const { return _data; }
+            char* data() { return _data; }
+
+         private:
+            char   _stack_data[StackSize];
+            char*  _data      = _stack_data;
+            char*  _heap_data = nullptr;
+            size_t _heap_size = 0;
+      };
+
+      // variant index byte followed by the compact K1/R1 encoding
+      constexpr size_t max_ecc_signature_size  = 1 + std::tuple_size<eosio::ecc_signature>::value;
+      constexpr size_t max_ecc_public_key_size = 1 + std::tuple_size<eosio::ecc_public_key>::value;
+
+      using signature_scratch  = packed_scratch<max_ecc_signature_size>;
+      using public_key_scratch = packed_scratch<max_ecc_public_key_size>;
+
+      eosio::public_key recover_key_impl( const capi_checksum256* digest, const eosio::signature& sig, signature_scratch& sig_scratch ) {
+         size_t sig_size = sig_scratch.pack( sig );
+
+         char optimistic_pubkey_data[256];
+         size_t pubkey_size = ::recover_key( digest,
+                                             sig_scratch.data(), sig_size,
+                                             optimistic_pubkey_data, sizeof(optimistic_pubkey_data) );
+
+         eosio::public_key pubkey;
+         if ( pubkey_size <= sizeof(optimistic_pubkey_data) ) {
+            eosio::datastream<const char*> pubkey_ds( optimistic_pubkey_data, pubkey_size );
+            pubkey_ds >> pubkey;
+         } else {
+            constexpr static size_t max_stack_buffer_size = 512;
+            void* pubkey_data = (max_stack_buffer_size < pubkey_size) ? malloc(pubkey_size) : alloca(pubkey_size);
+
+            ::recover_key( digest,
+                           sig_scratch.data(), sig_size,
+                           reinterpret_cast<char*>(pubkey_data), pubkey_size );
+            eosio::datastream<const char*> pubkey_ds( reinterpret_cast<const char*>(pubkey_data), pubkey_size );
+            pubkey_ds >> pubkey;
+
+            if( max_stack_buffer_size < pubkey_size ) {
+               free(pubkey_data);
+            }
          }
+         return pubkey;
+      }
+
+      void assert_recover_key_impl( const capi_checksum256* digest, const eosio::signature& sig, const eosio::public_key& pubkey,
+                                    signature_scratch& sig_scratch, public_key_scratch& pubkey_scratch ) {
+         size_t sig_size    = sig_scratch.pack( sig );
+         size_t pubkey_size = pubkey_scratch.pack( pubkey );
+
+         ::assert_recover_key( digest,
+                               sig_scratch.data(), sig_size,
+                               pubkey_scratch.data(), pubkey_size );
       }
-      return pubkey;
+   }
+
+   eosio::public_key recover_key( const eosio::checksum256& digest, const eosio::signature& sig ) {
+      return recover_key( eosio::byte_checksum256( digest ), sig );
+   }
+
+   eosio::public_key recover_key( const eosio::byte_checksum256& digest, const eosio::signature& sig ) {
+      signature_scratch sig_scratch;
+      return recover_key_impl( reinterpret_cast<const capi_checksum256*>(digest.data()), sig, sig_scratch );
    }
 
    void assert_recover_key( const eosio::checksum256& digest, const eosio::signature& sig, const eosio::public_key& pubkey ) {
-      auto digest_data = digest.extract_as_byte_array();
+      assert_recover_key( eosio::byte_checksum256( digest ), sig, pubkey );
+   }
 
-      auto sig_data = eosio::pack(sig);
-      auto pubkey_data = eosio::pack(pubkey);
+   void assert_recover_key( const eosio::byte_checksum256& digest, const eosio::signature& sig, const eosio::public_key& pubkey ) {
+      signature_scratch  sig_scratch;
+      public_key_scratch pubkey_scratch;
+      assert_recover_key_impl( reinterpret_cast<const capi_checksum256*>(digest.data()), sig, pubkey, sig_scratch, pubkey_scratch );
+   }
 
-      ::assert_recover_key( reinterpret_cast<const capi_checksum256*>(digest_data.data()),
-                            sig_data.data(), sig_data.size(),
-                            pubkey_data.data(), pubkey_data.size() );
+   void recover_keys( const eosio::checksum256* digests, const eosio::signature* sigs, eosio::public_key* pubkeys, size_t count ) {
+      signature_scratch sig_scratch;
+      for( size_t i = 0; i < count; ++i ) {
+         eosio::byte_checksum256 digest( digests[i] );
+         pubkeys[i] = recover_key_impl( reinterpret_cast<const capi_checksum256*>(digest.data()), sigs[i], sig_scratch );
+      }
+   }
+
+   void assert_recover_keys( const eosio::checksum256* digests, const eosio::signature* sigs, const eosio::public_key* pubkeys, size_t count ) {
+      signature_scratch  sig_scratch;
+      public_key_scratch pubkey_scratch;
+      for( size_t i = 0; i < count; ++i ) {
+         eosio::byte_checksum256 digest( digests[i] );
+         assert_recover_key_impl( reinterpret_cast<const capi_checksum256*>(digest.data()), sigs[i], pubkeys[i], sig_scratch, pubkey_scratch );
+      }
    }
 
 }
@@ -2,6 +2,7 @@
 #include <alloca.h>
 #include "core/eosio/check.hpp"
 #include "core/eosio/print.hpp"
+#include "malloc_trace.hpp"
 
 #ifdef EOSIO_NATIVE
    extern "C" {
@@ -43,6 +44,7 @@ namespace eosio {
          if(num_desired_pages > current_pages) {
             if (GROW_MEMORY(num_desired_pages - current_pages) == -1)
                return reinterpret_cast<void*>(-1);
+            malloc_trace::record(malloc_trace::grow_event, current_pages, num_desired_pages, 0, nullptr);
          }
 
          sbrk_bytes += num_bytes;
@@ -526,20 +528,26 @@ namespace eosio {
 
 extern "C" {
 void* malloc(size_t size) {
-   return eosio::memory_heap.malloc(size);
+   void* ret = eosio::memory_heap.malloc(size);
+   eosio::malloc_trace::record(eosio::malloc_trace::malloc_event, (uintptr_t)ret, size, 0, EOSIO_MALLOC_TRACE_SITE);
+   return ret;
 }
 
 void* calloc(size_t count, size_t size) {
    void* ptr = eosio::memory_heap.malloc(count*size);
+   eosio::malloc_trace::record(eosio::malloc_trace::malloc_event, (uintptr_t)ptr, count*size, 0, EOSIO_MALLOC_TRACE_SITE);
    memset(ptr, 0, count*size);
    return ptr;
 }
 
 void* realloc(void* ptr, size_t size) {
-   return eosio::memory_heap.realloc(ptr, size);
+   void* ret = eosio::memory_heap.realloc(ptr, size);
+   eosio::malloc_trace::record(eosio::malloc_trace::realloc_event, (uintptr_t)ret, size, (uintptr_t)ptr, EOSIO_MALLOC_TRACE_SITE);
+   return ret;
 }
 
 void free(void* ptr) {
+   eosio::malloc_trace::record(eosio::malloc_trace::free_event, (uintptr_t)ptr, 0, 0, EOSIO_MALLOC_TRACE_SITE);
    return eosio::memory_heap.free(ptr);
 }
 }
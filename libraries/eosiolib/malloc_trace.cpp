@@ -0,0 +1,57 @@
+#include "malloc_trace.hpp"
+
+#ifdef EOSIO_NATIVE
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+namespace eosio { namespace malloc_trace {
+#ifdef EOSIO_NATIVE
+   static FILE* trace_file() {
+      static FILE* file;
+      if (!file) {
+         const char* name = getenv("EOSIO_MALLOC_TRACE");
+         file = fopen(name ? name : "malloc.trace", "w");
+      }
+      return file;
+   }
+
+   void record( event e, uintptr_t a, uintptr_t b, uintptr_t c, const void* site ) {
+      // stdio allocates with the traced malloc itself
+      static bool recording;
+      if (recording)
+         return;
+      recording = true;
+      FILE* file = trace_file();
+      if (!file) {
+         recording = false;
+         return;
+      }
+      switch (e) {
+         case malloc_event:
+            fprintf(file, "malloc %lu %lu %p\n", (unsigned long)a, (unsigned long)b, site);
+            break;
+         case free_event:
+            fprintf(file, "free %lu %p\n", (unsigned long)a, site);
+            break;
+         case realloc_event:
+            fprintf(file, "realloc %lu %lu %lu %p\n", (unsigned long)c, (unsigned long)a, (unsigned long)b, site);
+            break;
+         case grow_event:
+            fprintf(file, "grow %lu %lu %p\n", (unsigned long)a, (unsigned long)b, site);
+            break;
+      }
+      fflush(file);
+      recording = false;
+   }
+#else
+   extern "C" {
+      __attribute__((eosio_wasm_import))
+      void trace_alloc( uint32_t event, uint32_t a, uint32_t b, uint32_t c );
+   }
+
+   void record( event e, uintptr_t a, uintptr_t b, uintptr_t c, const void* ) {
+      trace_alloc(e, a, b, c);
+   }
+#endif
+}} // ns eosio::malloc_trace
@@ -0,0 +1,38 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Allocation tracing of the eosio allocators. The tracing variants of the
+ * allocator libraries (eosio_malloc_trace, eosio_dsm_trace and
+ * native_eosio_malloc_trace, linked with -fmalloc-trace) are built with
+ * EOSIO_MALLOC_TRACE and record every malloc, free, realloc and memory growth.
+ * In WebAssembly the events go to the trace_alloc intrinsic provided by
+ * eosio-run; in native mode they are written to the file named by the
+ * EOSIO_MALLOC_TRACE environment variable, malloc.trace by default.
+ * eosio-malloc-report summarizes either.
+ */
+namespace eosio { namespace malloc_trace {
+   enum event : uint32_t {
+      malloc_event  = 0, // ptr, size
+      free_event    = 1, // ptr
+      realloc_event = 2, // new ptr, size, old ptr
+      grow_event    = 3  // pages before, pages after
+   };
+
+#ifdef EOSIO_MALLOC_TRACE
+   /**
+    * Records an event. site is the return address of the allocator function,
+    * only known in native mode: in WebAssembly the host names the caller.
+    */
+   void record( event e, uintptr_t a, uintptr_t b, uintptr_t c, const void* site );
+#else
+   inline void record( event, uintptr_t, uintptr_t, uintptr_t, const void* ) {}
+#endif
+}} // ns eosio::malloc_trace
+
+#if defined(EOSIO_MALLOC_TRACE) && defined(EOSIO_NATIVE)
+#define EOSIO_MALLOC_TRACE_SITE __builtin_return_address(0)
+#else
+#define EOSIO_MALLOC_TRACE_SITE nullptr
+#endif
@@ -1,5 +1,6 @@
 #include <memory>
 #include "core/eosio/check.hpp"
+#include "malloc_trace.hpp"
 
 #ifdef EOSIO_NATIVE
    extern "C" {
@@ -46,7 +47,10 @@ namespace eosio {
             next_page++;
             pages_to_alloc++;
          }         
-         eosio::check(GROW_MEMORY(pages_to_alloc) != -1, "failed to allocate pages");  
+         size_t pages = GROW_MEMORY(pages_to_alloc);
+         eosio::check(pages != -1, "failed to allocate pages");
+         if (pages_to_alloc)
+            malloc_trace::record(malloc_trace::grow_event, pages, pages + pages_to_alloc, 0, nullptr);
          return ret;
       }
 
@@ -62,12 +66,14 @@ extern "C" {
 
 void* malloc(size_t size) {
    void* ret = eosio::_dsmalloc(size);
+   eosio::malloc_trace::record(eosio::malloc_trace::malloc_event, (uintptr_t)ret, size, 0, EOSIO_MALLOC_TRACE_SITE);
    return ret;
 }
 
 void* memset(void*,int,size_t);
 void* calloc(size_t count, size_t size) {
    if (void* ptr = eosio::_dsmalloc(count*size)) {
+      eosio::malloc_trace::record(eosio::malloc_trace::malloc_event, (uintptr_t)ptr, count*size, 0, EOSIO_MALLOC_TRACE_SITE);
       memset(ptr, 0, count*size);
       return ptr;
    }
@@ -75,9 +81,13 @@ void* calloc(size_t count, size_t size) {
 }
 
 void* realloc(void* ptr, size_t size) {
-   return eosio::_dsmalloc(size);
+   void* ret = eosio::_dsmalloc(size);
+   eosio::malloc_trace::record(eosio::malloc_trace::realloc_event, (uintptr_t)ret, size, (uintptr_t)ptr, EOSIO_MALLOC_TRACE_SITE);
+   return ret;
 }
 
-void free(void* ptr) {}
+void free(void* ptr) {
+   eosio::malloc_trace::record(eosio::malloc_trace::free_event, (uintptr_t)ptr, 0, 0, EOSIO_MALLOC_TRACE_SITE);
+}
 }
 
@@ -3,6 +3,133 @@
 
 static constexpr uint32_t SHIFT_WIDTH = (sizeof(uint64_t)*8)-1;
 
+// 128-bit division and multiplication work on the 64-bit halves of their
+// operands, which wasm (and the native targets) divide and multiply in
+// hardware: rebuilding them into __int128 would call back into these builtins.
+// The common shapes, both operands under 2^64 or a divisor under 2^64, take a
+// single 64-bit division or a 128/64 long division. A zero divisor traps in
+// the 64-bit division.
+namespace {
+   struct u128 {
+      uint64_t lo;
+      uint64_t hi;
+   };
+
+   inline bool is_negative( u128 a ) { return a.hi >> SHIFT_WIDTH; }
+
+   inline u128 negate( u128 a ) { return { 0 - a.lo, ~a.hi + (a.lo == 0) }; }
+
+   inline bool less( u128 a, u128 b ) { return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo); }
+
+   inline u128 sub( u128 a, u128 b ) { return { a.lo - b.lo, a.hi - b.hi - (a.lo < b.lo) }; }
+
+   // 64x64->128 multiplication on 32-bit halves
+   inline u128 mul64x64( uint64_t a, uint64_t b ) {
+      if (((a | b) >> 32) == 0)
+         return { a * b, 0 };
+      uint64_t a0 = (uint32_t)a, a1 = a >> 32;
+      uint64_t b0 = (uint32_t)b, b1 = b >> 32;
+      uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+      uint64_t mid = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+      return { (mid << 32) | (uint32_t)p00, p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32) };
+   }
+
+   // (hi:lo) / d for hi < d, the remainder in rem: long division on 32-bit
+   // digits of the divisor normalized to its top bit (Hacker's Delight, divlu)
+   inline uint64_t div128by64( uint64_t hi, uint64_t lo, uint64_t d, uint64_t& rem ) {
+      constexpr uint64_t base = 1ull << 32;
+      const unsigned s = __builtin_clzll(d);
+      d <<= s;
+      const uint64_t dn1 = d >> 32, dn0 = (uint32_t)d;
+      const uint64_t un32 = s ? (hi << s) | (lo >> (64 - s)) : hi;
+      const uint64_t un10 = lo << s;
+      const uint64_t un1 = un10 >> 32, un0 = (uint32_t)un10;
+
+      uint64_t q1 = un32 / dn1, rhat = un32 - q1 * dn1;
+      while (q1 >= base || q1 * dn0 > base * rhat + un1) {
+         --q1;
+         rhat += dn1;
+         if (rhat >= base)
+            break;
+      }
+      const uint64_t un21 = un32 * base + un1 - q1 * d;
+
+      uint64_t q0 = un21 / dn1;
+      rhat = un21 - q0 * dn1;
+      while (q0 >= base || q0 * dn0 > base * rhat + un0) {
+         --q0;
+         rhat += dn1;
+         if (rhat >= base)
+            break;
+      }
+      rem = (un21 * base + un0 - q0 * d) >> s;
+      return q1 * base + q0;
+   }
+
+   inline void udivmod128( u128 a, u128 b, u128& q, u128& r ) {
+      if (b.hi == 0) {
+         r.hi = 0;
+         if (a.hi == 0) {
+            q = { a.lo / b.lo, 0 };
+            r.lo = a.lo % b.lo;
+         } else if (a.hi < b.lo) {
+            q = { div128by64(a.hi, a.lo, b.lo, r.lo), 0 };
+         } else {
+            q.hi = a.hi / b.lo;
+            q.lo = div128by64(a.hi % b.lo, a.lo, b.lo, r.lo);
+         }
+         return;
+      }
+      if (less(a, b)) {
+         q = { 0, 0 };
+         r = a;
+         return;
+      }
+      // b >= 2^64, so the quotient fits in 64 bits: divide a/2 by the top 64
+      // bits of the normalized divisor, which gives the quotient or one more
+      // than it once undone, then correct (Hacker's Delight, divlu64)
+      const unsigned s = __builtin_clzll(b.hi);
+      const uint64_t v1 = s ? (b.hi << s) | (b.lo >> (64 - s)) : b.hi;
+      uint64_t ignored;
+      uint64_t q0 = div128by64(a.hi >> 1, (a.hi << SHIFT_WIDTH) | (a.lo >> 1), v1, ignored) >> (SHIFT_WIDTH - s);
+      if (q0 != 0)
+         --q0;
+      u128 qb = mul64x64(q0, b.lo);
+      qb.hi += q0 * b.hi;
+      r = sub(a, qb);
+      if (!less(r, b)) {
+         ++q0;
+         r = sub(r, b);
+      }
+      q = { q0, 0 };
+   }
+
+   inline u128 mul128( u128 a, u128 b ) {
+      u128 p = mul64x64(a.lo, b.lo);
+      p.hi += a.lo * b.hi + a.hi * b.lo;
+      return p;
+   }
+
+   // both halves hold a sign extended 64-bit value
+   inline bool fits_int64( uint64_t lo, uint64_t hi ) { return hi == (uint64_t)((int64_t)lo >> SHIFT_WIDTH); }
+
+   inline unsigned __int128 to_uint128( u128 a ) {
+      unsigned __int128 ret = a.hi;
+      ret <<= 64;
+      ret |= a.lo;
+      return ret;
+   }
+
+   inline void sdivmod128( u128 a, u128 b, u128& q, u128& r ) {
+      const bool negative_a = is_negative(a), negative_b = is_negative(b);
+      udivmod128(negative_a ? negate(a) : a, negative_b ? negate(b) : b, q, r);
+      if (negative_a != negative_b)
+         q = negate(q);
+      if (negative_a)
+         r = negate(r);
+   }
+} // namespace anonymous
+
 extern "C" {
 void eosio_assert(int32_t, const char*);
 void __ashlti3(__int128& ret, uint64_t low, uint64_t high, uint32_t shift) {
@@ -38,82 +165,56 @@ void __lshrti3(__int128& ret, uint64_t low, uint64_t high, uint32_t shift) {
 }
 
 void __divti3(__int128& ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
-   __int128 lhs = ha;
-   __int128 rhs = hb;
-
-   lhs <<= 64;
-   lhs |=  la;
-
-   rhs <<= 64;
-   rhs |=  lb;
-   //if ( rhs == 0 )
-   //   eosio_assert(false, "divide by zero");
-
-   lhs /= rhs;
-
-   ret = lhs;
+   if (fits_int64(la, ha) && fits_int64(lb, hb) && !((int64_t)la == INT64_MIN && (int64_t)lb == -1)) {
+      ret = (int64_t)la / (int64_t)lb;
+      return;
+   }
+   u128 q, r;
+   sdivmod128({ la, ha }, { lb, hb }, q, r);
+   ret = to_uint128(q);
 }
 
 void __udivti3(unsigned __int128& ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
-   unsigned __int128 lhs = ha;
-   unsigned __int128 rhs = hb;
-
-   lhs <<= 64;
-   lhs |=  la;
-
-   rhs <<= 64;
-   rhs |=  lb;
-   //if ( rhs == 0 )
-   //   eosio_assert(false, "divide by zero");
-
-   lhs /= rhs;
-   ret = lhs;
+   u128 q, r;
+   udivmod128({ la, ha }, { lb, hb }, q, r);
+   ret = to_uint128(q);
 }
 
 void __multi3(__int128& ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
-   __int128 lhs = ha;
-   __int128 rhs = hb;
-
-   lhs <<= 64;
-   lhs |=  la;
-
-   rhs <<= 64;
-   rhs |=  lb;
-
-   lhs *= rhs;
-   ret = lhs;
+   ret = to_uint128(mul128({ la, ha }, { lb, hb }));
 }
 
 void __modti3(__int128& ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
-   __int128 lhs = ha;
-   __int128 rhs = hb;
-
-   lhs <<= 64;
-   lhs |=  la;
-
-   rhs <<= 64;
-   rhs |=  lb;
-   //if ( rhs == 0 )
-   //   eosio_assert(false, "divide by zero");
-
-   lhs %= rhs;
-   ret = lhs;
+   if (fits_int64(la, ha) && fits_int64(lb, hb) && (int64_t)lb != -1) {
+      ret = (int64_t)la % (int64_t)lb;
+      return;
+   }
+   u128 q, r;
+   sdivmod128({ la, ha }, { lb, hb }, q, r);
+   ret = to_uint128(r);
 }
 
 void __umodti3(unsigned __int128& ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
-   unsigned __int128 lhs = ha;
-   unsigned __int128 rhs = hb;
-
-   lhs <<= 64;
-   lhs |=  la;
+   u128 q, r;
+   udivmod128({ la, ha }, { lb, hb }, q, r);
+   ret = to_uint128(r);
+}
 
-   rhs <<= 64;
-   rhs |=  lb;
-   //if ( rhs == 0 )
-   //   eosio_assert(false, "divide by zero");
+// quotient and remainder at once, as in compiler-rt
+void __udivmodti4(unsigned __int128& ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb, unsigned __int128* rem) {
+   u128 q, r;
+   udivmod128({ la, ha }, { lb, hb }, q, r);
+   if (rem)
+      *rem = to_uint128(r);
+   ret = to_uint128(q);
+}
 
-   lhs %= rhs;
-   ret = lhs;
+void __divmodti4(__int128& ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb, __int128* rem) {
+   u128 q, r;
+   sdivmod128({ la, ha }, { lb, hb }, q, r);
+   if (rem)
+      *rem = to_uint128(r);
+   ret = to_uint128(q);
 }
 
 // arithmetic long double
@@ -67,6 +67,10 @@ eosio_clang_install(clang-7)
 eosio_clang_install(wasm-ld)
 
 eosio_tool_install_and_symlink(eosio-pp eosio-pp)
+eosio_tool_install_and_symlink(eosio-run eosio-run)
+eosio_tool_install_and_symlink(eosio-aot eosio-aot)
+eosio_tool_install_and_symlink(eosio-size eosio-size)
+eosio_tool_install_and_symlink(eosio-malloc-report eosio-malloc-report)
 eosio_tool_install_and_symlink(eosio-wast2wasm eosio-wast2wasm)
 eosio_tool_install_and_symlink(eosio-wasm2wast eosio-wasm2wast)
 eosio_tool_install_and_symlink(eosio-cc eosio-cc)
@@ -76,6 +80,8 @@ eosio_tool_install_and_symlink(eosio-abigen eosio-abigen)
 eosio_tool_install_and_symlink(eosio-abidiff eosio-abidiff)
 eosio_tool_install_and_symlink(eosio-init eosio-init)
 
+add_custom_command( TARGET EosioTools POST_BUILD COMMAND ${CMAKE_COMMAND} -E copy_directory ${CMAKE_BINARY_DIR}/tools/lib/eosio-aot ${CMAKE_BINARY_DIR}/lib/eosio-aot )
+
 eosio_clang_install(../lib/LLVMEosioApply${CMAKE_SHARED_LIBRARY_SUFFIX})
 eosio_clang_install(../lib/LLVMEosioSoftfloat${CMAKE_SHARED_LIBRARY_SUFFIX})
 eosio_clang_install(../lib/eosio_plugin${CMAKE_SHARED_LIBRARY_SUFFIX})
@@ -11,6 +11,10 @@ binaries=(
    eosio-wasm2wast
    eosio-wast2wasm
    eosio-pp
+   eosio-run
+   eosio-aot
+   eosio-size
+   eosio-malloc-report
    eosio-cc
    eosio-cpp
    eosio-ld
@@ -33,6 +33,7 @@ cp -R ${BUILD_DIR}/include/* ${CDT_PREFIX}/include || exit 1
 
 # install wasm libs
 cp ${BUILD_DIR}/lib/*.a ${CDT_PREFIX}/lib || exit 1
+cp -R ${BUILD_DIR}/lib/eosio-aot ${CDT_PREFIX}/lib || exit 1
 
 # make symlinks
 pushd ${PREFIX}/lib/cmake/${PROJECT} &> /dev/null
@@ -49,6 +50,10 @@ create_symlink eosio-cc eosio-cc
 create_symlink eosio-cpp eosio-cpp
 create_symlink eosio-ld eosio-ld
 create_symlink eosio-pp eosio-pp
+create_symlink eosio-run eosio-run
+create_symlink eosio-aot eosio-aot
+create_symlink eosio-size eosio-size
+create_symlink eosio-malloc-report eosio-malloc-report
 create_symlink eosio-init eosio-init
 create_symlink eosio-abigen eosio-abigen
 create_symlink eosio-wasm2wast eosio-wasm2wast
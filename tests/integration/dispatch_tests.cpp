@@ -0,0 +1,87 @@
+#include <boost/test/unit_test.hpp>
+#include <eosio/testing/tester.hpp>
+#include <eosio/chain/abi_serializer.hpp>
+
+#include <Runtime/Runtime.h>
+
+#include <fc/variant_object.hpp>
+
+#include <contracts.hpp>
+
+using namespace eosio;
+using namespace eosio::testing;
+using namespace eosio::chain;
+using namespace eosio::testing;
+using namespace fc;
+
+using mvo = fc::mutable_variant_object;
+
+BOOST_AUTO_TEST_SUITE(dispatch_tests)
+
+// eosio-pp rebuilds the dispatcher of apply into a search over the action names, run every
+// action and notification handler of a 256 action contract to check each one still fires
+struct dispatch_tester : tester {
+   void check_dispatch( const std::vector<uint8_t>& dispatch_wasm, const std::vector<uint8_t>& transfer_wasm ) {
+      create_accounts( { N(test), N(eosio.token), N(someone) } );
+      produce_block();
+
+      set_code( N(test), dispatch_wasm );
+      set_abi( N(test),  contracts::dispatch_abi().data() );
+
+      set_code( N(eosio.token), transfer_wasm );
+      set_abi(  N(eosio.token),  contracts::transfer_abi().data() );
+
+      set_code( N(someone), transfer_wasm );
+      set_abi(  N(someone),  contracts::transfer_abi().data() );
+
+      produce_blocks();
+
+      for( char p = 'a'; p <= 'p'; ++p ) {
+         for( char c = 'a'; c <= 'p'; ++c ) {
+            const std::string act{ 'x', p, c };
+            auto trace = push_action( N(test), name(act), N(test), mvo() );
+            BOOST_REQUIRE_EQUAL( trace->action_traces.size(), 1 );
+            BOOST_CHECK_EQUAL( trace->action_traces[0].console, act );
+         }
+         produce_block();
+      }
+
+      auto trace = push_action( N(eosio.token), N(transfer), N(test),
+            mvo()
+            ("from", "test")
+            ("to", "someone")
+            ("quantity", "1.0000 TST")
+            ("memo", ""));
+      BOOST_REQUIRE_EQUAL( trace->action_traces[0].inline_traces.size(), 1 );
+      BOOST_CHECK_EQUAL( trace->action_traces[0].inline_traces[0].console, "transfer" );
+
+      trace = push_action( N(someone), N(transfer), N(test),
+            mvo()
+            ("from", "test")
+            ("to", "someone")
+            ("quantity", "1.0000 TST")
+            ("memo", ""));
+      BOOST_REQUIRE_EQUAL( trace->action_traces[0].inline_traces.size(), 1 );
+      BOOST_CHECK_EQUAL( trace->action_traces[0].inline_traces[0].console, "any transfer" );
+
+      // notifications without a handler are ignored
+      trace = push_action( N(eosio.token), N(transfer2), N(test),
+            mvo()
+            ("from", "test")
+            ("to", "someone")
+            ("quantity", "1.0000 TST")
+            ("memo", ""));
+      BOOST_REQUIRE_EQUAL( trace->action_traces[0].inline_traces.size(), 1 );
+      BOOST_CHECK_EQUAL( trace->action_traces[0].inline_traces[0].console, "" );
+   }
+};
+
+BOOST_FIXTURE_TEST_CASE( search_dispatch_tests, dispatch_tester ) try {
+   check_dispatch( contracts::dispatch_wasm(), contracts::transfer_wasm() );
+} FC_LOG_AND_RETHROW()
+
+// the same contracts linked with -post-pass-opt=2, through the dead function elimination, duplicate
+// function folding, local coalescing and constant global propagation of eosio-pp
+BOOST_FIXTURE_TEST_CASE( optimized_dispatch_tests, dispatch_tester ) try {
+   check_dispatch( contracts::dispatch_opt_wasm(), contracts::transfer_opt_wasm() );
+} FC_LOG_AND_RETHROW() }
@@ -0,0 +1,71 @@
+#include <boost/test/unit_test.hpp>
+#include <eosio/testing/tester.hpp>
+#include <eosio/chain/abi_serializer.hpp>
+
+#include <Runtime/Runtime.h>
+
+#include <fc/variant_object.hpp>
+
+#include <contracts.hpp>
+
+using namespace eosio;
+using namespace eosio::testing;
+using namespace eosio::chain;
+using namespace eosio::testing;
+using namespace fc;
+
+using mvo = fc::mutable_variant_object;
+
+namespace {
+   // uint128 action fields are given as decimal strings
+   std::string to_decimal( unsigned __int128 v ) {
+      std::string s;
+      do {
+         s.insert( s.begin(), char('0' + int(v % 10)) );
+         v /= 10;
+      } while( v );
+      return s;
+   }
+
+   std::vector<std::string> to_decimals( const std::vector<unsigned __int128>& values ) {
+      std::vector<std::string> ret;
+      for( auto v : values )
+         ret.push_back( to_decimal( v ) );
+      return ret;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(int128_tests)
+
+// the 128-bit division and multiplication builtins of librt, run on operands the contract only
+// learns from the action data
+BOOST_FIXTURE_TEST_CASE( verify_tests, tester ) try {
+   using u128 = unsigned __int128;
+   const u128 max = ~u128{0};
+
+   create_accounts( { N(test) } );
+   produce_block();
+
+   set_code( N(test), contracts::int128_wasm() );
+   set_abi( N(test),  contracts::int128_abi().data() );
+
+   produce_blocks();
+
+   const std::vector<u128> dividends = { 0, 1, 1000000, ~0ull, (u128)1 << 64, ((u128)~0ull << 64) | 12345,
+                                         max, max >> 1, ((u128)0x1234567890abcdefull << 64) | 0xfedcba0987654321ull };
+   const std::vector<u128> divisors  = { 1, 3, 10000, 0xffffffffull, 0x100000000ull, ~0ull, (u128)1 << 64,
+                                         ((u128)1 << 64) | 1, max >> 1, max, ((u128)0x1234567890abcdefull << 64) };
+
+   push_action( N(test), N(verify), N(test),
+         mvo()
+         ("dividends", to_decimals( dividends ))
+         ("divisors",  to_decimals( divisors )) );
+
+   BOOST_CHECK_EXCEPTION( push_action( N(test), N(verify), N(test),
+                                       mvo()
+                                       ("dividends", to_decimals( { 1 } ))
+                                       ("divisors",  to_decimals( { 0 } )) ),
+                          eosio_assert_message_exception,
+                          eosio_assert_message_is("divisor is zero") );
+
+} FC_LOG_AND_RETHROW() }
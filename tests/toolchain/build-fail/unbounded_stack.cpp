@@ -0,0 +1,22 @@
+/*
+ * Verifies that -fcheck-stack fails the link of a contract whose worst case stack usage
+ * is unbounded, here through recursion, unless -fallow-unbounded-stack accepts it: the
+ * recursion can overflow the stack even though its first frames fit.
+ */
+
+#include <eosio/eosio.hpp>
+
+using namespace eosio;
+
+[[gnu::noinline]] uint64_t fib(uint64_t n) {
+   return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+
+class [[eosio::contract]] unbounded_stack : public contract {
+public:
+   using contract::contract;
+
+   [[eosio::action]] void run(uint64_t n) {
+      print(fib(n));
+   }
+};
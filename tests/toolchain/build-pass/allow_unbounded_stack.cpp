@@ -0,0 +1,22 @@
+/*
+ * Verifies that -fallow-unbounded-stack lets -fcheck-stack accept a contract whose worst
+ * case stack usage is unbounded through recursion, as long as the frames the recursion
+ * starts from fit. build-fail/unbounded_stack.cpp is the same contract without the flag.
+ */
+
+#include <eosio/eosio.hpp>
+
+using namespace eosio;
+
+[[gnu::noinline]] uint64_t fib(uint64_t n) {
+   return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+
+class [[eosio::contract]] allow_unbounded_stack : public contract {
+public:
+   using contract::contract;
+
+   [[eosio::action]] void run(uint64_t n) {
+      print(fib(n));
+   }
+};
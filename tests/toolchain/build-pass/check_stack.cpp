@@ -0,0 +1,29 @@
+/*
+ * Verifies that -fcheck-stack accepts a contract whose worst case stack usage is bounded
+ * and fits in the default stack: the calls of apply down to the actions only use fixed
+ * frames and the bounded buffer the dispatcher unpacks the action data into.
+ */
+
+#include <eosio/eosio.hpp>
+
+using namespace eosio;
+
+class [[eosio::contract]] check_stack : public contract {
+public:
+   using contract::contract;
+
+   [[eosio::action]] void hi(name user) {
+      require_auth(user);
+      print("Hello, ", user);
+   }
+
+   [[eosio::action]] void sum(std::vector<uint64_t> values) {
+      uint64_t buffer[16] = {};
+      for (size_t i = 0; i < values.size(); ++i)
+         buffer[i % 16] += values[i];
+      uint64_t total = 0;
+      for (uint64_t v : buffer)
+         total += v;
+      print(total);
+   }
+};
@@ -0,0 +1,116 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <string>
+#include <vector>
+
+#include <eosio/action.hpp>
+#include <eosio/asset.hpp>
+#include <eosio/tester.hpp>
+
+using std::string;
+using std::vector;
+
+using eosio::action;
+using eosio::action_wrapper;
+using eosio::asset;
+using eosio::name;
+using eosio::pack;
+using eosio::permission_level;
+using eosio::symbol;
+using eosio::variant_action_wrapper;
+using namespace eosio::native;
+
+// The last action sent, and whether it was context free
+static vector<char> sent;
+static bool         sent_context_free = false;
+
+static void capture_sent_actions() {
+   intrinsics::set_intrinsic<intrinsics::send_inline>([]( char* serialized_action, size_t size ) {
+      sent.assign( serialized_action, serialized_action + size );
+      sent_context_free = false;
+   });
+   intrinsics::set_intrinsic<intrinsics::send_context_free_inline>([]( char* serialized_action, size_t size ) {
+      sent.assign( serialized_action, serialized_action + size );
+      sent_context_free = true;
+   });
+}
+
+struct token {
+   void transfer( name from, name to, asset quantity, string memo ) {}
+   void close( name owner, symbol sym ) {}
+   void notify( name user ) {}
+};
+
+using transfer_action = action_wrapper<"transfer"_n, &token::transfer>;
+using notify_action   = action_wrapper<"notify"_n, &token::notify>;
+using close_action    = variant_action_wrapper<"close"_n, &token::close, &token::notify>;
+
+// Definitions in `eosio.cdt/libraries/eosio/action.hpp`
+EOSIO_TEST_BEGIN(action_send_test)
+   capture_sent_actions();
+   const permission_level alice_active{ "alice"_n, "active"_n };
+   const asset quantity{ 10000, symbol{"EOS", 4} };
+
+   // -----------------------------------
+   // void action::send()const
+   // void action::send_context_free()const
+   const action transfer{ alice_active, "eosio.token"_n, "transfer"_n, std::make_tuple( "alice"_n, "bob"_n, quantity, string{"hi"} ) };
+   transfer.send();
+   CHECK_EQUAL( sent, pack( transfer ) )
+   CHECK_EQUAL( sent_context_free, false )
+
+   const action notify{ vector<permission_level>{}, "eosio.token"_n, "notify"_n, "bob"_n };
+   notify.send_context_free();
+   CHECK_EQUAL( sent, pack( notify ) )
+   CHECK_EQUAL( sent_context_free, true )
+   CHECK_ASSERT( "context free actions cannot have authorizations", [&]() { transfer.send_context_free(); } )
+
+   // larger than the stack buffer
+   const action large{ alice_active, "eosio.token"_n, "transfer"_n, std::make_tuple( "alice"_n, "bob"_n, quantity, string( 1000, 'x' ) ) };
+   large.send();
+   CHECK_EQUAL( sent, pack( large ) )
+
+   // ------------------------------------------------
+   // void action_wrapper<Name, Action>::send(Args...)const
+   // void action_wrapper<Name, Action>::send_context_free(Args...)const
+   transfer_action{ "eosio.token"_n, alice_active }.send( "alice"_n, "bob"_n, quantity, string{"hi"} );
+   CHECK_EQUAL( sent, pack( transfer ) )
+   CHECK_EQUAL( sent_context_free, false )
+
+   transfer_action{ "eosio.token"_n, alice_active }.send( "alice"_n, "bob"_n, quantity, string( 1000, 'x' ) );
+   CHECK_EQUAL( sent, pack( large ) )
+
+   transfer_action{ "eosio.token"_n, alice_active }.send( "alice"_n, "bob"_n, quantity, "hi" );
+   CHECK_EQUAL( sent, pack( transfer ) )
+
+   notify_action{ "eosio.token"_n }.send_context_free( "bob"_n );
+   CHECK_EQUAL( sent, pack( notify ) )
+   CHECK_EQUAL( sent_context_free, true )
+   CHECK_ASSERT( "context free actions cannot have authorizations", [&]() {
+      notify_action{ "eosio.token"_n, alice_active }.send_context_free( "bob"_n );
+   })
+
+   // --------------------------------------------------------------------
+   // void variant_action_wrapper<Name, Actions...>::send<Variant>(Args...)const
+   close_action{ "eosio.token"_n, alice_active }.send<0>( "alice"_n, symbol{"EOS", 4} );
+   CHECK_EQUAL( sent, pack( action{ alice_active, "eosio.token"_n, "close"_n, std::make_tuple( eosio::unsigned_int{0}, "alice"_n, symbol{"EOS", 4} ) } ) )
+
+   // -------------------------------------------------------------
+   // void dispatch_inline(name, name, vector<permission_level>, tuple<Args...>)
+   eosio::dispatch_inline( "eosio.token"_n, "transfer"_n, { alice_active }, std::make_tuple( "alice"_n, "bob"_n, quantity, string{"hi"} ) );
+   CHECK_EQUAL( sent, pack( transfer ) )
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(action_send_test);
+   return has_failed();
+}
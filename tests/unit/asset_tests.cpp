@@ -354,6 +354,33 @@ EOSIO_TEST_BEGIN(asset_type_test)
    // friend bool operator>=( const asset&, const asset&)
    CHECK_EQUAL( ( asset{1LL, sym_no_prec} >= asset{0LL, sym_no_prec} ), true )
    CHECK_EQUAL( ( asset{1LL, sym_no_prec} >= asset{1LL, sym_no_prec} ), true )
+
+   // ---------------------------------------------------
+   // char* write_as_string(char*, char*, bool)const
+   char buffer[16];
+   const asset eos{-12345LL, symbol{"EOS", 4}};
+   CHECK_EQUAL( eos.write_as_string( buffer, buffer + sizeof(buffer), true ) - buffer, 11 )
+   CHECK_EQUAL( eos.write_as_string( buffer, buffer + 10 ) - buffer, 11 )
+   CHECK_EQUAL( (string{buffer, eos.write_as_string( buffer, buffer + 11 )}), "-1.2345 EOS" )
+   CHECK_EQUAL( (asset{0LL, symbol{"A", 255}}.to_string().size()), 259 )
+
+   // -----------------------------------------
+   // inline constexpr asset operator""_a()
+   static_assert( "1.0000 EOS"_a.amount == 10000LL && "1.0000 EOS"_a.symbol == symbol{"EOS", 4} );
+   CHECK_EQUAL( "-0.0001 EOS"_a, (asset{-1LL, symbol{"EOS", 4}}) )
+   CHECK_EQUAL( "12 SYMBOLL"_a, (asset{12LL, sym_no_prec}) )
+   CHECK_EQUAL( "4611686018427387903 A"_a, (asset{asset_max, s0}) )
+   CHECK_EQUAL( "-46116860184273879.03 SYMBOLL"_a.to_string(), "-46116860184273879.03 SYMBOLL" )
+
+   CHECK_ASSERT( "asset must be an amount and a symbol code separated by a space", []() {eosio::detail::parse_asset("1.0000");} )
+   CHECK_ASSERT( "amount of asset must be a decimal number", []() {eosio::detail::parse_asset(" EOS");} )
+   CHECK_ASSERT( "amount of asset must be a decimal number", []() {eosio::detail::parse_asset(".5 EOS");} )
+   CHECK_ASSERT( "amount of asset must be a decimal number", []() {eosio::detail::parse_asset("5. EOS");} )
+   CHECK_ASSERT( "amount of asset must be a decimal number", []() {eosio::detail::parse_asset("1.0.0 EOS");} )
+   CHECK_ASSERT( "amount of asset must be a decimal number", []() {eosio::detail::parse_asset("1,000 EOS");} )
+   CHECK_ASSERT( "magnitude of asset amount must be less than 2^62", []() {eosio::detail::parse_asset("4611686018427387904 EOS");} )
+   CHECK_ASSERT( "precision of symbol must be at most 18", []() {eosio::detail::parse_asset("0.0000000000000000001 EOS");} )
+   CHECK_ASSERT( "invalid symbol name", []() {eosio::detail::parse_asset("1.0 ");} )
 EOSIO_TEST_END
 
 // Definitions in `eosio.cdt/libraries/eosio/asset.hpp`
@@ -0,0 +1,113 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <array>
+#include <limits>
+#include <map>
+
+#include <eosio/composite_key.hpp>
+#include <eosio/tester.hpp>
+
+using std::array;
+using std::map;
+using std::numeric_limits;
+
+using eosio::checksum256;
+using eosio::composite_key_lower_bound;
+using eosio::composite_key_range;
+using eosio::composite_key_upper_bound;
+using eosio::make_composite_key;
+using eosio::name;
+
+// Stands in for a secondary index of multi_index, sorted as idx256 sorts its keys
+struct sorted_index {
+   map<checksum256, uint64_t> entries;
+   auto lower_bound( const checksum256& key )const { return entries.lower_bound( key ); }
+   auto upper_bound( const checksum256& key )const { return entries.upper_bound( key ); }
+};
+
+// Definitions in `eosio.cdt/libraries/eosio/composite_key.hpp`
+EOSIO_TEST_BEGIN(composite_key_test)
+   // -----------------------------------------
+   // checksum256 make_composite_key(Parts...)
+   static constexpr array<uint8_t, 32> bytes{ 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,
+                                              0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x02,
+                                              0x00,0x00,0x00,0x03,
+                                              0x00,0x04,
+                                              0x05,
+                                              0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 };
+   CHECK_EQUAL( make_composite_key( name{1}, uint64_t{2}, uint32_t{3}, uint16_t{4}, uint8_t{5} ).byte_view(), bytes )
+   CHECK_EQUAL( make_composite_key(), checksum256{} )
+
+   // the words of idx256
+   CHECK_EQUAL( (make_composite_key( uint64_t{1}, uint64_t{2}, uint64_t{3}, uint64_t{4} ).get_array()),
+                (array<uint128_t, 2>{ (uint128_t{1} << 64) | 2, (uint128_t{3} << 64) | 4 }) )
+   CHECK_EQUAL( (make_composite_key( uint128_t{7} ).get_array()), (array<uint128_t, 2>{ 7, 0 }) )
+
+   // a part straddling the two words
+   CHECK_EQUAL( (make_composite_key( uint64_t{1}, uint32_t{2}, uint64_t{0x0102030405060708} ).get_array()),
+                (array<uint128_t, 2>{ (uint128_t{1} << 64) | (uint128_t{2} << 32) | 0x01020304, uint128_t{0x05060708} << 96 }) )
+   CHECK_EQUAL( (composite_key_upper_bound( uint64_t{1}, uint32_t{2}, uint64_t{3} ).get_array()),
+                (array<uint128_t, 2>{ (uint128_t{1} << 64) | (uint128_t{2} << 32), (uint128_t{3} << 96) | (~uint128_t{0} >> 32) }) )
+   CHECK_EQUAL( (composite_key_upper_bound( "bob"_n ).get_array()),
+                (array<uint128_t, 2>{ (uint128_t{"bob"_n.value} << 64) | ~uint64_t{0}, ~uint128_t{0} }) )
+   static_assert( make_composite_key( uint64_t{1}, uint32_t{2}, uint64_t{0x0102030405060708} ).byte_view()[19] == 0x08 );
+
+   // signed integers sort negative values first
+   CHECK_EQUAL( make_composite_key( int64_t{-1} ).byte_view()[0], 0x7f )
+   CHECK_EQUAL( make_composite_key( int64_t{0} ).byte_view()[0], 0x80 )
+   CHECK_EQUAL( make_composite_key( int32_t{-5} ) < make_composite_key( int32_t{3} ), true )
+   CHECK_EQUAL( make_composite_key( numeric_limits<int64_t>::min() ) < make_composite_key( int64_t{-1} ), true )
+
+   // keys sort as the tuples of their parts
+   CHECK_EQUAL( make_composite_key( "alice"_n, uint64_t{9} ) < make_composite_key( "bob"_n, uint64_t{1} ), true )
+   CHECK_EQUAL( make_composite_key( "bob"_n, uint64_t{1} ) < make_composite_key( "bob"_n, uint64_t{2} ), true )
+
+   // ----------------------------------------------
+   // checksum256 composite_key_lower_bound(Parts...)
+   // checksum256 composite_key_upper_bound(Parts...)
+   CHECK_EQUAL( composite_key_lower_bound( "bob"_n ), make_composite_key( "bob"_n ) )
+   CHECK_EQUAL( composite_key_lower_bound( "bob"_n ) <= make_composite_key( "bob"_n, uint64_t{0} ), true )
+   CHECK_EQUAL( composite_key_upper_bound( "bob"_n ) >= make_composite_key( "bob"_n, numeric_limits<uint64_t>::max(), numeric_limits<uint128_t>::max() ), true )
+   CHECK_EQUAL( composite_key_upper_bound( "bob"_n ) < make_composite_key( "bob"_n.value + 1 ), true )
+   CHECK_EQUAL( composite_key_upper_bound().byte_view()[31], 0xff )
+
+   // ----------------------------------------------
+   // composite_key_range(const Index&, Parts...)
+   sorted_index idx;
+   for( name market : { "eos"_n, "usd"_n } )
+      for( name owner : { "alice"_n, "bob"_n, "carol"_n } )
+         for( uint64_t id = 1; id <= 3; ++id )
+            idx.entries[make_composite_key( market, owner, id )] = id;
+
+   auto count = [&]( auto range ) {
+      size_t n = 0;
+      for( auto itr = range.first; itr != range.second; ++itr )
+         ++n;
+      return n;
+   };
+   CHECK_EQUAL( count( composite_key_range( idx, "usd"_n ) ), 9 )
+   CHECK_EQUAL( count( composite_key_range( idx, "usd"_n, "bob"_n ) ), 3 )
+   CHECK_EQUAL( count( composite_key_range( idx, "usd"_n, "bob"_n, uint64_t{2} ) ), 1 )
+   CHECK_EQUAL( count( composite_key_range( idx, "usd"_n, "dave"_n ) ), 0 )
+   CHECK_EQUAL( count( composite_key_range( idx ) ), 18 )
+   CHECK_EQUAL( composite_key_range( idx, "eos"_n, "carol"_n ).first->second, 1 )
+
+   // ---------------------------------
+   // usable in constant expressions
+   static_assert( make_composite_key( "eosio"_n, uint32_t{1} ).byte_view()[11] == 1 );
+   static_assert( composite_key_upper_bound( uint128_t{0} ).byte_view()[16] == 0xff );
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(composite_key_test);
+   return has_failed();
+}
@@ -6,8 +6,11 @@
 #include <eosio/tester.hpp>
 #include <eosio/crypto.hpp>
 
+using eosio::checksum256;
+using eosio::byte_checksum256;
 using eosio::public_key;
 using eosio::signature;
+using namespace eosio::native;
 
 // Definitions in `eosio.cdt/libraries/eosio/crypto.hpp`
 EOSIO_TEST_BEGIN(public_key_type_test)
@@ -35,6 +38,94 @@ EOSIO_TEST_BEGIN(signature_type_test)
    CHECK_EQUAL( (signature(std::in_place_index<0>, std::array<char, 65>{})  != signature(std::in_place_index<0>, std::array<char, 65>{})), false )
 EOSIO_TEST_END
 
+// Definitions in `eosio.cdt/libraries/eosio/crypto.hpp`
+EOSIO_TEST_BEGIN(recover_key_test)
+   static const signature  k1_sig{std::in_place_index<0>, std::array<char, 65>{7}};
+   static const signature  r1_sig{std::in_place_index<1>, std::array<char, 65>{9}};
+   static const public_key k1_key{std::in_place_index<0>, std::array<char, 33>{3}};
+   static const public_key r1_key{std::in_place_index<1>, std::array<char, 33>{5}};
+
+   // the host receives the variant index followed by the compact signature, and returns the packed key
+   intrinsics::set_intrinsic<intrinsics::recover_key>([](const capi_checksum256*, const char* sig, size_t siglen, char* pub, size_t publen) {
+      eosio::check( siglen == 66, "unexpected signature size" );
+      eosio::datastream<char*> ds( pub, publen );
+      ds << (sig[0] == 0 ? k1_key : r1_key);
+      return 34;
+   });
+   intrinsics::set_intrinsic<intrinsics::assert_recover_key>([](const capi_checksum256*, const char* sig, size_t siglen, const char* pub, size_t publen) {
+      eosio::check( siglen == 66 && publen == 34, "unexpected packed size" );
+      eosio::check( sig[0] == pub[0], "key does not match signature" );
+   });
+
+   // ---------------------------------------------------------------
+   // public_key recover_key(const checksum256&, const signature&)
+   CHECK_EQUAL( eosio::recover_key(checksum256{}, k1_sig) == k1_key, true )
+   CHECK_EQUAL( eosio::recover_key(checksum256{}, r1_sig) == r1_key, true )
+
+   // ---------------------------------------------------------------------------------
+   // void assert_recover_key(const checksum256&, const signature&, const public_key&)
+   eosio::assert_recover_key( checksum256{}, k1_sig, k1_key );
+   CHECK_ASSERT( "key does not match signature", []() { eosio::assert_recover_key(checksum256{}, r1_sig, k1_key); } )
+
+   // --------------------------------------------------------------------------------------
+   // void recover_keys(const checksum256*, const signature*, public_key*, size_t)
+   {
+      const checksum256 digests[3]{};
+      const signature   sigs[3]{k1_sig, r1_sig, k1_sig};
+      public_key        keys[3];
+      eosio::recover_keys( digests, sigs, keys, 3 );
+      CHECK_EQUAL( keys[0] == k1_key, true )
+      CHECK_EQUAL( keys[1] == r1_key, true )
+      CHECK_EQUAL( keys[2] == k1_key, true )
+   }
+
+   // ---------------------------------------------------------------------------------------------
+   // void assert_recover_keys(const checksum256*, const signature*, const public_key*, size_t)
+   CHECK_ASSERT( "key does not match signature", []() {
+      const checksum256 digests[2]{};
+      const signature   sigs[2]{k1_sig, r1_sig};
+      const public_key  keys[2]{k1_key, k1_key};
+      eosio::assert_recover_keys( digests, sigs, keys, 2 );
+   } )
+EOSIO_TEST_END
+
+// Definitions in `eosio.cdt/libraries/eosio/crypto.hpp`
+EOSIO_TEST_BEGIN(byte_checksum_hash_test)
+   // the host writes the digest into the bytes of the byte_checksum, and reads them back from it
+   intrinsics::set_intrinsic<intrinsics::sha256>([](const char* data, uint32_t length, capi_checksum256* hash) {
+      for( uint32_t i = 0; i < 32; ++i )
+         hash->hash[i] = static_cast<uint8_t>(i < length ? data[i] : i);
+   });
+   intrinsics::set_intrinsic<intrinsics::assert_sha256>([](const char* data, uint32_t length, const capi_checksum256* hash) {
+      for( uint32_t i = 0; i < 32; ++i )
+         eosio::check( hash->hash[i] == static_cast<uint8_t>(i < length ? data[i] : i), "hash mismatch" );
+   });
+   intrinsics::set_intrinsic<intrinsics::recover_key>([](const capi_checksum256* digest, const char*, size_t, char* pub, size_t publen) {
+      eosio::datastream<char*> ds( pub, publen );
+      ds << public_key{std::in_place_index<0>, std::array<char, 33>{static_cast<char>(digest->hash[31])}};
+      return 34;
+   });
+
+   // -----------------------------------------------------------
+   // byte_checksum256 sha256_bytes(const char*, uint32_t)
+   const byte_checksum256 hash = eosio::sha256_bytes( "ab", 2 );
+   CHECK_EQUAL( hash.byte_view()[0], 'a' )
+   CHECK_EQUAL( hash.byte_view()[1], 'b' )
+   CHECK_EQUAL( hash.byte_view()[31], 31 )
+   CHECK_EQUAL( hash.to_fixed_bytes() == eosio::sha256( "ab", 2 ), true )
+
+   // ------------------------------------------------------------------------
+   // void assert_sha256(const char*, uint32_t, const byte_checksum256&)
+   eosio::assert_sha256( "ab", 2, hash );
+   CHECK_ASSERT( "hash mismatch", [&]() { eosio::assert_sha256( "ac", 2, hash ); } )
+
+   // ------------------------------------------------------------------------
+   // public_key recover_key(const byte_checksum256&, const signature&)
+   static const signature sig{std::in_place_index<0>, std::array<char, 65>{}};
+   CHECK_EQUAL( (eosio::recover_key(hash, sig) == public_key{std::in_place_index<0>, std::array<char, 33>{31}}), true )
+   CHECK_EQUAL( (eosio::recover_key(hash.to_fixed_bytes(), sig) == eosio::recover_key(hash, sig)), true )
+EOSIO_TEST_END
+
 int main(int argc, char* argv[]) {
    bool verbose = false;
    if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
@@ -44,5 +135,7 @@ int main(int argc, char* argv[]) {
 
    EOSIO_TEST(public_key_type_test)
    EOSIO_TEST(signature_type_test)
+   EOSIO_TEST(recover_key_test)
+   EOSIO_TEST(byte_checksum_hash_test)
    return has_failed();
 }
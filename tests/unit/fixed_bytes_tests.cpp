@@ -11,6 +11,7 @@
 using std::array;
 
 using eosio::fixed_bytes;
+using eosio::byte_checksum;
 
 // Definitions in `eosio.cdt/libraries/eosio/fixed_bytes.hpp`
 EOSIO_TEST_BEGIN(fixed_bytes_test)
@@ -86,9 +87,8 @@ EOSIO_TEST_BEGIN(fixed_bytes_test)
    // -------------------------------------------
    // make_from_word_sequence(FirstWord, Rest...)
 
-   // Possible discrepancy between two `make_from_word_sequence` and array constructor
-   // CHECK_EQUAL( (fixed_bytes<20>::make_from_word_sequence<uint64_t>(1ULL, 2ULL)),
-   //              (fixed_bytes<20>{array<uint64_t,2>{1ULL, 2ULL}}) )
+   CHECK_EQUAL( (fixed_bytes<20>::make_from_word_sequence<uint64_t>(1ULL, 2ULL)),
+                (fixed_bytes<20>{array<uint64_t,2>{1ULL, 2ULL}}) )
 
    CHECK_EQUAL( (fixed_bytes<32>::make_from_word_sequence<uint64_t>(1ULL,2ULL,3ULL,4ULL)),
                 (fixed_bytes<32>{array<uint64_t, 4>{1ULL,2ULL,3ULL,4ULL}}) )
@@ -109,6 +109,34 @@ EOSIO_TEST_BEGIN(fixed_bytes_test)
    CHECK_EQUAL( (fixed_bytes<32>{}.get_array()), (array<uint128_t, 2>{}) )
    CHECK_EQUAL( (fixed_bytes<512>{}.get_array()), (array<uint128_t, 32>{}) )
 
+   // big-endian words, as the secondary index idx256 stores them
+   static constexpr array<uint128_t, 2> words32{ (uint128_t{1} << 64) | 2, (uint128_t{3} << 64) | 4 };
+   CHECK_EQUAL( (fixed_bytes<32>{array<uint64_t, 4>{1ULL,2ULL,3ULL,4ULL}}.get_array()), words32 )
+   CHECK_EQUAL( (fixed_bytes<32>{words32}.extract_as_byte_array()), extract_arr )
+   CHECK_EQUAL( (fixed_bytes<32>{fixed_bytes<32>{words32}.get_array()}), (fixed_bytes<32>{words32}) )
+
+   // the last word is padded with zeros
+   static constexpr array<uint128_t, 2> words20{ (uint128_t{1} << 64) | 2, uint128_t{0x03040506} << 96 };
+   CHECK_EQUAL( (fixed_bytes<20>{array<uint32_t, 5>{0,1,0,2,0x03040506}}.get_array()), words20 )
+   CHECK_EQUAL( (fixed_bytes<20>{words20}), (fixed_bytes<20>{array<uint32_t, 5>{0,1,0,2,0x03040506}}) )
+   CHECK_EQUAL( (fixed_bytes<20>{array<uint16_t, 9>{0,0,0,0,0,0,0,1,0x0203}}.get_array()),
+                (array<uint128_t, 2>{1, uint128_t{0x0203} << 112}) )
+
+   // --------------------------------------------
+   // array<uint8_t, Size> byte_view()const
+   static const fixed_bytes<32> fb_view{extract_arr};
+   CHECK_EQUAL( fb_view.byte_view(), extract_arr )
+   CHECK_EQUAL( (fixed_bytes<20>{words20}.byte_view()),
+                (array<uint8_t, 20>{0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,2,3,4,5,6}) )
+   static_assert( fixed_bytes<32>{words32}.byte_view()[31] == 4 );
+
+   // -----------------------------------------------------------
+   // fixed_bytes(const Word(&)[NumWords]), from a capi checksum
+   struct __attribute__((aligned (16))) capi_checksum256 { uint8_t hash[32]; };
+   capi_checksum256 capi_hash{};
+   std::copy(extract_arr.begin(), extract_arr.end(), capi_hash.hash);
+   CHECK_EQUAL( (fixed_bytes<32>{capi_hash.hash}), fb_view )
+
    // -----------
    // auto data()
    static constexpr fixed_bytes<0> fb_data0{};
@@ -173,6 +201,81 @@ EOSIO_TEST_BEGIN(fixed_bytes_test)
    // friend bool operator>= <>(const fixed_bytes<Size>, const fixed_bytes<Size>)
    CHECK_EQUAL( fb_cmp1 >= fb_cmp1, true  )
    CHECK_EQUAL( fb_cmp1 >= fb_cmp2, false )
+
+   // bytes compare as the words of idx256 do
+   static const fixed_bytes<32> fb_cmp3{array<uint128_t, 2>{uint128_t{1} << 120, 0}};
+   static const fixed_bytes<32> fb_cmp4{array<uint128_t, 2>{0xff, ~uint128_t{0}}};
+   CHECK_EQUAL( fb_cmp3 > fb_cmp4, true )
+   CHECK_EQUAL( fb_cmp3.get_array() > fb_cmp4.get_array(), true )
+EOSIO_TEST_END
+
+// Definitions in `eosio.cdt/libraries/eosio/fixed_bytes.hpp`
+EOSIO_TEST_BEGIN(byte_checksum_test)
+   static const array<uint8_t, 32> bytes{ 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,
+                                          0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x02,
+                                          0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x03,
+                                          0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x04 };
+   static const fixed_bytes<32> fb{array<uint64_t, 4>{1ULL,2ULL,3ULL,4ULL}};
+
+   //// constexpr byte_checksum()
+   CHECK_EQUAL( (byte_checksum<32>{}.byte_view()), (array<uint8_t, 32>{}) )
+
+   // ---------------------------------------------------------------
+   // byte_checksum(const uint8_t(&)[Size]), from a capi checksum
+   struct __attribute__((aligned (16))) capi_checksum256 { uint8_t hash[32]; };
+   capi_checksum256 capi_hash{};
+   std::copy(bytes.begin(), bytes.end(), capi_hash.hash);
+   CHECK_EQUAL( (byte_checksum<32>{capi_hash.hash}.byte_view()), bytes )
+
+   // ----------------------------------------------------------------
+   // byte_checksum(const fixed_bytes<Size>&), fixed_bytes<Size> to_fixed_bytes()const
+   CHECK_EQUAL( (byte_checksum<32>{fb}.byte_view()), bytes )
+   CHECK_EQUAL( (byte_checksum<32>{bytes}.to_fixed_bytes()), fb )
+   CHECK_EQUAL( (byte_checksum<32>{bytes}.to_fixed_bytes().get_array()), fb.get_array() )
+   CHECK_EQUAL( (byte_checksum<20>{fixed_bytes<20>{array<uint32_t, 5>{0,1,0,2,0x03040506}}}.byte_view()),
+                (array<uint8_t, 20>{0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,2,3,4,5,6}) )
+   static_assert( byte_checksum<32>{fixed_bytes<32>{array<uint64_t, 4>{1ULL,2ULL,3ULL,4ULL}}}.to_fixed_bytes().byte_view()[31] == 4 );
+
+   // -------------------------------------------------------------------------
+   // const array<uint8_t, Size>& byte_view()const, data(), static size()
+   static const byte_checksum<32> bc{bytes};
+   CHECK_EQUAL( bc.byte_view().data(), bc.data() )
+   CHECK_EQUAL( bc.size(), 32 )
+   CHECK_EQUAL( reinterpret_cast<uintptr_t>(bc.data()) % 16, 0 )
+
+   // -----------------------------------------------------------------------
+   // friend bool operator==,!=,<,<=,>,>=(const byte_checksum, const byte_checksum)
+   // ordered as the fixed_bytes, and the words of idx256, holding the same bytes
+   static const fixed_bytes<32> fb_lo{array<uint128_t, 2>{0xff, ~uint128_t{0}}};
+   static const fixed_bytes<32> fb_hi{array<uint128_t, 2>{uint128_t{1} << 120, 0}};
+   static const byte_checksum<32> bc_lo{fb_lo};
+   static const byte_checksum<32> bc_hi{fb_hi};
+
+   CHECK_EQUAL( bc_lo == byte_checksum<32>{fb_lo}, true  )
+   CHECK_EQUAL( bc_lo == bc_hi, false )
+   CHECK_EQUAL( bc_lo != bc_hi, true  )
+   CHECK_EQUAL( bc_lo != bc_lo, false )
+   CHECK_EQUAL( bc_lo <  bc_hi, true  )
+   CHECK_EQUAL( bc_hi <  bc_lo, false )
+   CHECK_EQUAL( bc_lo <= bc_lo, true  )
+   CHECK_EQUAL( bc_hi <= bc_lo, false )
+   CHECK_EQUAL( bc_hi >  bc_lo, true  )
+   CHECK_EQUAL( bc_lo >  bc_lo, false )
+   CHECK_EQUAL( bc_hi >= bc_hi, true  )
+   CHECK_EQUAL( bc_lo >= bc_hi, false )
+   CHECK_EQUAL( (bc_lo < bc_hi) == (fb_lo < fb_hi), true )
+
+   // ---------------------------------------------------------
+   // DataStream& operator<<, operator>>(DataStream&, byte_checksum<Size>&)
+   char buffer[32];
+   eosio::datastream<char*> ds_out( buffer, sizeof(buffer) );
+   ds_out << bc;
+   CHECK_EQUAL( std::equal(bytes.begin(), bytes.end(), reinterpret_cast<const uint8_t*>(buffer)), true )
+
+   byte_checksum<32> bc_in;
+   eosio::datastream<const char*> ds_in( buffer, sizeof(buffer) );
+   ds_in >> bc_in;
+   CHECK_EQUAL( bc_in == bc, true )
 EOSIO_TEST_END
 
 int main(int argc, char* argv[]) {
@@ -183,5 +286,6 @@ int main(int argc, char* argv[]) {
    silence_output(!verbose);
 
    EOSIO_TEST(fixed_bytes_test);
+   EOSIO_TEST(byte_checksum_test);
    return has_failed();
 }
@@ -0,0 +1,155 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <limits>
+#include <string>
+
+#include <eosio/datastream.hpp>
+#include <eosio/fixed_decimal.hpp>
+#include <eosio/tester.hpp>
+
+using std::numeric_limits;
+using std::string;
+
+using eosio::asset;
+using eosio::fixed_decimal;
+using eosio::pack;
+using eosio::pack_size;
+using eosio::rounding;
+using eosio::symbol;
+using eosio::unpack;
+
+static constexpr int64_t  i64max  = numeric_limits<int64_t>::max();  //  9223372036854775807
+static constexpr int128_t i128max = numeric_limits<int128_t>::max(); //  170141183460469231731687303715884105727
+static constexpr int128_t i128min = numeric_limits<int128_t>::min(); // -170141183460469231731687303715884105728
+
+// Definitions in `eosio.cdt/libraries/eosio/fixed_decimal.hpp`
+EOSIO_TEST_BEGIN(fixed_decimal_arithmetic_test)
+   // ---------------------------------
+   // fixed_decimal(T), from_raw, raw
+   CHECK_EQUAL( fixed_decimal<4>{}.raw() == 0, true )
+   CHECK_EQUAL( fixed_decimal<4>{3}.raw() == 30000, true )
+   CHECK_EQUAL( fixed_decimal<4>{-3}.raw() == -30000, true )
+   CHECK_EQUAL( fixed_decimal<0>{7}.raw() == 7, true )
+   CHECK_EQUAL( fixed_decimal<4>::from_raw(30000), fixed_decimal<4>{3} )
+   CHECK_EQUAL( fixed_decimal<18>::scale, 1000000000000000000ll )
+
+   // -----------------------------------------
+   // from_fraction(int128_t, int128_t, rounding)
+   CHECK_EQUAL( fixed_decimal<4>::from_fraction(1, 3).raw() == 3333, true )
+   CHECK_EQUAL( fixed_decimal<4>::from_fraction(2, 3).raw() == 6667, true )
+   CHECK_EQUAL( fixed_decimal<4>::from_fraction(2, 3, rounding::down).raw() == 6666, true )
+   CHECK_EQUAL( fixed_decimal<4>::from_fraction(-2, 3).raw() == -6667, true )
+   CHECK_EQUAL( fixed_decimal<4>::from_fraction(-2, 3, rounding::down).raw() == -6667, true )
+   CHECK_EQUAL( fixed_decimal<4>::from_fraction(-2, 3, rounding::up).raw() == -6666, true )
+   CHECK_ASSERT( "divide by zero", []() { fixed_decimal<4>::from_fraction(1, 0); } )
+
+   // ----------------------------------
+   // operators and mul, div, to_integer
+   const auto a = fixed_decimal<2>::from_raw(150); // 1.50
+   const auto b = fixed_decimal<2>::from_raw(225); // 2.25
+   CHECK_EQUAL( (a + b).raw() == 375, true )
+   CHECK_EQUAL( (a - b).raw() == -75, true )
+   CHECK_EQUAL( (-a).raw() == -150, true )
+   CHECK_EQUAL( (a * b).raw() == 338, true )
+   CHECK_EQUAL( a.mul(b, rounding::down).raw() == 337, true )
+   CHECK_EQUAL( (-a * b).raw() == -338, true )
+   CHECK_EQUAL( (-a).mul(b, rounding::up).raw() == -337, true )
+   CHECK_EQUAL( (b / a).raw() == 150, true )
+   CHECK_EQUAL( (fixed_decimal<4>{1} / fixed_decimal<4>{3}).raw() == 3333, true )
+   CHECK_EQUAL( fixed_decimal<4>{2}.div(fixed_decimal<4>{3}, rounding::down).raw() == 6666, true )
+   CHECK_EQUAL( a < b, true )
+   CHECK_EQUAL( -b < a, true )
+   CHECK_EQUAL( a != b, true )
+
+   auto c = a;
+   c += b;
+   c -= a;
+   c *= a;
+   c /= b;
+   CHECK_EQUAL( c, a )
+
+   CHECK_EQUAL( fixed_decimal<4>::from_raw(25000).to_integer() == 3, true )
+   CHECK_EQUAL( fixed_decimal<4>::from_raw(-25000).to_integer() == -3, true )
+   CHECK_EQUAL( fixed_decimal<4>::from_raw(25000).to_integer(rounding::down) == 2, true )
+   CHECK_EQUAL( fixed_decimal<4>::from_raw(-25000).to_integer(rounding::down) == -3, true )
+   CHECK_EQUAL( fixed_decimal<4>::from_raw(-25000).to_integer(rounding::up) == -2, true )
+
+   CHECK_ASSERT( "addition overflow", []() { fixed_decimal<4>::from_raw(i128max) + fixed_decimal<4>::from_raw(1); } )
+   CHECK_ASSERT( "subtraction overflow", []() { fixed_decimal<4>::from_raw(i128min) - fixed_decimal<4>::from_raw(1); } )
+   CHECK_ASSERT( "negation overflow", []() { -fixed_decimal<4>::from_raw(i128min); } )
+   CHECK_ASSERT( "muldiv overflow", []() { fixed_decimal<4>::from_raw(i128max) * fixed_decimal<4>{2}; } )
+   CHECK_ASSERT( "divide by zero", []() { fixed_decimal<4>{1} / fixed_decimal<4>{}; } )
+
+   // -----------------------------------
+   // usable in constant expressions
+   static_assert( (fixed_decimal<2>::from_raw(150) * fixed_decimal<2>{2}).raw() == 300 );
+   static_assert( fixed_decimal<6>::from_fraction(1, 8) == fixed_decimal<6>::from_raw(125000) );
+EOSIO_TEST_END
+
+// Definitions in `eosio.cdt/libraries/eosio/fixed_decimal.hpp`
+EOSIO_TEST_BEGIN(fixed_decimal_conversion_test)
+   const symbol eos{"EOS", 4};
+
+   // ---------------------------------
+   // from_asset, to_asset, rescale
+   CHECK_EQUAL( fixed_decimal<6>::from_asset(asset{12345, eos}).raw() == 1234500, true )
+   CHECK_EQUAL( fixed_decimal<2>::from_asset(asset{12345, eos}).raw() == 123, true )
+   CHECK_EQUAL( fixed_decimal<2>::from_asset(asset{12345, eos}, rounding::up).raw() == 124, true )
+   CHECK_EQUAL( fixed_decimal<2>::from_asset(asset{-12350, eos}).raw() == -124, true )
+
+   CHECK_EQUAL( fixed_decimal<6>::from_raw(1234567).to_asset(eos), (asset{12346, eos}) )
+   CHECK_EQUAL( fixed_decimal<6>::from_raw(1234567).to_asset(eos, rounding::down), (asset{12345, eos}) )
+   CHECK_EQUAL( fixed_decimal<2>::from_raw(-123).to_asset(eos), (asset{-12300, eos}) )
+   CHECK_EQUAL( fixed_decimal<6>::from_raw(1234567).to_asset(eos).to_string(), string{"1.2346 EOS"} )
+   CHECK_ASSERT( "magnitude of asset amount must be less than 2^62", []() {
+      fixed_decimal<0>{i64max}.to_asset(symbol{"EOS", 0});
+   })
+
+   CHECK_EQUAL( fixed_decimal<4>::from_raw(12350).rescale<2>().raw() == 124, true )
+   CHECK_EQUAL( fixed_decimal<4>::from_raw(12350).rescale<2>(rounding::down).raw() == 123, true )
+   CHECK_EQUAL( fixed_decimal<4>::from_raw(12350).rescale<8>().raw() == 123500000, true )
+   CHECK_ASSERT( "multiplication overflow", []() { fixed_decimal<0>::from_raw(i128max).rescale<1>(); } )
+
+   // ---------------------------------------
+   // to_string, write_as_string, print
+   CHECK_EQUAL( fixed_decimal<4>{}.to_string(), string{"0.0000"} )
+   CHECK_EQUAL( fixed_decimal<2>::from_raw(-5).to_string(), string{"-0.05"} )
+   CHECK_EQUAL( fixed_decimal<0>{42}.to_string(), string{"42"} )
+   CHECK_EQUAL( fixed_decimal<4>::from_fraction(-2, 3).to_string(), string{"-0.6667"} )
+   CHECK_EQUAL( fixed_decimal<4>::from_raw(int128_t{1} << 64).to_string(), string{"1844674407370955.1616"} )
+   CHECK_EQUAL( fixed_decimal<4>::from_raw(i128max).to_string(), string{"17014118346046923173168730371588410.5727"} )
+   CHECK_EQUAL( fixed_decimal<4>::from_raw(i128min).to_string(), string{"-17014118346046923173168730371588410.5728"} )
+   CHECK_EQUAL( fixed_decimal<0>::from_raw(i128min).to_string(), string{"-170141183460469231731687303715884105728"} )
+   CHECK_EQUAL( fixed_decimal<18>::from_raw(i128max).to_string(), string{"170141183460469231731.687303715884105727"} )
+   CHECK_EQUAL( fixed_decimal<18>::from_raw(int128_t{5} << 64).to_string(), string{"92.233720368547758080"} )
+
+   char buffer[8];
+   const auto wide = fixed_decimal<4>::from_raw(i128max);
+   CHECK_EQUAL( wide.write_as_string(buffer, buffer + sizeof(buffer)) - buffer, 40 )
+   CHECK_EQUAL( wide.write_as_string(buffer, buffer + sizeof(buffer), true) - buffer, 40 )
+
+   CHECK_PRINT( "-17014118346046923173168730371588410.5728", [&](){ fixed_decimal<4>::from_raw(i128min).print(); } )
+   CHECK_PRINT( "1.5000", [](){ fixed_decimal<4>::from_fraction(3, 2).print(); } )
+
+   // ---------------
+   // serialization
+   const auto price = fixed_decimal<8>::from_raw(-(int128_t{1} << 100));
+   CHECK_EQUAL( pack_size(price), 16 )
+   CHECK_EQUAL( unpack<fixed_decimal<8>>(pack(price)), price )
+   CHECK_EQUAL( pack(price) == pack(price.raw()), true )
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(fixed_decimal_arithmetic_test);
+   EOSIO_TEST(fixed_decimal_conversion_test);
+   return has_failed();
+}
@@ -0,0 +1,138 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <limits>
+#include <string>
+
+#include <eosio/eosio.hpp>
+#include <eosio/format.hpp>
+#include <eosio/tester.hpp>
+
+using std::numeric_limits;
+using std::string;
+
+using eosio::asset;
+using eosio::extended_asset;
+using eosio::format;
+using eosio::format_to;
+using eosio::name;
+using eosio::static_string;
+using eosio::symbol;
+using eosio::symbol_code;
+
+// A value of n dashes written through write_as_string
+struct dashes {
+   size_t n;
+   char* write_as_string( char* begin, char* end, bool dry_run = false )const {
+      if( dry_run || begin + n > end ) return begin + n;
+      memset( begin, '-', n );
+      return begin + n;
+   }
+};
+
+// Only the form without dry run, which format_to does not call
+struct without_dry_run {
+   char* write_as_string( char* begin, char* end )const { return begin; }
+};
+
+static_assert( eosio::detail::has_write_as_string<dashes>::value );
+static_assert( !eosio::detail::has_write_as_string<without_dry_run>::value );
+
+// Definitions in `eosio.cdt/libraries/eosio/format.hpp`
+EOSIO_TEST_BEGIN(format_to_test)
+   static constexpr uint8_t buffer_size{64};
+   char buffer[buffer_size]{};
+
+   // -----------------------------------------
+   // char* format_to(char*, char*, Args&&...)
+   char* end = format_to( buffer, buffer + sizeof(buffer), "abc", string{"def"}, std::string_view{"ghi"}, '!' );
+   CHECK_EQUAL( string(buffer, end), "abcdefghi!" )
+
+   end = format_to( buffer, buffer + sizeof(buffer), 0, ' ', -1, ' ', 42u, ' ', true, ' ', false );
+   CHECK_EQUAL( string(buffer, end), "0 -1 42 true false" )
+
+   end = format_to( buffer, buffer + sizeof(buffer), numeric_limits<int64_t>::min(), ' ', numeric_limits<uint64_t>::max() );
+   CHECK_EQUAL( string(buffer, end), "-9223372036854775808 18446744073709551615" )
+
+   end = format_to( buffer, buffer + sizeof(buffer), numeric_limits<uint128_t>::max() );
+   CHECK_EQUAL( string(buffer, end), "340282366920938463463374607431768211455" )
+
+   end = format_to( buffer, buffer + sizeof(buffer), "eosio.token"_n, ' ', symbol_code{"EOS"}, ' ', symbol{"EOS", 4} );
+   CHECK_EQUAL( string(buffer, end), "eosio.token EOS 4,EOS" )
+
+   end = format_to( buffer, buffer + sizeof(buffer), asset{-10000, symbol{"EOS", 4}}, ' ', extended_asset{asset{1, symbol{"SYS", 0}}, "eosio"_n} );
+   CHECK_EQUAL( string(buffer, end), "-1.0000 EOS 1 SYS@eosio" )
+
+   // Note:
+   // Output that does not fit is truncated at the end of the buffer
+   end = format_to( buffer, buffer + 5, "abc", "def" );
+   CHECK_EQUAL( string(buffer, end), "abcde" )
+   end = format_to( buffer, buffer + 8, "from: ", "eosio.token"_n );
+   CHECK_EQUAL( string(buffer, end), "from: eo" )
+   end = format_to( buffer, buffer + 4, asset{10000, symbol{"EOS", 4}} );
+   CHECK_EQUAL( string(buffer, end), "1.00" )
+   end = format_to( buffer, buffer + 3, 123456 );
+   CHECK_EQUAL( string(buffer, end), "123" )
+   end = format_to( buffer, buffer + 4, dashes{100} );
+   CHECK_EQUAL( string(buffer, end), "----" )
+
+   // a value of more than 128 characters that does not fit is left out
+   end = format_to( buffer, buffer + 8, "a", dashes{200}, "b" );
+   CHECK_EQUAL( string(buffer, end), "ab" )
+EOSIO_TEST_END
+
+// Definitions in `eosio.cdt/libraries/eosio/format.hpp`
+EOSIO_TEST_BEGIN(static_string_test)
+   // ----------------------
+   // static_string<N>
+   static_string<16> str;
+   CHECK_EQUAL( str.empty(), true )
+   CHECK_EQUAL( str.capacity(), 16 )
+   str.append( "alice" ).append( ' ', 7 );
+   CHECK_EQUAL( string(str.data(), str.size()), "alice 7" )
+   CHECK_EQUAL( strlen(str.c_str()), 7 )
+   str.append( " overflowing text" );
+   CHECK_EQUAL( std::string_view{str}, "alice 7 overflow" )
+   str.clear();
+   CHECK_EQUAL( str.size(), 0 )
+
+   // ---------------------------------
+   // static_string<N> format(Args...)
+   CHECK_EQUAL( std::string_view{format("transfer ", asset{5, symbol{"EOS", 2}}, " to ", "bob"_n)}, "transfer 0.05 EOS to bob" )
+   CHECK_EQUAL( std::string_view{format<4>("truncated")}, "trun" )
+   CHECK_EQUAL( std::string_view{format(format<8>("nested"), '!')}, "nested!" )
+
+   CHECK_PRINT( "overdrawn 1.0000 EOS", []() { format("overdrawn ", asset{10000, symbol{"EOS", 4}}).print(); } )
+
+   // ------------------------------------------------
+   // void check(bool, const static_string<N>&)
+   CHECK_ASSERT( "overdrawn 1.0000 EOS", []() { eosio::check(false, format<32>("overdrawn ", asset{10000, symbol{"EOS", 4}})); } )
+
+   // ----------------------------
+   // auto defer_format(Args...)
+   CHECK_ASSERT( "overdrawn 1.0000 EOS", []() { asset a{10000, symbol{"EOS", 4}}; eosio::check(false, eosio::defer_format("overdrawn ", a)); } )
+   CHECK_EQUAL( std::string_view{eosio::defer_format<8>("deferred", 1)()}, "deferred" )
+
+   // strings are viewed rather than copied, so building the callable does not allocate
+   const string memo( 40, 'm' );
+   eosio::check( true, eosio::defer_format( "memo: ", memo ) );
+   auto message = eosio::defer_format( "memo: ", memo, ' ', asset{5, symbol{"EOS", 0}} );
+   CHECK_EQUAL( std::string_view{message()}, "memo: " + memo + " 5 EOS" )
+   CHECK_EQUAL( sizeof(eosio::defer_format( memo )), sizeof(std::string_view) )
+   CHECK_EQUAL( sizeof(eosio::defer_format( asset{5, symbol{"EOS", 0}} )), sizeof(asset) )
+   CHECK_ASSERT( "memo: mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm", [&]() { eosio::check( false, eosio::defer_format( "memo: ", memo ) ); } )
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(format_to_test);
+   EOSIO_TEST(static_string_test);
+   return has_failed();
+}
@@ -368,6 +368,44 @@ EOSIO_TEST_BEGIN(name_type_test)
    CHECK_EQUAL( name{"zzzzzzzzzzzzj"}, "zzzzzzzzzzzzj"_n )
 EOSIO_TEST_END
 
+// Definitions in `eosio.cdt/libraries/eosio/name.hpp`
+EOSIO_TEST_BEGIN(name_bulk_test)
+   // --------------------------------------------------------------------
+   // char* names_to_string(const name*, const name*, char*, char*, char)
+   static constexpr uint8_t buffer_size{64};
+   char buffer[buffer_size]{};
+
+   const name names[]{"eosio"_n, "eosio.token"_n, "a"_n, "zzzzzzzzzzzzj"_n};
+   char* end = eosio::names_to_string( names, names + 4, buffer, buffer + sizeof(buffer) );
+   CHECK_EQUAL( string(buffer, end), "eosio,eosio.token,a,zzzzzzzzzzzzj" )
+   end = eosio::names_to_string( names, names + 2, buffer, buffer + sizeof(buffer), ' ' );
+   CHECK_EQUAL( string(buffer, end), "eosio eosio.token" )
+   CHECK_EQUAL( eosio::names_to_string( names, names, buffer, buffer + sizeof(buffer) ), buffer )
+
+   // Note:
+   // Nothing is written when the buffer is too small; the required end is returned instead
+   memset( buffer, 0, sizeof(buffer) );
+   CHECK_EQUAL( eosio::names_to_string( names, names + 2, buffer, buffer + 8 ), buffer + 17 )
+   CHECK_EQUAL( buffer[0], 0 )
+   CHECK_EQUAL( eosio::names_to_string( names, names + 2, buffer, buffer + sizeof(buffer), ',', true ), buffer + 17 )
+   CHECK_EQUAL( buffer[0], 0 )
+
+   // -----------------------------------------------------
+   // size_t parse_names(string_view, name*, size_t, char)
+   name parsed[4];
+   CHECK_EQUAL( eosio::parse_names( "eosio,eosio.token,a,zzzzzzzzzzzzj", parsed, 4 ), 4 )
+   CHECK_EQUAL( parsed[0], "eosio"_n )
+   CHECK_EQUAL( parsed[1], "eosio.token"_n )
+   CHECK_EQUAL( parsed[2], "a"_n )
+   CHECK_EQUAL( parsed[3], "zzzzzzzzzzzzj"_n )
+   CHECK_EQUAL( eosio::parse_names( "", parsed, 4 ), 0 )
+   CHECK_EQUAL( eosio::parse_names( "alice bob", parsed, 4, ' ' ), 2 )
+   CHECK_EQUAL( parsed[1], "bob"_n )
+
+   CHECK_ASSERT( "too many names for the provided buffer", ([]() {name n[1]; eosio::parse_names("a,b", n, 1);}) )
+   CHECK_ASSERT( "character is not in allowed character set for names", ([]() {name n[2]; eosio::parse_names("a,B", n, 2);}) )
+EOSIO_TEST_END
+
 int main(int argc, char* argv[]) {
    bool verbose = false;
    if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
@@ -376,5 +414,6 @@ int main(int argc, char* argv[]) {
    silence_output(!verbose);
 
    EOSIO_TEST(name_type_test);
+   EOSIO_TEST(name_bulk_test);
    return has_failed();
 }
@@ -0,0 +1,177 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <limits>
+
+#include <eosio/numeric.hpp>
+#include <eosio/tester.hpp>
+
+using std::numeric_limits;
+
+using eosio::int256;
+using eosio::ipow;
+using eosio::isqrt;
+using eosio::muldiv;
+using eosio::rounding;
+
+static constexpr uint64_t u64max = numeric_limits<uint64_t>::max(); // 18446744073709551615
+static constexpr int64_t  i64min = numeric_limits<int64_t>::min();  // -9223372036854775808
+static constexpr int64_t  i64max = numeric_limits<int64_t>::max();  //  9223372036854775807
+static constexpr uint128_t u128max = numeric_limits<uint128_t>::max();
+
+// Definitions in `eosio.cdt/libraries/eosio/numeric.hpp`
+EOSIO_TEST_BEGIN(muldiv_test)
+   // -------------------------------------------
+   // T muldiv(T, T, T, rounding), 64-bit words
+   CHECK_EQUAL( muldiv( uint64_t{10}, 3, 4 ), 7 )
+   CHECK_EQUAL( muldiv( uint64_t{10}, 3, 4, rounding::up ), 8 )
+   CHECK_EQUAL( muldiv( uint64_t{10}, 3, 4, rounding::nearest ), 8 )
+   CHECK_EQUAL( muldiv( uint64_t{10}, 1, 4, rounding::nearest ), 3 )
+   CHECK_EQUAL( muldiv( uint64_t{9}, 1, 4, rounding::nearest ), 2 )
+   CHECK_EQUAL( muldiv( uint64_t{12}, 3, 4, rounding::up ), 9 )
+
+   // the product exceeds 64 bits
+   CHECK_EQUAL( muldiv( u64max, u64max, u64max ), u64max )
+   CHECK_EQUAL( muldiv( u64max, 1000000, 1000001 ), 18446725626983924631ull )
+   CHECK_EQUAL( muldiv( uint64_t{10000000000000000000ull}, 3, 7, rounding::up ), 4285714285714285715ull )
+   CHECK_EQUAL( muldiv( uint64_t{1} << 63, 6, 4 ), 13835058055282163712ull )
+
+   // signed operands round toward negative and positive infinity
+   CHECK_EQUAL( muldiv( int64_t{-10}, 3, 4 ), -8 )
+   CHECK_EQUAL( muldiv( int64_t{-10}, 3, 4, rounding::up ), -7 )
+   CHECK_EQUAL( muldiv( int64_t{-10}, 3, 4, rounding::nearest ), -8 )
+   CHECK_EQUAL( muldiv( int64_t{10}, -3, -4 ), 7 )
+   CHECK_EQUAL( muldiv( int64_t{0}, -3, 4 ), 0 )
+   CHECK_EQUAL( muldiv( i64min, 1, 1 ), i64min )
+   CHECK_EQUAL( muldiv( i64max, i64max, i64max ), i64max )
+   CHECK_EQUAL( muldiv( int32_t{-7}, 2, 4 ), -4 )
+
+   CHECK_ASSERT( "divide by zero", []() { muldiv( uint64_t{1}, 1, 0 ); } )
+   CHECK_ASSERT( "muldiv overflow", []() { muldiv( u64max, 2, 1 ); } )
+   CHECK_ASSERT( "muldiv overflow", []() { muldiv( u64max, u64max, u64max - 1 ); } )
+   CHECK_ASSERT( "muldiv overflow", []() { muldiv( i64min, -1, 1 ); } )
+   CHECK_ASSERT( "muldiv overflow", []() { muldiv( uint32_t{1} << 31, 2, 1 ); } )
+
+   // ----------------------------------------
+   // T muldiv(T, T, T, rounding), 128 bits
+   CHECK_EQUAL( muldiv( u128max, u128max, u128max ) == u128max, true )
+   CHECK_EQUAL( muldiv( u128max, 2, 3 ) == ((uint128_t{0xaaaaaaaaaaaaaaaa} << 64) | 0xaaaaaaaaaaaaaaaa), true )
+   CHECK_EQUAL( muldiv( uint128_t{10}, 3, 4, rounding::up ) == 8, true )
+   CHECK_EQUAL( muldiv( int128_t{-10}, 3, 4 ) == -8, true )
+   CHECK_EQUAL( muldiv( int128_t{1} << 100, int128_t{1} << 100, int128_t{1} << 74 ) == int128_t{1} << 126, true )
+   CHECK_EQUAL( muldiv( uint128_t{u64max}, uint128_t{u64max} << 32, (uint128_t{1} << 64) | 1 ) == ((uint128_t{0xffffffff} << 64) | 0xfffffffd00000000), true )
+   CHECK_ASSERT( "muldiv overflow", []() { muldiv( int128_t{1} << 100, int128_t{1} << 100, int128_t{1} << 73 ); } )
+
+   CHECK_ASSERT( "muldiv overflow", []() { muldiv( u128max, 2, 1 ); } )
+   CHECK_ASSERT( "divide by zero", []() { muldiv( u128max, 2, 0 ); } )
+
+   // -----------------------------------
+   // usable in constant expressions
+   static_assert( muldiv( uint64_t{u64max}, 1000, 1001 ) == 18428315757951600014ull );
+   static_assert( muldiv( int64_t{-5}, 5, 10, rounding::nearest ) == -3 );
+EOSIO_TEST_END
+
+// Definitions in `eosio.cdt/libraries/eosio/numeric.hpp`
+EOSIO_TEST_BEGIN(int256_test)
+   // ---------------
+   // int256(T)
+   CHECK_EQUAL( int256{}, int256{0} )
+   CHECK_EQUAL( int256{-1}.word(3), u64max )
+   CHECK_EQUAL( int256{u64max}.word(1), 0 )
+   CHECK_EQUAL( int256{int128_t{-1}}.word(2), u64max )
+   CHECK_EQUAL( int256{u128max}.word(1), u64max )
+   CHECK_EQUAL( int256{u128max}.word(2), 0 )
+   CHECK_EQUAL( int256::min().is_negative(), true )
+   CHECK_EQUAL( int256::max().is_negative(), false )
+
+   // -------------------------
+   // arithmetic and ordering
+   const int256 big = int256{u128max} * int256{u64max};
+   CHECK_EQUAL( big.word(0), 1 )
+   CHECK_EQUAL( big.word(1), u64max )
+   CHECK_EQUAL( big.word(2), u64max - 1 )
+   CHECK_EQUAL( big.word(3), 0 )
+   CHECK_EQUAL( big / int256{u64max}, int256{u128max} )
+   CHECK_EQUAL( big / int256{u128max}, int256{u64max} )
+   CHECK_EQUAL( (big + int256{5}) % int256{u128max}, int256{5} )
+   CHECK_EQUAL( big - big, int256{0} )
+   CHECK_EQUAL( -big + big, int256{0} )
+   CHECK_EQUAL( int256{-7} / int256{2}, int256{-3} )
+   CHECK_EQUAL( int256{-7} % int256{2}, int256{-1} )
+   CHECK_EQUAL( int256{7} % int256{-2}, int256{1} )
+   CHECK_EQUAL( int256{-6} * int256{7}, int256{-42} )
+   CHECK_EQUAL( (-big) / int256{u64max}, -(big / int256{u64max}) )
+   CHECK_EQUAL( int256::min() / int256{1}, int256::min() )
+   CHECK_EQUAL( int256{-1} < int256{0}, true )
+   CHECK_EQUAL( int256::min() < int256::max(), true )
+   CHECK_EQUAL( big > int256{u128max}, true )
+   CHECK_EQUAL( -big < int256{i64min}, true )
+   CHECK_EQUAL( int256::max() + int256::min(), int256{-1} )
+
+   // ---------------------------
+   // explicit operator T()const
+   CHECK_EQUAL( static_cast<int64_t>(int256{i64min}), i64min )
+   CHECK_EQUAL( static_cast<uint64_t>(int256{u64max}), u64max )
+   CHECK_EQUAL( static_cast<uint128_t>(big / int256{u64max}) == u128max, true )
+   CHECK_ASSERT( "int256 overflow", []() { static_cast<int64_t>(int256{u64max}); } )
+   CHECK_ASSERT( "int256 overflow", []() { static_cast<uint64_t>(int256{-1}); } )
+
+   CHECK_ASSERT( "addition overflow", []() { int256::max() + int256{1}; } )
+   CHECK_ASSERT( "subtraction overflow", []() { int256::min() - int256{1}; } )
+   CHECK_ASSERT( "multiplication overflow", []() { int256{u128max} * int256{u128max}; } )
+   CHECK_ASSERT( "int256 overflow", []() { -int256::min(); } )
+   CHECK_ASSERT( "int256 overflow", []() { int256::min() / int256{-1}; } )
+   CHECK_ASSERT( "divide by zero", []() { int256{1} / int256{0}; } )
+
+   static_assert( int256{3} * int256{-4} == int256{-12} );
+EOSIO_TEST_END
+
+// Definitions in `eosio.cdt/libraries/eosio/numeric.hpp`
+EOSIO_TEST_BEGIN(isqrt_ipow_test)
+   // -----------
+   // T isqrt(T)
+   CHECK_EQUAL( isqrt( uint64_t{0} ), 0 )
+   CHECK_EQUAL( isqrt( uint64_t{1} ), 1 )
+   CHECK_EQUAL( isqrt( uint64_t{15} ), 3 )
+   CHECK_EQUAL( isqrt( uint64_t{16} ), 4 )
+   CHECK_EQUAL( isqrt( u64max ), 4294967295 )
+   CHECK_EQUAL( isqrt( int64_t{1000000} ), 1000 )
+   CHECK_EQUAL( isqrt( u128max ) == u64max, true )
+   CHECK_EQUAL( isqrt( uint128_t{u64max} * u64max ) == u64max, true )
+   CHECK_EQUAL( isqrt( uint128_t{u64max} * u64max - 1 ) == u64max - 1, true )
+   CHECK_ASSERT( "square root of a negative number", []() { isqrt( int64_t{-1} ); } )
+   static_assert( isqrt( 99u ) == 9 );
+
+   // -------------------------
+   // T ipow(T, uint32_t)
+   CHECK_EQUAL( ipow( uint64_t{10}, 19 ), 10000000000000000000ull )
+   CHECK_EQUAL( ipow( int64_t{-2}, 63 ), i64min )
+   CHECK_EQUAL( ipow( int64_t{-3}, 3 ), -27 )
+   CHECK_EQUAL( ipow( uint64_t{7}, 0 ), 1 )
+   CHECK_EQUAL( ipow( uint128_t{10}, 38 ) == uint128_t{10000000000000000000ull} * 10000000000000000000ull, true )
+   CHECK_EQUAL( ipow( int256{10}, 76 ) / ipow( int256{10}, 75 ), int256{10} )
+   CHECK_ASSERT( "multiplication overflow", []() { ipow( uint64_t{10}, 20 ); } )
+   CHECK_ASSERT( "multiplication overflow", []() { ipow( int64_t{2}, 63 ); } )
+   CHECK_ASSERT( "multiplication overflow", []() { ipow( int256{10}, 77 ); } )
+   CHECK_ASSERT( "multiplication overflow", []() { ipow( int256{2}, 256 ); } )
+   CHECK_EQUAL( ipow( int256{0}, 256 ), int256{0} )
+   CHECK_EQUAL( ipow( int64_t{0}, 256 ), 0 )
+   CHECK_EQUAL( ipow( int64_t{-1}, 1000001 ), -1 )
+   CHECK_EQUAL( ipow( uint64_t{1}, 4294967295u ), 1 )
+   static_assert( ipow( 3u, 4 ) == 81 );
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(muldiv_test);
+   EOSIO_TEST(int256_test);
+   EOSIO_TEST(isqrt_ipow_test);
+   return has_failed();
+}
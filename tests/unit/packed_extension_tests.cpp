@@ -0,0 +1,106 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <string>
+#include <vector>
+
+#include <eosio/datastream.hpp>
+#include <eosio/packed_extension.hpp>
+#include <eosio/tester.hpp>
+
+using std::string;
+using std::vector;
+
+using eosio::asset;
+using eosio::checksum256;
+using eosio::datastream;
+using eosio::name;
+using eosio::pack;
+using eosio::packed_extension;
+using eosio::symbol;
+
+struct profile {
+   string         nickname;
+   vector<string> links;
+
+   EOSLIB_SERIALIZE( profile, (nickname)(links) )
+};
+
+// The parameters of an action `update( name user, uint64_t id, packed_extension<profile> p )`
+struct update {
+   name                      user;
+   uint64_t                  id;
+   packed_extension<profile> p;
+
+   EOSLIB_SERIALIZE( update, (user)(id)(p) )
+};
+
+// Definitions in `eosio.cdt/libraries/eosio/packed_extension.hpp`
+EOSIO_TEST_BEGIN(packed_extension_test)
+   const profile prof{ "alice", { "a.example", "b.example" } };
+   const vector<char> packed_prof = pack( prof );
+
+   // ------------------------------------------------
+   // packed_extension(), packed_extension(data, size)
+   constexpr packed_extension<profile> empty;
+   static_assert( !empty.has_value() && !empty );
+   CHECK_EQUAL( empty.size(), 0 )
+   CHECK_EQUAL( empty.value_or().nickname, string{} )
+   CHECK_ASSERT( "cannot get value of empty packed_extension", []() { packed_extension<profile>{}.value(); } )
+
+   const packed_extension<profile> view{ packed_prof.data(), packed_prof.size() };
+   CHECK_EQUAL( view.has_value(), true )
+   CHECK_EQUAL( view.data(), packed_prof.data() )
+   CHECK_EQUAL( view.value().nickname, prof.nickname )
+   CHECK_EQUAL( view.value().links, prof.links )
+   CHECK_EQUAL( view.value_or( profile{ "bob" } ).nickname, string{"alice"} )
+
+   // ---------------------------------------------------------------
+   // DataStream& operator>>(DataStream&, packed_extension<T>&)
+   // DataStream& operator<<(DataStream&, const packed_extension<T>&)
+   const vector<char> action_data = pack( std::make_tuple( "alice"_n, uint64_t{7}, prof ) );
+   datastream<const char*> ds{ action_data.data(), action_data.size() };
+   update upd;
+   ds >> upd;
+   CHECK_EQUAL( upd.user, "alice"_n )
+   CHECK_EQUAL( upd.id, 7 )
+   CHECK_EQUAL( ds.remaining(), 0 )
+   CHECK_EQUAL( upd.p.data(), action_data.data() + 16 )
+   CHECK_EQUAL( upd.p.size(), packed_prof.size() )
+   CHECK_EQUAL( upd.p.value().links, prof.links )
+   CHECK_EQUAL( pack( upd ), action_data )
+
+   // an action sent by a client without the trailing field
+   const vector<char> old_data = pack( std::make_tuple( "alice"_n, uint64_t{7} ) );
+   datastream<const char*> old_ds{ old_data.data(), old_data.size() };
+   old_ds >> upd;
+   CHECK_EQUAL( upd.p.has_value(), false )
+   CHECK_EQUAL( pack( upd ), old_data )
+
+   // ---------------------------------------------
+   // packed_extension<T>::at<Preceding...>(data, size)
+   const auto at = packed_extension<profile>::at<name, uint64_t>( action_data.data(), action_data.size() );
+   CHECK_EQUAL( at.data(), action_data.data() + 16 )
+   CHECK_EQUAL( at.value().nickname, prof.nickname )
+   CHECK_EQUAL( (packed_extension<profile>::at<name, uint64_t>( old_data.data(), old_data.size() ).has_value()), false )
+   CHECK_ASSERT( "buffer ends before packed_extension", [&]() {
+      packed_extension<profile>::at<name, uint64_t, uint32_t>( old_data.data(), old_data.size() );
+   })
+
+   // offsets computed at compile time
+   static constexpr char buffer[70] = {};
+   static_assert( packed_extension<int>::at<asset, symbol, checksum256, bool, std::array<uint16_t, 3>>( buffer, sizeof(buffer) ).size() == 7 );
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(packed_extension_test);
+   return has_failed();
+}
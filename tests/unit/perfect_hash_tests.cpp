@@ -0,0 +1,176 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <eosio/contract.hpp>
+#include <eosio/dispatcher.hpp>
+#include <eosio/perfect_hash.hpp>
+#include <eosio/tester.hpp>
+
+using std::string;
+using std::vector;
+
+using eosio::name;
+using eosio::pack;
+using eosio::perfect_hash;
+using namespace eosio::native;
+
+// The first N names of three letters from a to p: aaa, aab, ... aap, aba, ...
+template<size_t N>
+constexpr std::array<uint64_t, N> three_letter_names() {
+   std::array<uint64_t, N> keys{};
+   for( size_t i = 0; i < N; ++i ) {
+      const char s[] = { char('a' + i / 256), char('a' + i / 16 % 16), char('a' + i % 16) };
+      keys[i] = name{ std::string_view{ s, 3 } }.value;
+   }
+   return keys;
+}
+
+// Definitions in `eosio.cdt/libraries/eosio/perfect_hash.hpp`
+EOSIO_TEST_BEGIN(perfect_hash_test)
+   // --------------------------------------
+   // perfect_hash(const uint64_t (&)[N])
+   // perfect_hash(const std::array<uint64_t, N>&)
+   // size_t find(uint64_t)const
+   static constexpr uint64_t actions[] = { "transfer"_n.value, "issue"_n.value, "retire"_n.value, "open"_n.value, "close"_n.value };
+   static constexpr perfect_hash table( actions );
+   static_assert( table.size() == 5 );
+   static_assert( table.table_size == 16 && table.bucket_count == 4 );
+   for( size_t i = 0; i < table.size(); ++i )
+      CHECK_EQUAL( table.find( actions[i] ), i )
+   CHECK_EQUAL( table.find( "create"_n.value ), 5 )
+   CHECK_EQUAL( table.find( 0 ), 5 )
+
+   static constexpr uint64_t one[] = { "transfer"_n.value };
+   static constexpr perfect_hash single( one );
+   static_assert( single.find( "transfer"_n.value ) == 0 && single.find( "issue"_n.value ) == 1 );
+
+   // as many actions as a large contract has, and more
+   static constexpr perfect_hash large( three_letter_names<256>() );
+   static_assert( large.find( name{"app"}.value ) == 255 );
+
+   const perfect_hash many( three_letter_names<4096>() );
+   bool all_found = true;
+   for( size_t i = 0; i < many.size(); ++i )
+      all_found &= many.find( three_letter_names<4096>()[i] ) == i;
+   CHECK_EQUAL( all_found, true )
+   CHECK_EQUAL( many.find( "abcd"_n.value ), many.size() )
+
+   static constexpr uint64_t duplicated[] = { 1, 2, 3, 2 };
+   CHECK_ASSERT( "duplicate key in perfect_hash", []() { perfect_hash table( duplicated ); } )
+EOSIO_TEST_END
+
+// The action data read by the contract
+static vector<char> action_data;
+
+static void set_action_data( vector<char> data ) {
+   action_data = std::move( data );
+   intrinsics::set_intrinsic<intrinsics::action_data_size>([]() { return uint32_t(action_data.size()); });
+   intrinsics::set_intrinsic<intrinsics::read_action_data>([]( void* msg, uint32_t len ) {
+      const uint32_t size = std::min( len, uint32_t(action_data.size()) );
+      memcpy( msg, action_data.data(), size );
+      return size;
+   });
+}
+
+class [[eosio::contract]] shop : public eosio::contract {
+   public:
+      using contract::contract;
+
+      [[eosio::action]] void buy( name buyer, uint64_t id ) { eosio::print( "buy ", buyer, " ", id ); }
+      [[eosio::action]] void sell( name seller, string item ) { eosio::print( "sell ", seller, " ", item ); }
+      [[eosio::action]] void close() { eosio::print( "close" ); }
+};
+
+EOSIO_DISPATCH( shop, (buy)(sell)(close) )
+
+// Actions dispatched with eosio::dispatch, by code and name
+struct token_transfer {
+   static constexpr uint64_t get_account() { return "eosio.token"_n.value; }
+   static constexpr uint64_t get_name() { return "transfer"_n.value; }
+   uint64_t amount;
+   EOSLIB_SERIALIZE( token_transfer, (amount) )
+};
+
+struct other_transfer {
+   static constexpr uint64_t get_account() { return "other.token"_n.value; }
+   static constexpr uint64_t get_name() { return "transfer"_n.value; }
+   uint64_t amount;
+   EOSLIB_SERIALIZE( other_transfer, (amount) )
+};
+
+struct token_issue {
+   static constexpr uint64_t get_account() { return "eosio.token"_n.value; }
+   static constexpr uint64_t get_name() { return "issue"_n.value; }
+   uint64_t amount;
+   EOSLIB_SERIALIZE( token_issue, (amount) )
+};
+
+// get_account is not constexpr
+struct runtime_issue {
+   static uint64_t get_account() { return "eosio.token"_n.value; }
+   static uint64_t get_name() { return "issue"_n.value; }
+   uint64_t amount;
+   EOSLIB_SERIALIZE( runtime_issue, (amount) )
+};
+
+struct listener {
+   void on( const token_transfer& t ) { eosio::print( "token transfer ", t.amount ); }
+   void on( const other_transfer& t ) { eosio::print( "other transfer ", t.amount ); }
+   void on( const token_issue& t ) { eosio::print( "token issue ", t.amount ); }
+   void on( const runtime_issue& t ) { eosio::print( "runtime issue ", t.amount ); }
+};
+
+// Definitions in `eosio.cdt/libraries/eosio/dispatcher.hpp`
+EOSIO_TEST_BEGIN(dispatch_test)
+   // ----------------------------
+   // EOSIO_DISPATCH(TYPE, MEMBERS)
+   set_action_data( pack( std::make_tuple( "alice"_n, uint64_t{7} ) ) );
+   CHECK_PRINT( "buy alice 7", []() { apply( "shop"_n.value, "shop"_n.value, "buy"_n.value ); } )
+   set_action_data( pack( std::make_tuple( "bob"_n, string{"hat"} ) ) );
+   CHECK_PRINT( "sell bob hat", []() { apply( "shop"_n.value, "shop"_n.value, "sell"_n.value ); } )
+   set_action_data( {} );
+   CHECK_PRINT( "close", []() { apply( "shop"_n.value, "shop"_n.value, "close"_n.value ); } )
+   CHECK_PRINT( "", []() { apply( "shop"_n.value, "shop"_n.value, "open"_n.value ); } )
+   CHECK_PRINT( "", []() { apply( "shop"_n.value, "eosio.token"_n.value, "close"_n.value ); } )
+
+   // -------------------------------------------------------
+   // bool dispatch<Contract, Actions...>(uint64_t, uint64_t)
+   set_action_data( pack( uint64_t{5} ) );
+   const uint64_t eosio_token = "eosio.token"_n.value, other_token = "other.token"_n.value;
+   const uint64_t transfer = "transfer"_n.value, issue = "issue"_n.value;
+   CHECK_PRINT( "token transfer 5", [&]() {
+      CHECK_EQUAL( (eosio::dispatch<listener, token_transfer, other_transfer, token_issue>( eosio_token, transfer )), true )
+   })
+   CHECK_PRINT( "other transfer 5", [&]() {
+      CHECK_EQUAL( (eosio::dispatch<listener, token_transfer, other_transfer, token_issue>( other_token, transfer )), true )
+   })
+   CHECK_PRINT( "token issue 5", [&]() {
+      CHECK_EQUAL( (eosio::dispatch<listener, token_transfer, other_transfer, token_issue>( eosio_token, issue )), true )
+   })
+   CHECK_EQUAL( (eosio::dispatch<listener, token_transfer, other_transfer, token_issue>( other_token, issue )), false )
+
+   // actions without constexpr names are compared one after the other
+   static_assert( !eosio::detail::has_constexpr_action_name<runtime_issue>::value );
+   CHECK_PRINT( "runtime issue 5", [&]() {
+      CHECK_EQUAL( (eosio::dispatch<listener, token_transfer, runtime_issue>( eosio_token, issue )), true )
+   })
+   CHECK_EQUAL( (eosio::dispatch<listener, token_transfer, runtime_issue>( other_token, issue )), false )
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(perfect_hash_test);
+   EOSIO_TEST(dispatch_test);
+   return has_failed();
+}
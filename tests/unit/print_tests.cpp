@@ -1,3 +1,4 @@
+#include <eosio/asset.hpp>
 #include <eosio/eosio.hpp>
 #include <eosio/tester.hpp>
 
@@ -22,6 +23,46 @@ EOSIO_TEST_BEGIN(print_test)
    CHECK_PRINT("0xffffff9affffffffffffffffffffffff", [](){ eosio::print((int128_t)-102); });
 EOSIO_TEST_END
 
+EOSIO_TEST_BEGIN(print_buffer_test)
+   using eosio::name;
+   using eosio::print_buffer;
+
+   // variadic print formats into one buffer
+   CHECK_PRINT("abc 42 -7 true x alice", [](){ eosio::print("abc ", 42, ' ', -7, ' ', true, ' ', 'x', ' ', name{"alice"}); });
+   CHECK_PRINT("a=18446744073709551615 b=-9223372036854775808", [](){
+      eosio::print("a=", std::numeric_limits<uint64_t>::max(), " b=", std::numeric_limits<int64_t>::min());
+   });
+   CHECK_PRINT("str:view", [](){ eosio::print(std::string{"str"}, std::string_view{":view"}); });
+
+   // values without write_as_string keep their order
+   CHECK_PRINT("[0x0066000000000000]", [](){ eosio::print("[", (uint128_t)102, "]"); });
+
+   // output is held until flush or destruction
+   CHECK_PRINT("first second", [](){
+      print_buffer<> out;
+      out.print("first");
+      CHECK_EQUAL( out.size(), 5 );
+      out.print(' ', "second");
+   });
+   CHECK_PRINT("flushed", [](){
+      print_buffer<> out;
+      out.print("flushed");
+      CHECK_EQUAL( out.size(), 7 );
+      out.flush();
+      CHECK_EQUAL( out.size(), 0 );
+   });
+
+   // spills to the host when full, including values larger than the buffer
+   CHECK_PRINT("0123456789abcdefghijklmnopqrstuvwxyz", [](){
+      print_buffer<8> out;
+      out.print("0123", "4567", "89", "abcdefghijklmnop", "qrstuvwxyz");
+   });
+   CHECK_PRINT("1.0000 SYS|aaaaa", [](){
+      print_buffer<8> out;
+      out.print(eosio::asset{10000, eosio::symbol{"SYS", 4}}, '|', name{"aaaaa"});
+   });
+EOSIO_TEST_END
+
 int main(int argc, char** argv) {
    bool verbose = false;
    if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
@@ -30,5 +71,6 @@ int main(int argc, char** argv) {
    silence_output(!verbose);
 
    EOSIO_TEST(print_test);
+   EOSIO_TEST(print_buffer_test);
    return has_failed();
 }
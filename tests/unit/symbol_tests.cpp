@@ -217,6 +217,20 @@ EOSIO_TEST_BEGIN(symbol_type_test)
    CHECK_EQUAL( (symbol{} < symbol{sc1, 0}), true )
    CHECK_EQUAL( (symbol{} < symbol{sc2, 0}), true )
    CHECK_EQUAL( (symbol{} < symbol{sc3, 0}), true )
+
+   // ---------------------------------------------
+   // inline constexpr symbol operator""_sym()
+   static_assert( "4,EOS"_sym == symbol{"EOS", 4} );
+   CHECK_EQUAL( "0,A"_sym, (symbol{"A", 0}) )
+   CHECK_EQUAL( "18,ZZZZZZZ"_sym, (symbol{"ZZZZZZZ", 18}) )
+
+   CHECK_ASSERT( "symbol must be a precision of at most 18 and a code separated by a comma", []() {eosio::detail::parse_symbol("EOS");} )
+   CHECK_ASSERT( "symbol must be a precision of at most 18 and a code separated by a comma", []() {eosio::detail::parse_symbol(",EOS");} )
+   CHECK_ASSERT( "symbol must be a precision of at most 18 and a code separated by a comma", []() {eosio::detail::parse_symbol("100,EOS");} )
+   CHECK_ASSERT( "precision of symbol must be a number", []() {eosio::detail::parse_symbol("x,EOS");} )
+   CHECK_ASSERT( "precision of symbol must be at most 18", []() {eosio::detail::parse_symbol("19,EOS");} )
+   CHECK_ASSERT( "invalid symbol_code", []() {eosio::detail::parse_symbol("4,");} )
+   CHECK_ASSERT( "only uppercase letters allowed in symbol_code string", []() {eosio::detail::parse_symbol("4,eos");} )
 EOSIO_TEST_END
 
 // Definitions in `eosio.cdt/libraries/eosio/symbol.hpp`
@@ -41,6 +41,17 @@ EOSIO_TEST_BEGIN(system_test)
    CHECK_ASSERT("100", []() { check(false, 100);} );
    CHECK_ASSERT("18446744073709551615", []() { check(false, 18446744073709551615ULL);} );
    CHECK_ASSERT("18446744073709551615", []() { check(false, -1ULL);} );
+
+   // --------------------------------
+   // inline void check(bool, F&&)
+   CHECK_ASSERT( "asserted", []() { check(false, []() { return "asserted"; });} );
+   CHECK_ASSERT( "asserted", []() { check(false, []() { return string{"assert"} + "ed"; });} );
+   CHECK_ASSERT( "assert", []() { check(false, []() { return std::string_view{"asserted", 6}; });} );
+   {
+      bool invoked = false;
+      check(true, [&]() { invoked = true; return "unused"; });
+      CHECK_EQUAL( invoked, false )
+   }
 EOSIO_TEST_END
 
 int main(int argc, char* argv[]) {
@@ -0,0 +1,35 @@
+#include <eosio/eosio.hpp>
+
+using namespace eosio;
+
+// 256 actions, xaa through xpp, to exercise the dispatcher eosio-pp builds in apply.
+// tests/integration/dispatch_tests.cpp runs every handler. Compare `wasm-opcodecnt
+// dispatch_tests.wasm` against a build with -fno-post-pass to see the linear chain of
+// i64.eq tests replaced by a search over the action names.
+#define DISPATCH_ACTION(n) \
+   [[eosio::action]] void n() { print(#n); }
+
+#define DISPATCH_ROW(p)                                                   \
+   DISPATCH_ACTION(x##p##a) DISPATCH_ACTION(x##p##b) DISPATCH_ACTION(x##p##c) DISPATCH_ACTION(x##p##d) \
+   DISPATCH_ACTION(x##p##e) DISPATCH_ACTION(x##p##f) DISPATCH_ACTION(x##p##g) DISPATCH_ACTION(x##p##h) \
+   DISPATCH_ACTION(x##p##i) DISPATCH_ACTION(x##p##j) DISPATCH_ACTION(x##p##k) DISPATCH_ACTION(x##p##l) \
+   DISPATCH_ACTION(x##p##m) DISPATCH_ACTION(x##p##n) DISPATCH_ACTION(x##p##o) DISPATCH_ACTION(x##p##p)
+
+class [[eosio::contract]] dispatch_tests : public contract {
+   public:
+      using contract::contract;
+
+      DISPATCH_ROW(a) DISPATCH_ROW(b) DISPATCH_ROW(c) DISPATCH_ROW(d)
+      DISPATCH_ROW(e) DISPATCH_ROW(f) DISPATCH_ROW(g) DISPATCH_ROW(h)
+      DISPATCH_ROW(i) DISPATCH_ROW(j) DISPATCH_ROW(k) DISPATCH_ROW(l)
+      DISPATCH_ROW(m) DISPATCH_ROW(n) DISPATCH_ROW(o) DISPATCH_ROW(p)
+
+      [[eosio::on_notify("eosio.token::transfer")]]
+      void on_transfer() { print("transfer"); }
+
+      [[eosio::on_notify("eosio.token::issue")]]
+      void on_issue() { print("issue"); }
+
+      [[eosio::on_notify("*::transfer")]]
+      void on_any_transfer() { print("any transfer"); }
+};
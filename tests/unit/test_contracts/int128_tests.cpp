@@ -0,0 +1,68 @@
+#include <eosio/eosio.hpp>
+
+using namespace eosio;
+
+// The 128-bit division and multiplication builtins of librt, linked with
+// -use-rt. The bench actions run the operand shapes of token math in a loop;
+// compare the instruction counts of eosio-run, or the times of the contract
+// compiled to native code with eosio-aot:
+//
+//   $ eosio-run int128_tests.wasm actions.json
+//   $ eosio-aot int128_tests.wasm -o int128_tests && ./int128_tests actions.json
+CONTRACT int128_tests : public contract {
+   public:
+      using contract::contract;
+
+      // amount * price / precision, every operand under 2^64
+      ACTION benchmuldiv(uint64_t amount, uint64_t price, uint64_t precision, uint32_t iterations) {
+         uint64_t acc = 0;
+         for (uint32_t i = 0; i < iterations; i++)
+            acc += (uint64_t)((unsigned __int128)(amount + i) * price / precision);
+         print(acc);
+      }
+
+      // a 128-bit dividend by a 64-bit divisor
+      ACTION benchdiv64(uint64_t high, uint64_t low, uint64_t divisor, uint32_t iterations) {
+         uint64_t acc = 0;
+         for (uint32_t i = 0; i < iterations; i++)
+            acc += (uint64_t)(((unsigned __int128)high << 64 | (low + i)) / divisor);
+         print(acc);
+      }
+
+      // a 128-bit dividend by a divisor over 2^64
+      ACTION benchdiv128(uint64_t high, uint64_t low, uint64_t divisor_high, uint32_t iterations) {
+         uint64_t acc = 0;
+         for (uint32_t i = 0; i < iterations; i++)
+            acc += (uint64_t)(((unsigned __int128)high << 64 | (low + i)) / ((unsigned __int128)divisor_high << 64 | i));
+         print(acc);
+      }
+
+      // signed 64-bit values widened to __int128
+      ACTION benchsdiv(int64_t amount, int64_t divisor, uint32_t iterations) {
+         int64_t acc = 0;
+         for (uint32_t i = 0; i < iterations; i++)
+            acc += (int64_t)((__int128)(amount - i) % divisor + (__int128)(amount - i) / divisor);
+         print(acc);
+      }
+
+      // checks the quotient and remainder of every dividend by every divisor, the operands coming from
+      // the action data so that the builtins run instead of being folded at compile time
+      ACTION verify(std::vector<uint128_t> dividends, std::vector<uint128_t> divisors) {
+         for (uint128_t a : dividends) {
+            for (uint128_t b : divisors) {
+               check(b != 0, "divisor is zero");
+               const uint128_t q = a / b, r = a % b;
+               check(r < b, "remainder not less than the divisor");
+               check(q * b + r == a, "quotient and remainder do not add up to the dividend");
+
+               const __int128 sa = -(__int128)(a >> 1), sb = (__int128)(b >> 1 | 1);
+               const __int128 sq = sa / sb, sr = sa % sb;
+               check(sr <= 0 && -sr < sb, "signed remainder out of range");
+               check(sq * sb + sr == sa, "signed quotient and remainder do not add up to the dividend");
+
+               const uint128_t la = (uint64_t)a, lb = (uint64_t)b;
+               check(lb == 0 || la * lb / lb == la, "64x64 product");
+            }
+         }
+      }
+};
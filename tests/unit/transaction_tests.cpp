@@ -0,0 +1,126 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <string>
+#include <vector>
+
+#include <eosio/asset.hpp>
+#include <eosio/tester.hpp>
+#include <eosio/transaction.hpp>
+
+using std::string;
+using std::vector;
+
+using eosio::action;
+using eosio::action_wrapper;
+using eosio::asset;
+using eosio::name;
+using eosio::pack;
+using eosio::permission_level;
+using eosio::symbol;
+using eosio::time_point_sec;
+using eosio::transaction;
+using eosio::transaction_builder;
+using eosio::unpack;
+using namespace eosio::native;
+
+// The last deferred transaction sent
+static vector<char> sent;
+static uint128_t    sent_id = 0;
+static uint64_t     sent_payer = 0;
+
+static void capture_deferred_transactions() {
+   intrinsics::set_intrinsic<intrinsics::send_deferred>([]( const uint128_t& id, uint64_t payer, const char* trx, size_t size, uint32_t ) {
+      sent.assign( trx, trx + size );
+      sent_id = id;
+      sent_payer = payer;
+   });
+}
+
+struct token {
+   void transfer( name from, name to, asset quantity, string memo ) {}
+};
+
+using transfer_action = action_wrapper<"transfer"_n, &token::transfer>;
+
+// Definitions in `eosio.cdt/libraries/eosio/transaction.hpp`
+EOSIO_TEST_BEGIN(transaction_builder_test)
+   capture_deferred_transactions();
+   // for the default expiration of the transactions unpacked
+   intrinsics::set_intrinsic<intrinsics::current_time>([]() { return uint64_t{0}; });
+   const time_point_sec expiration{ 1000 };
+   const permission_level alice_active{ "alice"_n, "active"_n };
+   const asset quantity{ 10000, symbol{"EOS", 4} };
+
+   transaction expected{ expiration };
+   expected.ref_block_num = 1;
+   expected.ref_block_prefix = 2;
+   expected.delay_sec = 30;
+
+   // -----------------------------------------------------------------
+   // void transaction_builder::send(const uint128_t&, name, bool)
+   transaction_builder empty{ expiration };
+   empty.ref_block_num = 1;
+   empty.ref_block_prefix = 2;
+   empty.delay_sec = 30;
+   empty.send( 7, "alice"_n );
+   CHECK_EQUAL( sent, pack( expected ) )
+   CHECK_EQUAL( sent_id == 7, true )
+   CHECK_EQUAL( sent_payer, "alice"_n.value )
+
+   // ---------------------------------------------------------------------
+   // transaction_builder& add_action(const permission_level&, name, name, Args...)
+   // transaction_builder& add_action(const vector<permission_level>&, name, name, Args...)
+   // transaction_builder& add_action(const action_wrapper<Name, Action>&, Args...)
+   // transaction_builder& add_action(const action&)
+   transaction_builder builder{ expiration };
+   builder.ref_block_num = 1;
+   builder.ref_block_prefix = 2;
+   builder.delay_sec = 30;
+   builder.reserve( 1024 );
+   builder.add_action( alice_active, "eosio.token"_n, "transfer"_n, "alice"_n, "bob"_n, quantity, string{"one"} )
+          .add_action( vector<permission_level>{ alice_active, { "bob"_n, "owner"_n } }, "eosio.token"_n, "transfer"_n, "bob"_n, "alice"_n, quantity, string{"two"} )
+          .add_action( vector<permission_level>{}, "eosio.token"_n, "open"_n );
+   builder.add_action( transfer_action{ "eosio.token"_n, alice_active }, "alice"_n, "carol"_n, quantity, "three" );
+   builder.add_action( action{ alice_active, "eosio.token"_n, "transfer"_n, std::make_tuple( "alice"_n, "dave"_n, quantity, string( 1000, 'x' ) ) } );
+   CHECK_EQUAL( builder.size(), 5 )
+
+   expected.actions.emplace_back( alice_active, "eosio.token"_n, "transfer"_n, std::make_tuple( "alice"_n, "bob"_n, quantity, string{"one"} ) );
+   expected.actions.emplace_back( vector<permission_level>{ alice_active, { "bob"_n, "owner"_n } }, "eosio.token"_n, "transfer"_n, std::make_tuple( "bob"_n, "alice"_n, quantity, string{"two"} ) );
+   expected.actions.emplace_back( vector<permission_level>{}, "eosio.token"_n, "open"_n, std::make_tuple() );
+   expected.actions.emplace_back( alice_active, "eosio.token"_n, "transfer"_n, std::make_tuple( "alice"_n, "carol"_n, quantity, string{"three"} ) );
+   expected.actions.emplace_back( alice_active, "eosio.token"_n, "transfer"_n, std::make_tuple( "alice"_n, "dave"_n, quantity, string( 1000, 'x' ) ) );
+
+   builder.send( 8, "bob"_n, true );
+   CHECK_EQUAL( sent, pack( expected ) )
+   CHECK_EQUAL( unpack<transaction>( sent ).actions.size(), 5 )
+
+   // sent again with a larger header
+   builder.delay_sec = 1u << 30;
+   builder.max_net_usage_words = 1u << 30;
+   expected.delay_sec = 1u << 30;
+   expected.max_net_usage_words = 1u << 30;
+   builder.send( 8, "bob"_n, true );
+   CHECK_EQUAL( sent, pack( expected ) )
+
+   // as many actions as need a longer count
+   for( size_t i = 0; i < 200; ++i ) {
+      builder.add_action( alice_active, "eosio.token"_n, "open"_n, uint64_t{i} );
+      expected.actions.emplace_back( alice_active, "eosio.token"_n, "open"_n, uint64_t{i} );
+   }
+   builder.send( 8, "bob"_n, true );
+   CHECK_EQUAL( sent, pack( expected ) )
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(transaction_builder_test);
+   return has_failed();
+}
@@ -20,6 +20,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <functional>
+
 #include "src/binary.h"
 #include "src/common.h"
 #include "src/feature.h"
@@ -48,6 +50,10 @@ struct ReadBinaryOptions {
   bool read_debug_names = false;
   bool stop_on_first_error = true;
   bool fail_on_custom_section_error = true;
+  // When set, only the instructions of the function bodies it returns true for
+  // are read. The locals of the other bodies are read, their instructions are
+  // skipped.
+  std::function<bool(Index func_index)> read_function_body;
 };
 
 class BinaryReaderDelegate {
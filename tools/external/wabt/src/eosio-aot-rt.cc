@@ -0,0 +1,175 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Runtime linked into the executables and shared objects produced by
+// eosio-aot: it runs the contracts compiled by wasm2c against the emulated
+// intrinsics of eosio-run.
+
+#include "wasm2c/eosio-aot-rt.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/eosio-host.h"
+
+using namespace wabt;
+
+static_assert(sizeof(eosio_aot_value) == sizeof(eosio::HostValue),
+              "eosio_aot_value must match eosio::HostValue");
+
+static eosio::Host* s_host;
+
+static const char* TrapToString(wasm_rt_trap_t code) {
+  switch (code) {
+    case WASM_RT_TRAP_OOB: return "out of bounds memory access";
+    case WASM_RT_TRAP_INT_OVERFLOW: return "integer overflow";
+    case WASM_RT_TRAP_DIV_BY_ZERO: return "integer divide by zero";
+    case WASM_RT_TRAP_INVALID_CONVERSION: return "invalid conversion to integer";
+    case WASM_RT_TRAP_UNREACHABLE: return "unreachable executed";
+    case WASM_RT_TRAP_CALL_INDIRECT: return "indirect call signature mismatch";
+    case WASM_RT_TRAP_EXHAUSTION: return "call stack exhausted";
+    default: return "unknown trap";
+  }
+}
+
+// Runs a contract compiled to native code. Instructions are not counted.
+class AotEngine : public eosio::Engine {
+ public:
+  explicit AotEngine(const eosio_aot_contract* contract)
+      : contract_(contract) {}
+
+  uint8_t* memory_data() override { return contract_->memory()->data; }
+
+  uint64_t memory_size() override { return contract_->memory()->size; }
+
+  bool Apply(uint64_t receiver,
+             uint64_t code,
+             uint64_t action,
+             std::string* trap,
+             uint64_t* instructions) override {
+    contract_->reset();
+    wasm_rt_trap_t result = contract_->apply(receiver, code, action);
+    if (result == WASM_RT_TRAP_NONE) {
+      return true;
+    }
+    *trap = TrapToString(result);
+    return false;
+  }
+
+ private:
+  const eosio_aot_contract* contract_;
+};
+
+int eosio_aot_bind(const char* name, const char* signature) {
+  std::string error;
+  int binding = s_host->Bind(name, signature, &error);
+  if (binding < 0) {
+    fprintf(stderr, "%s\n", error.c_str());
+  }
+  return binding;
+}
+
+int eosio_aot_call(int binding,
+                   const eosio_aot_value* args,
+                   eosio_aot_value* result) {
+  return s_host->Call(binding,
+                      reinterpret_cast<const eosio::HostValue*>(args),
+                      reinterpret_cast<eosio::HostValue*>(result)) !=
+         eosio::HostStatus::Ok;
+}
+
+static void PrintUsage(const char* program) {
+  fprintf(stderr,
+          "usage: %s [-h] [-a ACCOUNT] actions\n"
+          "\n"
+          "  Run the actions of the JSON file against the contracts compiled "
+          "by eosio-aot,\n"
+          "  with the emulated intrinsics and output of eosio-run.\n"
+          "\n"
+          "options:\n"
+          "  -h, --help                  Print this help message\n"
+          "  -a, --account=ACCOUNT       Account the main contract is "
+          "deployed on, defaults to\n"
+          "                              the account of the first action\n",
+          program);
+}
+
+int eosio_aot_main(int argc,
+                   char** argv,
+                   const eosio_aot_contract* contracts,
+                   size_t count,
+                   int (*bind_imports)(void)) {
+  std::string account_name;
+  std::string actions_file;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-h" || arg == "--help") {
+      PrintUsage(argv[0]);
+      return 0;
+    } else if ((arg == "-a" || arg == "--account") && i + 1 < argc) {
+      account_name = argv[++i];
+    } else if (arg.compare(0, 10, "--account=") == 0) {
+      account_name = arg.substr(10);
+    } else if (actions_file.empty() && !arg.empty() && arg[0] != '-') {
+      actions_file = arg;
+    } else {
+      PrintUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (actions_file.empty()) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  std::vector<eosio::Action> actions;
+  if (!eosio::ReadActions(actions_file, &actions)) {
+    return 1;
+  }
+
+  uint64_t main_account = 0;
+  if (!account_name.empty()) {
+    if (!eosio::StringToName(account_name, &main_account)) {
+      fprintf(stderr, "invalid account name %s\n", account_name.c_str());
+      return 1;
+    }
+  } else if (!actions.empty()) {
+    main_account = actions[0].account;
+  }
+
+  eosio::Host host;
+  s_host = &host;
+  int result = 1;
+  if (bind_imports() == 0) {
+    for (size_t i = 0; i < count; ++i) {
+      uint64_t account = main_account;
+      if (contracts[i].account &&
+          !eosio::StringToName(contracts[i].account, &account)) {
+        fprintf(stderr, "invalid account name %s\n", contracts[i].account);
+        s_host = nullptr;
+        return 1;
+      }
+      host.Deploy(account,
+                  std::unique_ptr<eosio::Engine>(new AotEngine(&contracts[i])));
+    }
+    result = eosio::RunTransactions(&host, actions);
+  }
+  s_host = nullptr;
+  return result;
+}
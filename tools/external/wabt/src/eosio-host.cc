@@ -0,0 +1,2490 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "src/eosio-host.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <set>
+#include <tuple>
+
+#include "src/common.h"
+
+namespace wabt {
+namespace eosio {
+
+__extension__ typedef __int128 int128;
+__extension__ typedef unsigned __int128 uint128;
+
+#define CHECK_TRAP(expr)                   \
+  do {                                     \
+    HostStatus status_ = (expr);           \
+    if (status_ != HostStatus::Ok) {       \
+      return status_;                      \
+    }                                      \
+  } while (0)
+
+/*
+ * Names
+ */
+
+bool StringToName(const std::string& str, uint64_t* out) {
+  if (str.size() > 13) {
+    return false;
+  }
+  uint64_t value = 0;
+  for (size_t i = 0; i < str.size(); ++i) {
+    char c = str[i];
+    uint64_t v;
+    if (c == '.') {
+      v = 0;
+    } else if (c >= '1' && c <= '5') {
+      v = c - '1' + 1;
+    } else if (c >= 'a' && c <= 'z') {
+      v = c - 'a' + 6;
+    } else {
+      return false;
+    }
+    if (i < 12) {
+      value |= v << (59 - 5 * i);
+    } else if (v > 0x0f) {
+      return false;
+    } else {
+      value |= v;
+    }
+  }
+  *out = value;
+  return true;
+}
+
+std::string NameToString(uint64_t value) {
+  static const char charmap[] = ".12345abcdefghijklmnopqrstuvwxyz";
+  std::string str(13, '.');
+  for (int i = 0; i < 13; ++i) {
+    str[i] = i < 12 ? charmap[(value >> (59 - 5 * i)) & 0x1f]
+                    : charmap[value & 0x0f];
+  }
+  str.erase(str.find_last_not_of('.') + 1);
+  return str;
+}
+
+/*
+ * JSON
+ */
+
+struct JsonValue {
+  enum class Kind { Null, Bool, Number, String, Array, Object };
+
+  const JsonValue* Find(const std::string& key) const {
+    for (const auto& member : members) {
+      if (member.first == key) {
+        return &member.second;
+      }
+    }
+    return nullptr;
+  }
+
+  Kind kind = Kind::Null;
+  bool boolean = false;
+  std::string text;  // Contents of a string, or a number as written.
+  std::vector<JsonValue> items;
+  std::vector<std::pair<std::string, JsonValue>> members;
+};
+
+class JsonParser {
+ public:
+  JsonParser(const char* begin, const char* end)
+      : begin_(begin), p_(begin), end_(end) {}
+
+  bool Parse(JsonValue* out) {
+    if (!ParseValue(out, 0)) {
+      return false;
+    }
+    SkipSpace();
+    return p_ == end_ || Error("unexpected trailing characters");
+  }
+
+  const std::string& error() const { return error_; }
+
+ private:
+  static const int kMaxDepth = 64;
+
+  bool Error(const char* message) {
+    error_ = std::string(message) + " at offset " + std::to_string(p_ - begin_);
+    return false;
+  }
+
+  void SkipSpace() {
+    while (p_ != end_ &&
+           (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) {
+      ++p_;
+    }
+  }
+
+  bool Consume(char c) {
+    SkipSpace();
+    if (p_ != end_ && *p_ == c) {
+      ++p_;
+      return true;
+    }
+    return false;
+  }
+
+  bool ParseLiteral(const char* literal) {
+    size_t size = strlen(literal);
+    if (static_cast<size_t>(end_ - p_) < size || memcmp(p_, literal, size)) {
+      return Error("invalid literal");
+    }
+    p_ += size;
+    return true;
+  }
+
+  bool ParseHex4(uint32_t* out) {
+    if (end_ - p_ < 4) {
+      return Error("truncated escape sequence");
+    }
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i, ++p_) {
+      char c = *p_;
+      value <<= 4;
+      if (c >= '0' && c <= '9') {
+        value |= c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        value |= c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        value |= c - 'A' + 10;
+      } else {
+        return Error("invalid escape sequence");
+      }
+    }
+    *out = value;
+    return true;
+  }
+
+  bool ParseString(std::string* out) {
+    if (!Consume('"')) {
+      return Error("expected string");
+    }
+    while (p_ != end_ && *p_ != '"') {
+      char c = *p_++;
+      if (c != '\\') {
+        out->push_back(c);
+        continue;
+      }
+      if (p_ == end_) {
+        break;
+      }
+      switch (*p_++) {
+        case '"': out->push_back('"'); break;
+        case '\\': out->push_back('\\'); break;
+        case '/': out->push_back('/'); break;
+        case 'b': out->push_back('\b'); break;
+        case 'f': out->push_back('\f'); break;
+        case 'n': out->push_back('\n'); break;
+        case 'r': out->push_back('\r'); break;
+        case 't': out->push_back('\t'); break;
+        case 'u': {
+          uint32_t code = 0;
+          if (!ParseHex4(&code)) {
+            return false;
+          }
+          if (code >= 0xd800 && code < 0xdc00 && end_ - p_ >= 6 &&
+              p_[0] == '\\' && p_[1] == 'u') {
+            p_ += 2;
+            uint32_t low = 0;
+            if (!ParseHex4(&low)) {
+              return false;
+            }
+            code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+          }
+          if (code < 0x80) {
+            out->push_back(code);
+          } else if (code < 0x800) {
+            out->push_back(0xc0 | (code >> 6));
+            out->push_back(0x80 | (code & 0x3f));
+          } else if (code < 0x10000) {
+            out->push_back(0xe0 | (code >> 12));
+            out->push_back(0x80 | ((code >> 6) & 0x3f));
+            out->push_back(0x80 | (code & 0x3f));
+          } else {
+            out->push_back(0xf0 | (code >> 18));
+            out->push_back(0x80 | ((code >> 12) & 0x3f));
+            out->push_back(0x80 | ((code >> 6) & 0x3f));
+            out->push_back(0x80 | (code & 0x3f));
+          }
+          break;
+        }
+        default:
+          return Error("invalid escape sequence");
+      }
+    }
+    if (p_ == end_) {
+      return Error("unterminated string");
+    }
+    ++p_;
+    return true;
+  }
+
+  bool ParseValue(JsonValue* out, int depth) {
+    if (depth > kMaxDepth) {
+      return Error("nesting too deep");
+    }
+    SkipSpace();
+    if (p_ == end_) {
+      return Error("unexpected end of input");
+    }
+    switch (*p_) {
+      case '{':
+        ++p_;
+        out->kind = JsonValue::Kind::Object;
+        if (Consume('}')) {
+          return true;
+        }
+        do {
+          std::pair<std::string, JsonValue> member;
+          if (!ParseString(&member.first)) {
+            return false;
+          }
+          if (!Consume(':')) {
+            return Error("expected ':'");
+          }
+          if (!ParseValue(&member.second, depth + 1)) {
+            return false;
+          }
+          out->members.push_back(std::move(member));
+        } while (Consume(','));
+        return Consume('}') || Error("expected '}'");
+
+      case '[':
+        ++p_;
+        out->kind = JsonValue::Kind::Array;
+        if (Consume(']')) {
+          return true;
+        }
+        do {
+          out->items.emplace_back();
+          if (!ParseValue(&out->items.back(), depth + 1)) {
+            return false;
+          }
+        } while (Consume(','));
+        return Consume(']') || Error("expected ']'");
+
+      case '"':
+        out->kind = JsonValue::Kind::String;
+        return ParseString(&out->text);
+
+      case 't':
+        out->kind = JsonValue::Kind::Bool;
+        out->boolean = true;
+        return ParseLiteral("true");
+
+      case 'f':
+        out->kind = JsonValue::Kind::Bool;
+        return ParseLiteral("false");
+
+      case 'n':
+        return ParseLiteral("null");
+
+      default: {
+        const char* start = p_;
+        while (p_ != end_ && (isdigit(static_cast<unsigned char>(*p_)) ||
+                              *p_ == '-' || *p_ == '+' || *p_ == '.' ||
+                              *p_ == 'e' || *p_ == 'E')) {
+          ++p_;
+        }
+        if (p_ == start) {
+          return Error("unexpected character");
+        }
+        out->kind = JsonValue::Kind::Number;
+        out->text.assign(start, p_);
+        return true;
+      }
+    }
+  }
+
+  const char* begin_;
+  const char* p_;
+  const char* end_;
+  std::string error_;
+};
+
+/*
+ * Actions
+ */
+
+static bool ParseName(const JsonValue& json,
+                      const char* field,
+                      uint64_t* out,
+                      std::string* error) {
+  const JsonValue* value = json.Find(field);
+  if (!value || value->kind != JsonValue::Kind::String ||
+      !StringToName(value->text, out)) {
+    *error = std::string("missing or invalid name \"") + field + "\"";
+    return false;
+  }
+  return true;
+}
+
+static bool ParseHex(const std::string& hex, std::vector<uint8_t>* out) {
+  if (hex.size() % 2) {
+    return false;
+  }
+  for (size_t i = 0; i < hex.size(); i += 2) {
+    uint8_t byte = 0;
+    for (size_t j = i; j < i + 2; ++j) {
+      char c = hex[j];
+      byte <<= 4;
+      if (c >= '0' && c <= '9') {
+        byte |= c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        byte |= c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        byte |= c - 'A' + 10;
+      } else {
+        return false;
+      }
+    }
+    out->push_back(byte);
+  }
+  return true;
+}
+
+static bool ParseAction(const JsonValue& json, Action* out, std::string* error) {
+  if (json.kind != JsonValue::Kind::Object) {
+    *error = "expected an action object";
+    return false;
+  }
+  if (!ParseName(json, "account", &out->account, error) ||
+      !ParseName(json, "name", &out->name, error)) {
+    return false;
+  }
+  if (const JsonValue* authorization = json.Find("authorization")) {
+    if (authorization->kind != JsonValue::Kind::Array) {
+      *error = "\"authorization\" must be an array";
+      return false;
+    }
+    for (const JsonValue& level : authorization->items) {
+      Permission permission;
+      if (!ParseName(level, "actor", &permission.actor, error) ||
+          !ParseName(level, "permission", &permission.permission, error)) {
+        return false;
+      }
+      out->authorization.push_back(permission);
+    }
+  }
+  if (const JsonValue* data = json.Find("data")) {
+    if (data->kind != JsonValue::Kind::String ||
+        !ParseHex(data->text, &out->data)) {
+      *error = "\"data\" must be a hex string";
+      return false;
+    }
+  }
+  return true;
+}
+
+// Reads a whole file, without depending on libwabt so that the host can be
+// linked into the runtime of eosio-aot.
+static bool ReadWholeFile(const std::string& filename,
+                          std::vector<uint8_t>* out) {
+  FILE* file = fopen(filename.c_str(), "rb");
+  if (!file) {
+    fprintf(stderr, "unable to read file %s\n", filename.c_str());
+    return false;
+  }
+  uint8_t buffer[4096];
+  size_t count;
+  while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    out->insert(out->end(), buffer, buffer + count);
+  }
+  bool ok = !ferror(file);
+  fclose(file);
+  if (!ok) {
+    fprintf(stderr, "error reading file %s\n", filename.c_str());
+  }
+  return ok;
+}
+
+bool ReadActions(const std::string& filename, std::vector<Action>* out) {
+  std::vector<uint8_t> file_data;
+  if (!ReadWholeFile(filename, &file_data)) {
+    return false;
+  }
+  const char* begin = reinterpret_cast<const char*>(file_data.data());
+  JsonParser parser(begin, begin + file_data.size());
+  JsonValue json;
+  if (!parser.Parse(&json)) {
+    fprintf(stderr, "%s: %s\n", filename.c_str(), parser.error().c_str());
+    return false;
+  }
+  if (json.kind != JsonValue::Kind::Array) {
+    fprintf(stderr, "%s: expected an array of actions\n", filename.c_str());
+    return false;
+  }
+  for (size_t i = 0; i < json.items.size(); ++i) {
+    Action action;
+    std::string error;
+    if (!ParseAction(json.items[i], &action, &error)) {
+      fprintf(stderr, "%s: action %zu: %s\n", filename.c_str(), i,
+              error.c_str());
+      return false;
+    }
+    out->push_back(std::move(action));
+  }
+  return true;
+}
+
+// Reads the binary serialization of an action, as passed to send_inline.
+static bool UnpackAction(const uint8_t* data, size_t size, Action* out) {
+  const uint8_t* end = data + size;
+  auto read_u64 = [&](uint64_t* value) {
+    if (end - data < 8) {
+      return false;
+    }
+    memcpy(value, data, 8);
+    data += 8;
+    return true;
+  };
+  auto read_varuint32 = [&](uint32_t* value) {
+    *value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+      if (data == end) {
+        return false;
+      }
+      uint8_t byte = *data++;
+      *value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  uint32_t count;
+  if (!read_u64(&out->account) || !read_u64(&out->name) ||
+      !read_varuint32(&count)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < count; ++i) {
+    Permission permission;
+    if (!read_u64(&permission.actor) || !read_u64(&permission.permission)) {
+      return false;
+    }
+    out->authorization.push_back(permission);
+  }
+  if (!read_varuint32(&count) || static_cast<size_t>(end - data) != count) {
+    return false;
+  }
+  out->data.assign(data, end);
+  return true;
+}
+
+/*
+ * Hashing
+ */
+
+static inline uint32_t Rotl32(uint32_t x, int n) {
+  return (x << n) | (x >> (32 - n));
+}
+
+static inline uint32_t Rotr32(uint32_t x, int n) {
+  return (x >> n) | (x << (32 - n));
+}
+
+static inline uint64_t Rotr64(uint64_t x, int n) {
+  return (x >> n) | (x << (64 - n));
+}
+
+// Appends the Merkle-Damgard padding, ending with the message size in bits.
+static std::vector<uint8_t> PadMessage(const uint8_t* data,
+                                       size_t size,
+                                       size_t block_size,
+                                       bool big_endian) {
+  const size_t length_size = block_size / 8;
+  std::vector<uint8_t> message(data, data + size);
+  message.push_back(0x80);
+  while (message.size() % block_size != block_size - length_size) {
+    message.push_back(0);
+  }
+  uint64_t bits = static_cast<uint64_t>(size) * 8;
+  for (size_t i = 0; i < length_size; ++i) {
+    size_t shift = big_endian ? length_size - 1 - i : i;
+    message.push_back(shift < 8 ? static_cast<uint8_t>(bits >> (8 * shift)) : 0);
+  }
+  return message;
+}
+
+static inline uint32_t LoadBigEndian32(const uint8_t* p) {
+  return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+         (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+static inline uint64_t LoadBigEndian64(const uint8_t* p) {
+  return (uint64_t(LoadBigEndian32(p)) << 32) | LoadBigEndian32(p + 4);
+}
+
+static const uint64_t s_sha512_k[80] = {
+    0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f,
+    0xe9b5dba58189dbbc, 0x3956c25bf348b538, 0x59f111f1b605d019,
+    0x923f82a4af194f9b, 0xab1c5ed5da6d8118, 0xd807aa98a3030242,
+    0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
+    0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235,
+    0xc19bf174cf692694, 0xe49b69c19ef14ad2, 0xefbe4786384f25e3,
+    0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65, 0x2de92c6f592b0275,
+    0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+    0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f,
+    0xbf597fc7beef0ee4, 0xc6e00bf33da88fc2, 0xd5a79147930aa725,
+    0x06ca6351e003826f, 0x142929670a0e6e70, 0x27b70a8546d22ffc,
+    0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
+    0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6,
+    0x92722c851482353b, 0xa2bfe8a14cf10364, 0xa81a664bbc423001,
+    0xc24b8b70d0f89791, 0xc76c51a30654be30, 0xd192e819d6ef5218,
+    0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8,
+    0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99,
+    0x34b0bcb5e19b48a8, 0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb,
+    0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3, 0x748f82ee5defb2fc,
+    0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+    0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915,
+    0xc67178f2e372532b, 0xca273eceea26619c, 0xd186b8c721c0c207,
+    0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178, 0x06f067aa72176fba,
+    0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b,
+    0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc,
+    0x431d67c49c100d4c, 0x4cc5d4becb3e42b6, 0x597f299cfc657e2a,
+    0x5fcb6fab3ad6faec, 0x6c44198c4a475817};
+
+static const uint64_t s_sha512_iv[8] = {
+    0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b,
+    0xa54ff53a5f1d36f1, 0x510e527fade682d1, 0x9b05688c2b3e6c1f,
+    0x1f83d9abfb41bd6b, 0x5be0cd19137e2179};
+
+// The SHA-256 constants and initial values are the leading 32 bits of the
+// SHA-512 ones.
+static void Sha256(const uint8_t* data, size_t size, uint8_t* digest) {
+  uint32_t h[8];
+  for (int i = 0; i < 8; ++i) {
+    h[i] = s_sha512_iv[i] >> 32;
+  }
+  std::vector<uint8_t> message = PadMessage(data, size, 64, true);
+  for (size_t block = 0; block < message.size(); block += 64) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+      w[i] = LoadBigEndian32(&message[block + 4 * i]);
+    }
+    for (int i = 16; i < 64; ++i) {
+      uint32_t s0 = Rotr32(w[i - 15], 7) ^ Rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+      uint32_t s1 = Rotr32(w[i - 2], 17) ^ Rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+      w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3];
+    uint32_t e = h[4], f = h[5], g = h[6], k = h[7];
+    for (int i = 0; i < 64; ++i) {
+      uint32_t s1 = Rotr32(e, 6) ^ Rotr32(e, 11) ^ Rotr32(e, 25);
+      uint32_t t1 = k + s1 + ((e & f) ^ (~e & g)) +
+                    static_cast<uint32_t>(s_sha512_k[i] >> 32) + w[i];
+      uint32_t s0 = Rotr32(a, 2) ^ Rotr32(a, 13) ^ Rotr32(a, 22);
+      uint32_t t2 = s0 + ((a & b) ^ (a & c) ^ (b & c));
+      k = g; g = f; f = e; e = d + t1;
+      d = c; c = b; b = a; a = t1 + t2;
+    }
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+    h[4] += e; h[5] += f; h[6] += g; h[7] += k;
+  }
+  for (int i = 0; i < 32; ++i) {
+    digest[i] = h[i / 4] >> (24 - 8 * (i % 4));
+  }
+}
+
+static void Sha512(const uint8_t* data, size_t size, uint8_t* digest) {
+  uint64_t h[8];
+  std::copy(s_sha512_iv, s_sha512_iv + 8, h);
+  std::vector<uint8_t> message = PadMessage(data, size, 128, true);
+  for (size_t block = 0; block < message.size(); block += 128) {
+    uint64_t w[80];
+    for (int i = 0; i < 16; ++i) {
+      w[i] = LoadBigEndian64(&message[block + 8 * i]);
+    }
+    for (int i = 16; i < 80; ++i) {
+      uint64_t s0 = Rotr64(w[i - 15], 1) ^ Rotr64(w[i - 15], 8) ^ (w[i - 15] >> 7);
+      uint64_t s1 = Rotr64(w[i - 2], 19) ^ Rotr64(w[i - 2], 61) ^ (w[i - 2] >> 6);
+      w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint64_t a = h[0], b = h[1], c = h[2], d = h[3];
+    uint64_t e = h[4], f = h[5], g = h[6], k = h[7];
+    for (int i = 0; i < 80; ++i) {
+      uint64_t s1 = Rotr64(e, 14) ^ Rotr64(e, 18) ^ Rotr64(e, 41);
+      uint64_t t1 = k + s1 + ((e & f) ^ (~e & g)) + s_sha512_k[i] + w[i];
+      uint64_t s0 = Rotr64(a, 28) ^ Rotr64(a, 34) ^ Rotr64(a, 39);
+      uint64_t t2 = s0 + ((a & b) ^ (a & c) ^ (b & c));
+      k = g; g = f; f = e; e = d + t1;
+      d = c; c = b; b = a; a = t1 + t2;
+    }
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+    h[4] += e; h[5] += f; h[6] += g; h[7] += k;
+  }
+  for (int i = 0; i < 64; ++i) {
+    digest[i] = h[i / 8] >> (56 - 8 * (i % 8));
+  }
+}
+
+static void Sha1(const uint8_t* data, size_t size, uint8_t* digest) {
+  uint32_t h[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+  std::vector<uint8_t> message = PadMessage(data, size, 64, true);
+  for (size_t block = 0; block < message.size(); block += 64) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; ++i) {
+      w[i] = LoadBigEndian32(&message[block + 4 * i]);
+    }
+    for (int i = 16; i < 80; ++i) {
+      w[i] = Rotl32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; ++i) {
+      uint32_t f, k;
+      if (i < 20) {
+        f = (b & c) | (~b & d);
+        k = 0x5a827999;
+      } else if (i < 40) {
+        f = b ^ c ^ d;
+        k = 0x6ed9eba1;
+      } else if (i < 60) {
+        f = (b & c) | (b & d) | (c & d);
+        k = 0x8f1bbcdc;
+      } else {
+        f = b ^ c ^ d;
+        k = 0xca62c1d6;
+      }
+      uint32_t t = Rotl32(a, 5) + f + e + k + w[i];
+      e = d; d = c; c = Rotl32(b, 30); b = a; a = t;
+    }
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+  }
+  for (int i = 0; i < 20; ++i) {
+    digest[i] = h[i / 4] >> (24 - 8 * (i % 4));
+  }
+}
+
+static void Ripemd160(const uint8_t* data, size_t size, uint8_t* digest) {
+  static const uint8_t r[80] = {
+      0, 1, 2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15,
+      7, 4, 13, 1,  10, 6,  15, 3,  12, 0,  9,  5,  2,  14, 11, 8,
+      3, 10, 14, 4, 9,  15, 8,  1,  2,  7,  0,  6,  13, 11, 5,  12,
+      1, 9, 11, 10, 0,  8,  12, 4,  13, 3,  7,  15, 14, 5,  6,  2,
+      4, 0, 5,  9,  7,  12, 2,  10, 14, 1,  3,  8,  11, 6,  15, 13};
+  static const uint8_t rr[80] = {
+      5,  14, 7,  0, 9, 2,  11, 4,  13, 6,  15, 8,  1,  10, 3,  12,
+      6,  11, 3,  7, 0, 13, 5,  10, 14, 15, 8,  12, 4,  9,  1,  2,
+      15, 5,  1,  3, 7, 14, 6,  9,  11, 8,  12, 2,  10, 0,  4,  13,
+      8,  6,  4,  1, 3, 11, 15, 0,  5,  12, 2,  13, 9,  7,  10, 14,
+      12, 15, 10, 4, 1, 5,  8,  7,  6,  2,  13, 14, 0,  3,  9,  11};
+  static const uint8_t s[80] = {
+      11, 14, 15, 12, 5,  8,  7,  9,  11, 13, 14, 15, 6,  7,  9,  8,
+      7,  6,  8,  13, 11, 9,  7,  15, 7,  12, 15, 9,  11, 7,  13, 12,
+      11, 13, 6,  7,  14, 9,  13, 15, 14, 8,  13, 6,  5,  12, 7,  5,
+      11, 12, 14, 15, 14, 15, 9,  8,  9,  14, 5,  6,  8,  6,  5,  12,
+      9,  15, 5,  11, 6,  8,  13, 12, 5,  12, 13, 14, 11, 8,  5,  6};
+  static const uint8_t ss[80] = {
+      8,  9,  9,  11, 13, 15, 15, 5,  7,  7,  8,  11, 14, 14, 12, 6,
+      9,  13, 15, 7,  12, 8,  9,  11, 7,  7,  12, 7,  6,  15, 13, 11,
+      9,  7,  15, 11, 8,  6,  6,  14, 12, 13, 5,  14, 13, 13, 7,  5,
+      15, 5,  8,  11, 14, 14, 6,  14, 6,  9,  12, 9,  12, 5,  15, 8,
+      8,  5,  12, 9,  12, 5,  14, 6,  8,  13, 6,  5,  15, 13, 11, 11};
+  static const uint32_t k[5] = {0x00000000, 0x5a827999, 0x6ed9eba1,
+                                0x8f1bbcdc, 0xa953fd4e};
+  static const uint32_t kk[5] = {0x50a28be6, 0x5c4dd124, 0x6d703ef3,
+                                 0x7a6d76e9, 0x00000000};
+  auto f = [](int j, uint32_t x, uint32_t y, uint32_t z) -> uint32_t {
+    switch (j / 16) {
+      case 0: return x ^ y ^ z;
+      case 1: return (x & y) | (~x & z);
+      case 2: return (x | ~y) ^ z;
+      case 3: return (x & z) | (y & ~z);
+      default: return x ^ (y | ~z);
+    }
+  };
+
+  uint32_t h[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+  std::vector<uint8_t> message = PadMessage(data, size, 64, false);
+  for (size_t block = 0; block < message.size(); block += 64) {
+    uint32_t x[16];
+    memcpy(x, &message[block], 64);
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    uint32_t aa = a, bb = b, cc = c, dd = d, ee = e;
+    for (int j = 0; j < 80; ++j) {
+      uint32_t t = Rotl32(a + f(j, b, c, d) + x[r[j]] + k[j / 16], s[j]) + e;
+      a = e; e = d; d = Rotl32(c, 10); c = b; b = t;
+      t = Rotl32(aa + f(79 - j, bb, cc, dd) + x[rr[j]] + kk[j / 16], ss[j]) + ee;
+      aa = ee; ee = dd; dd = Rotl32(cc, 10); cc = bb; bb = t;
+    }
+    uint32_t t = h[1] + c + dd;
+    h[1] = h[2] + d + ee;
+    h[2] = h[3] + e + aa;
+    h[3] = h[4] + a + bb;
+    h[4] = h[0] + b + cc;
+    h[0] = t;
+  }
+  memcpy(digest, h, 20);
+}
+
+/*
+ * Table store
+ */
+
+struct TableId {
+  uint64_t code;
+  uint64_t scope;
+  uint64_t table;
+
+  bool operator<(const TableId& other) const {
+    return std::tie(code, scope, table) <
+           std::tie(other.code, other.scope, other.table);
+  }
+};
+
+struct Row {
+  uint64_t payer;
+  std::vector<uint8_t> value;
+};
+
+typedef std::map<uint64_t, Row> PrimaryTable;
+
+// A secondary key, with its words arranged so that comparing them in order
+// gives the ordering of the index.
+struct SecondaryKey {
+  bool operator<(const SecondaryKey& other) const { return order < other.order; }
+  bool operator==(const SecondaryKey& other) const {
+    return order == other.order;
+  }
+
+  std::array<uint64_t, 4> order;
+  std::array<uint8_t, 32> bytes;
+};
+
+typedef std::set<std::pair<SecondaryKey, uint64_t>> SecondarySet;
+
+struct SecondaryTable {
+  SecondarySet by_secondary;
+  std::map<uint64_t, std::pair<SecondaryKey, uint64_t>> by_primary;  // key, payer
+};
+
+enum class KeyKind { U64, U128, U256, Double, LongDouble };
+
+struct SecondaryIndexInfo {
+  const char* name;
+  KeyKind kind;
+  uint32_t size;
+};
+
+static const SecondaryIndexInfo s_secondary_indices[] = {
+    {"idx64", KeyKind::U64, 8},
+    {"idx128", KeyKind::U128, 16},
+    {"idx256", KeyKind::U256, 32},
+    {"idx_double", KeyKind::Double, 8},
+    {"idx_long_double", KeyKind::LongDouble, 16},
+};
+
+static const int kSecondaryIndexCount = WABT_ARRAY_SIZE(s_secondary_indices);
+
+static bool MakeSecondaryKey(const SecondaryIndexInfo& info,
+                             const uint8_t* bytes,
+                             SecondaryKey* out) {
+  const uint64_t kSign = uint64_t(1) << 63;
+  uint64_t words[4] = {0, 0, 0, 0};
+  memcpy(words, bytes, info.size);
+  out->order.fill(0);
+  out->bytes.fill(0);
+  memcpy(out->bytes.data(), bytes, info.size);
+  switch (info.kind) {
+    case KeyKind::U64:
+      out->order[0] = words[0];
+      break;
+    case KeyKind::U128:
+      out->order = {{words[1], words[0], 0, 0}};
+      break;
+    case KeyKind::U256:
+      out->order = {{words[1], words[0], words[3], words[2]}};
+      break;
+    case KeyKind::Double: {
+      uint64_t bits = words[0];
+      if ((bits & 0x7ff0000000000000) == 0x7ff0000000000000 &&
+          (bits & 0x000fffffffffffff)) {
+        return false;
+      }
+      if (bits == kSign) {
+        bits = 0;
+      }
+      out->order[0] = (bits & kSign) ? ~bits : bits | kSign;
+      break;
+    }
+    case KeyKind::LongDouble: {
+      uint64_t low = words[0], high = words[1];
+      if ((high & 0x7fff000000000000) == 0x7fff000000000000 &&
+          ((high & 0x0000ffffffffffff) || low)) {
+        return false;
+      }
+      if (high == kSign && low == 0) {
+        high = 0;
+      }
+      if (high & kSign) {
+        out->order = {{~high, ~low, 0, 0}};
+      } else {
+        out->order = {{high | kSign, low, 0, 0}};
+      }
+      break;
+    }
+  }
+  return true;
+}
+
+struct Database {
+  std::map<TableId, PrimaryTable> tables;
+  std::map<TableId, SecondaryTable> indices[kSecondaryIndexCount];
+};
+
+// Hands out the iterators of one kind of index for the duration of an action:
+// rows get iterators from 0 up, and the end of each table an iterator from -2
+// down.
+class IteratorCache {
+ public:
+  void Clear() {
+    rows_.clear();
+    row_iterators_.clear();
+    ends_.clear();
+    end_iterators_.clear();
+  }
+
+  int Row(const TableId& table, uint64_t primary) {
+    auto key = std::make_pair(table, primary);
+    auto it = row_iterators_.find(key);
+    if (it != row_iterators_.end()) {
+      return it->second;
+    }
+    int iterator = rows_.size();
+    rows_.push_back(key);
+    row_iterators_.emplace(key, iterator);
+    return iterator;
+  }
+
+  int End(const TableId& table) {
+    auto it = end_iterators_.find(table);
+    if (it != end_iterators_.end()) {
+      return it->second;
+    }
+    int iterator = -2 - static_cast<int>(ends_.size());
+    ends_.push_back(table);
+    end_iterators_.emplace(table, iterator);
+    return iterator;
+  }
+
+  const std::pair<TableId, uint64_t>* GetRow(int iterator) const {
+    if (iterator < 0 || static_cast<size_t>(iterator) >= rows_.size()) {
+      return nullptr;
+    }
+    return &rows_[iterator];
+  }
+
+  const TableId* GetEnd(int iterator) const {
+    size_t index = -2 - static_cast<int64_t>(iterator);
+    if (iterator > -2 || index >= ends_.size()) {
+      return nullptr;
+    }
+    return &ends_[index];
+  }
+
+ private:
+  std::vector<std::pair<TableId, uint64_t>> rows_;
+  std::map<std::pair<TableId, uint64_t>, int> row_iterators_;
+  std::vector<TableId> ends_;
+  std::map<TableId, int> end_iterators_;
+};
+
+/*
+ * Emulator
+ */
+
+struct Intrinsic;
+
+struct IntrinsicBinding {
+  const Intrinsic* intrinsic;  // nullptr if the import is not supported.
+  std::string name;
+};
+
+// Functions of the eosio allocators and the C++ operators calling them, skipped
+// to find the function that allocated, whether the names are demangled or not.
+static bool IsAllocatorFunction(const std::string& name) {
+  static const char* const kNames[] = {"malloc", "calloc", "realloc", "free"};
+  static const char* const kPrefixes[] = {
+      "operator new",           "operator delete",
+      "eosio::memory_manager",  "eosio::dsmalloc",
+      "eosio::sbrk",            "_Znw",
+      "_Zna",                   "_Zdl",
+      "_Zda",                   "_ZN5eosio14memory_manager",
+      "_ZN5eosio8dsmalloc",     "_ZN5eosio4sbrk",
+  };
+  for (const char* allocator : kNames) {
+    if (name == allocator) {
+      return true;
+    }
+  }
+  for (const char* prefix : kPrefixes) {
+    if (name.compare(0, strlen(prefix), prefix) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+class Emulator {
+ public:
+  int Bind(const std::string& name,
+           const std::string& signature,
+           std::string* error);
+  bool IsSupported(int binding) const {
+    return bindings_[binding].intrinsic != nullptr;
+  }
+  HostStatus Call(int binding, const HostValue* args, HostValue* out);
+
+  void Deploy(uint64_t account, std::unique_ptr<Engine> engine) {
+    contracts_[account] = std::move(engine);
+  }
+  void TraceAllocations(FILE* file) { alloc_trace_ = file; }
+  bool PushTransaction(const Action& action, std::vector<ApplyTrace>* traces);
+
+  /* system */
+  HostStatus EosioAssert(const HostValue* args, HostValue* out) {
+    std::string message;
+    if (args[0].i32) {
+      return HostStatus::Ok;
+    }
+    if (!ReadCString(args[1].i32, &message)) {
+      return OutOfBounds();
+    }
+    return Fail("assertion failure with message: " + message);
+  }
+
+  HostStatus EosioAssertMessage(const HostValue* args, HostValue* out) {
+    uint32_t ptr = args[1].i32, size = args[2].i32;
+    if (args[0].i32) {
+      return HostStatus::Ok;
+    }
+    if (!InBounds(ptr, size)) {
+      return OutOfBounds();
+    }
+    return Fail("assertion failure with message: " +
+                std::string(At(ptr), size));
+  }
+
+  HostStatus EosioAssertCode(const HostValue* args, HostValue* out) {
+    if (args[0].i32) {
+      return HostStatus::Ok;
+    }
+    return Fail("assertion failure with error code: " +
+                std::to_string(args[1].i64));
+  }
+
+  HostStatus EosioExit(const HostValue* args, HostValue* out) {
+    exited_ = true;
+    return HostStatus::Trap;
+  }
+
+  HostStatus Abort(const HostValue* args, HostValue* out) {
+    return Fail("abort() called");
+  }
+
+  HostStatus CurrentTime(const HostValue* args, HostValue* out) {
+    out->i64 = now_;
+    return HostStatus::Ok;
+  }
+
+  HostStatus IsFeatureActivated(const HostValue* args, HostValue* out) {
+    out->i32 = 0;
+    return HostStatus::Ok;
+  }
+
+  HostStatus GetSender(const HostValue* args, HostValue* out) {
+    out->i64 = sender_;
+    return HostStatus::Ok;
+  }
+
+  /* action */
+  HostStatus ReadActionData(const HostValue* args, HostValue* out) {
+    uint32_t ptr = args[0].i32, size = args[1].i32;
+    uint32_t data_size = action_->data.size();
+    if (size == 0) {
+      out->i32 = data_size;
+      return HostStatus::Ok;
+    }
+    size = std::min(size, data_size);
+    if (!InBounds(ptr, size)) {
+      return OutOfBounds();
+    }
+    memcpy(At(ptr), action_->data.data(), size);
+    out->i32 = size;
+    return HostStatus::Ok;
+  }
+
+  HostStatus ActionDataSize(const HostValue* args, HostValue* out) {
+    out->i32 = action_->data.size();
+    return HostStatus::Ok;
+  }
+
+  HostStatus CurrentReceiver(const HostValue* args, HostValue* out) {
+    out->i64 = receiver_;
+    return HostStatus::Ok;
+  }
+
+  HostStatus RequireRecipient(const HostValue* args, HostValue* out) {
+    uint64_t recipient = args[0].i64;
+    if (std::find(notified_->begin(), notified_->end(), recipient) ==
+        notified_->end()) {
+      notified_->push_back(recipient);
+    }
+    return HostStatus::Ok;
+  }
+
+  HostStatus RequireAuth(const HostValue* args, HostValue* out) {
+    if (!HasAuthorization(args[0].i64, 0)) {
+      return Fail("missing authority of " + NameToString(args[0].i64));
+    }
+    return HostStatus::Ok;
+  }
+
+  HostStatus RequireAuth2(const HostValue* args, HostValue* out) {
+    if (!HasAuthorization(args[0].i64, args[1].i64)) {
+      return Fail("missing authority of " + NameToString(args[0].i64) +
+                  "@" + NameToString(args[1].i64));
+    }
+    return HostStatus::Ok;
+  }
+
+  HostStatus HasAuth(const HostValue* args, HostValue* out) {
+    out->i32 = HasAuthorization(args[0].i64, 0);
+    return HostStatus::Ok;
+  }
+
+  HostStatus IsAccount(const HostValue* args, HostValue* out) {
+    out->i32 = 1;
+    return HostStatus::Ok;
+  }
+
+  HostStatus SendInline(const HostValue* args, HostValue* out) {
+    uint32_t ptr = args[0].i32, size = args[1].i32;
+    Action action;
+    if (!InBounds(ptr, size)) {
+      return OutOfBounds();
+    }
+    if (!UnpackAction(reinterpret_cast<const uint8_t*>(At(ptr)), size,
+                      &action)) {
+      return Fail("malformed inline action");
+    }
+    // The contract may act on behalf of itself and of the authorizations of
+    // the action it is handling.
+    for (const Permission& permission : action.authorization) {
+      if (permission.actor != receiver_ &&
+          !HasAuthorization(permission.actor, permission.permission)) {
+        return Fail("inline action is not authorized by " +
+                    NameToString(permission.actor) + "@" +
+                    NameToString(permission.permission));
+      }
+    }
+    inline_actions_->emplace_back(receiver_, std::move(action));
+    return HostStatus::Ok;
+  }
+
+  HostStatus SendContextFreeInline(const HostValue* args, HostValue* out) {
+    uint32_t ptr = args[0].i32, size = args[1].i32;
+    Action action;
+    if (!InBounds(ptr, size)) {
+      return OutOfBounds();
+    }
+    if (!UnpackAction(reinterpret_cast<const uint8_t*>(At(ptr)), size,
+                      &action)) {
+      return Fail("malformed inline action");
+    }
+    if (!action.authorization.empty()) {
+      return Fail("context-free actions cannot have authorizations");
+    }
+    inline_actions_->emplace_back(receiver_, std::move(action));
+    return HostStatus::Ok;
+  }
+
+  HostStatus SendDeferred(const HostValue* args, HostValue* out) {
+    trace_->notes.push_back("deferred transaction sent, it is not executed");
+    return HostStatus::Ok;
+  }
+
+  HostStatus CancelDeferred(const HostValue* args, HostValue* out) {
+    out->i32 = 0;
+    return HostStatus::Ok;
+  }
+
+  /* allocation tracing */
+  HostStatus TraceAlloc(const HostValue* args, HostValue* out) {
+    if (!alloc_trace_) {
+      return HostStatus::Ok;
+    }
+    uint32_t a = args[1].i32, b = args[2].i32, c = args[3].i32;
+    std::string site = AllocationSite();
+    switch (args[0].i32) {
+      case 0:
+        fprintf(alloc_trace_, "malloc %u %u %s\n", a, b, site.c_str());
+        break;
+      case 1:
+        fprintf(alloc_trace_, "free %u %s\n", a, site.c_str());
+        break;
+      case 2:
+        fprintf(alloc_trace_, "realloc %u %u %u %s\n", c, a, b, site.c_str());
+        break;
+      case 3:
+        fprintf(alloc_trace_, "grow %u %u %s\n", a, b, site.c_str());
+        break;
+    }
+    return HostStatus::Ok;
+  }
+
+  // The innermost function up the stack of the allocator that is not part of
+  // it, "?" if the engine cannot tell.
+  std::string AllocationSite() {
+    const unsigned kMaxAllocatorDepth = 8;
+    std::string site = "?";
+    for (unsigned depth = 1; depth <= kMaxAllocatorDepth; ++depth) {
+      std::string caller = engine_->GetCaller(depth);
+      if (caller.empty()) {
+        break;
+      }
+      site = caller;
+      if (!IsAllocatorFunction(caller)) {
+        break;
+      }
+    }
+    return site;
+  }
+
+  /* console */
+  HostStatus Prints(const HostValue* args, HostValue* out) {
+    std::string str;
+    if (!ReadCString(args[0].i32, &str)) {
+      return OutOfBounds();
+    }
+    trace_->console += str;
+    return HostStatus::Ok;
+  }
+
+  HostStatus PrintsL(const HostValue* args, HostValue* out) {
+    uint32_t ptr = args[0].i32, size = args[1].i32;
+    if (!InBounds(ptr, size)) {
+      return OutOfBounds();
+    }
+    trace_->console.append(At(ptr), size);
+    return HostStatus::Ok;
+  }
+
+  HostStatus Printi(const HostValue* args, HostValue* out) {
+    trace_->console += std::to_string(static_cast<int64_t>(args[0].i64));
+    return HostStatus::Ok;
+  }
+
+  HostStatus Printui(const HostValue* args, HostValue* out) {
+    trace_->console += std::to_string(args[0].i64);
+    return HostStatus::Ok;
+  }
+
+  HostStatus Printi128(const HostValue* args, HostValue* out) {
+    uint128 value;
+    if (!Load(args[0].i32, &value)) {
+      return OutOfBounds();
+    }
+    if (static_cast<int128>(value) < 0) {
+      trace_->console += '-';
+      value = -value;
+    }
+    trace_->console += Uint128ToString(value);
+    return HostStatus::Ok;
+  }
+
+  HostStatus Printui128(const HostValue* args, HostValue* out) {
+    uint128 value;
+    if (!Load(args[0].i32, &value)) {
+      return OutOfBounds();
+    }
+    trace_->console += Uint128ToString(value);
+    return HostStatus::Ok;
+  }
+
+  HostStatus Printsf(const HostValue* args, HostValue* out) {
+    float value;
+    memcpy(&value, &args[0].f32_bits, sizeof(value));
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.6e", value);
+    trace_->console += buffer;
+    return HostStatus::Ok;
+  }
+
+  HostStatus Printdf(const HostValue* args, HostValue* out) {
+    double value;
+    memcpy(&value, &args[0].f64_bits, sizeof(value));
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.15e", value);
+    trace_->console += buffer;
+    return HostStatus::Ok;
+  }
+
+  HostStatus Printn(const HostValue* args, HostValue* out) {
+    trace_->console += NameToString(args[0].i64);
+    return HostStatus::Ok;
+  }
+
+  HostStatus Printhex(const HostValue* args, HostValue* out) {
+    static const char digits[] = "0123456789abcdef";
+    uint32_t ptr = args[0].i32, size = args[1].i32;
+    if (!InBounds(ptr, size)) {
+      return OutOfBounds();
+    }
+    for (uint32_t i = 0; i < size; ++i) {
+      uint8_t byte = At(ptr)[i];
+      trace_->console += digits[byte >> 4];
+      trace_->console += digits[byte & 0x0f];
+    }
+    return HostStatus::Ok;
+  }
+
+  /* crypto */
+  typedef void (*HashFunction)(const uint8_t*, size_t, uint8_t*);
+
+  template <HashFunction F, uint32_t DigestSize>
+  HostStatus Hash(const HostValue* args, HostValue* out) {
+    uint32_t ptr = args[0].i32, size = args[1].i32;
+    uint32_t digest_ptr = args[2].i32;
+    if (!InBounds(ptr, size) || !InBounds(digest_ptr, DigestSize)) {
+      return OutOfBounds();
+    }
+    F(reinterpret_cast<const uint8_t*>(At(ptr)), size,
+      reinterpret_cast<uint8_t*>(At(digest_ptr)));
+    return HostStatus::Ok;
+  }
+
+  template <HashFunction F, uint32_t DigestSize>
+  HostStatus AssertHash(const HostValue* args, HostValue* out) {
+    uint32_t ptr = args[0].i32, size = args[1].i32;
+    uint32_t digest_ptr = args[2].i32;
+    uint8_t digest[DigestSize];
+    if (!InBounds(ptr, size) || !InBounds(digest_ptr, DigestSize)) {
+      return OutOfBounds();
+    }
+    F(reinterpret_cast<const uint8_t*>(At(ptr)), size, digest);
+    if (memcmp(digest, At(digest_ptr), DigestSize)) {
+      return Fail("hash mismatch");
+    }
+    return HostStatus::Ok;
+  }
+
+  /* memory */
+  HostStatus Memcpy(const HostValue* args, HostValue* out) {
+    uint32_t dest = args[0].i32, src = args[1].i32;
+    uint32_t size = args[2].i32;
+    if (!InBounds(dest, size) || !InBounds(src, size)) {
+      return OutOfBounds();
+    }
+    if ((dest > src ? dest - src : src - dest) < size) {
+      return Fail("memcpy can only accept non-aliasing pointers");
+    }
+    memcpy(At(dest), At(src), size);
+    out->i32 = dest;
+    return HostStatus::Ok;
+  }
+
+  HostStatus Memmove(const HostValue* args, HostValue* out) {
+    uint32_t dest = args[0].i32, src = args[1].i32;
+    uint32_t size = args[2].i32;
+    if (!InBounds(dest, size) || !InBounds(src, size)) {
+      return OutOfBounds();
+    }
+    memmove(At(dest), At(src), size);
+    out->i32 = dest;
+    return HostStatus::Ok;
+  }
+
+  HostStatus Memcmp(const HostValue* args, HostValue* out) {
+    uint32_t a = args[0].i32, b = args[1].i32;
+    uint32_t size = args[2].i32;
+    if (!InBounds(a, size) || !InBounds(b, size)) {
+      return OutOfBounds();
+    }
+    int result = memcmp(At(a), At(b), size);
+    out->i32 = result < 0 ? -1 : result > 0 ? 1 : 0;
+    return HostStatus::Ok;
+  }
+
+  HostStatus Memset(const HostValue* args, HostValue* out) {
+    uint32_t dest = args[0].i32, size = args[2].i32;
+    if (!InBounds(dest, size)) {
+      return OutOfBounds();
+    }
+    memset(At(dest), args[1].i32, size);
+    out->i32 = dest;
+    return HostStatus::Ok;
+  }
+
+  /* primary index */
+  HostStatus DbStoreI64(const HostValue* args, HostValue* out) {
+    TableId table{receiver_, args[0].i64, args[1].i64};
+    uint64_t payer = args[2].i64, id = args[3].i64;
+    uint32_t ptr = args[4].i32, size = args[5].i32;
+    if (!InBounds(ptr, size)) {
+      return OutOfBounds();
+    }
+    PrimaryTable& rows = db_.tables[table];
+    if (rows.count(id)) {
+      return Fail("could not insert object, most likely a uniqueness "
+                  "constraint was violated");
+    }
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(At(ptr));
+    rows[id] = Row{payer, std::vector<uint8_t>(data, data + size)};
+    out->i32 = iterators_[0].Row(table, id);
+    return HostStatus::Ok;
+  }
+
+  HostStatus DbUpdateI64(const HostValue* args, HostValue* out) {
+    uint64_t payer = args[1].i64;
+    uint32_t ptr = args[2].i32, size = args[3].i32;
+    TableId table;
+    Row* row;
+    CHECK_TRAP(GetPrimaryRow(args[0].i32, true, &table, &row));
+    if (!InBounds(ptr, size)) {
+      return OutOfBounds();
+    }
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(At(ptr));
+    row->value.assign(data, data + size);
+    if (payer) {
+      row->payer = payer;
+    }
+    return HostStatus::Ok;
+  }
+
+  HostStatus DbRemoveI64(const HostValue* args, HostValue* out) {
+    TableId table;
+    Row* row;
+    CHECK_TRAP(GetPrimaryRow(args[0].i32, true, &table, &row));
+    PrimaryTable& rows = db_.tables[table];
+    rows.erase(iterators_[0].GetRow(args[0].i32)->second);
+    if (rows.empty()) {
+      db_.tables.erase(table);
+    }
+    return HostStatus::Ok;
+  }
+
+  HostStatus DbGetI64(const HostValue* args, HostValue* out) {
+    uint32_t ptr = args[1].i32, size = args[2].i32;
+    TableId table;
+    Row* row;
+    CHECK_TRAP(GetPrimaryRow(args[0].i32, false, &table, &row));
+    uint32_t row_size = row->value.size();
+    if (size == 0) {
+      out->i32 = row_size;
+      return HostStatus::Ok;
+    }
+    size = std::min(size, row_size);
+    if (!InBounds(ptr, size)) {
+      return OutOfBounds();
+    }
+    memcpy(At(ptr), row->value.data(), size);
+    out->i32 = size;
+    return HostStatus::Ok;
+  }
+
+  HostStatus DbNextI64(const HostValue* args, HostValue* out) {
+    int iterator = args[0].i32;
+    if (iterator < -1) {
+      out->i32 = -1;
+      return HostStatus::Ok;
+    }
+    TableId table;
+    Row* row;
+    CHECK_TRAP(GetPrimaryRow(iterator, false, &table, &row));
+    const PrimaryTable& rows = db_.tables[table];
+    auto it = rows.upper_bound(iterators_[0].GetRow(iterator)->second);
+    return ReturnPrimary(table, rows, it, args[1].i32, out);
+  }
+
+  HostStatus DbPreviousI64(const HostValue* args, HostValue* out) {
+    int iterator = args[0].i32;
+    TableId table;
+    PrimaryTable::const_iterator it;
+    out->i32 = -1;
+    if (iterator < -1) {
+      const TableId* end = iterators_[0].GetEnd(iterator);
+      if (!end) {
+        return Fail("invalid iterator");
+      }
+      table = *end;
+      auto rows = db_.tables.find(table);
+      if (rows == db_.tables.end() || rows->second.empty()) {
+        return HostStatus::Ok;
+      }
+      it = std::prev(rows->second.end());
+    } else {
+      Row* row;
+      CHECK_TRAP(GetPrimaryRow(iterator, false, &table, &row));
+      const PrimaryTable& rows = db_.tables[table];
+      it = rows.find(iterators_[0].GetRow(iterator)->second);
+      if (it == rows.begin()) {
+        return HostStatus::Ok;
+      }
+      --it;
+    }
+    return ReturnPrimary(table, db_.tables[table], it, args[1].i32, out);
+  }
+
+  HostStatus DbFindI64(const HostValue* args, HostValue* out) {
+    return FindPrimary(args, out, [](const PrimaryTable& rows, uint64_t id) {
+      return rows.find(id);
+    });
+  }
+
+  HostStatus DbLowerboundI64(const HostValue* args, HostValue* out) {
+    return FindPrimary(args, out, [](const PrimaryTable& rows, uint64_t id) {
+      return rows.lower_bound(id);
+    });
+  }
+
+  HostStatus DbUpperboundI64(const HostValue* args, HostValue* out) {
+    return FindPrimary(args, out, [](const PrimaryTable& rows, uint64_t id) {
+      return rows.upper_bound(id);
+    });
+  }
+
+  HostStatus DbEndI64(const HostValue* args, HostValue* out) {
+    TableId table{args[0].i64, args[1].i64, args[2].i64};
+    out->i32 =
+        db_.tables.count(table) ? iterators_[0].End(table) : -1;
+    return HostStatus::Ok;
+  }
+
+  /* secondary indices */
+  template <int I>
+  HostStatus IdxStore(const HostValue* args, HostValue* out) {
+    TableId table{receiver_, args[0].i64, args[1].i64};
+    uint64_t payer = args[2].i64, id = args[3].i64;
+    SecondaryKey key;
+    CHECK_TRAP(LoadSecondaryKey(I, args + 4, &key));
+    SecondaryTable& index = db_.indices[I][table];
+    if (index.by_primary.count(id)) {
+      return Fail("could not insert object, most likely a uniqueness "
+                  "constraint was violated");
+    }
+    index.by_primary[id] = std::make_pair(key, payer);
+    index.by_secondary.emplace(key, id);
+    out->i32 = iterators_[I + 1].Row(table, id);
+    return HostStatus::Ok;
+  }
+
+  template <int I>
+  HostStatus IdxUpdate(const HostValue* args, HostValue* out) {
+    uint64_t payer = args[1].i64;
+    TableId table;
+    uint64_t id;
+    SecondaryKey key;
+    CHECK_TRAP(GetSecondaryRow(I, args[0].i32, true, &table, &id));
+    CHECK_TRAP(LoadSecondaryKey(I, args + 2, &key));
+    SecondaryTable& index = db_.indices[I][table];
+    auto& row = index.by_primary[id];
+    index.by_secondary.erase(std::make_pair(row.first, id));
+    index.by_secondary.emplace(key, id);
+    row.first = key;
+    if (payer) {
+      row.second = payer;
+    }
+    return HostStatus::Ok;
+  }
+
+  template <int I>
+  HostStatus IdxRemove(const HostValue* args, HostValue* out) {
+    TableId table;
+    uint64_t id;
+    CHECK_TRAP(GetSecondaryRow(I, args[0].i32, true, &table, &id));
+    SecondaryTable& index = db_.indices[I][table];
+    index.by_secondary.erase(std::make_pair(index.by_primary[id].first, id));
+    index.by_primary.erase(id);
+    if (index.by_primary.empty()) {
+      db_.indices[I].erase(table);
+    }
+    return HostStatus::Ok;
+  }
+
+  template <int I>
+  HostStatus IdxNext(const HostValue* args, HostValue* out) {
+    int iterator = args[0].i32;
+    TableId table;
+    uint64_t id;
+    if (iterator < -1) {
+      out->i32 = -1;
+      return HostStatus::Ok;
+    }
+    CHECK_TRAP(GetSecondaryRow(I, iterator, false, &table, &id));
+    const SecondaryTable& index = db_.indices[I][table];
+    auto it = index.by_secondary.find(
+        std::make_pair(index.by_primary.at(id).first, id));
+    return ReturnSecondary(I, table, index, ++it, nullptr, args[1].i32,
+                           out);
+  }
+
+  template <int I>
+  HostStatus IdxPrevious(const HostValue* args, HostValue* out) {
+    int iterator = args[0].i32;
+    TableId table;
+    const SecondaryTable* index;
+    SecondarySet::const_iterator it;
+    out->i32 = -1;
+    if (iterator < -1) {
+      const TableId* end = iterators_[I + 1].GetEnd(iterator);
+      if (!end) {
+        return Fail("invalid iterator");
+      }
+      table = *end;
+      auto found = db_.indices[I].find(table);
+      if (found == db_.indices[I].end() || found->second.by_secondary.empty()) {
+        return HostStatus::Ok;
+      }
+      index = &found->second;
+      it = std::prev(index->by_secondary.end());
+    } else {
+      uint64_t id;
+      CHECK_TRAP(GetSecondaryRow(I, iterator, false, &table, &id));
+      index = &db_.indices[I][table];
+      it = index->by_secondary.find(
+          std::make_pair(index->by_primary.at(id).first, id));
+      if (it == index->by_secondary.begin()) {
+        return HostStatus::Ok;
+      }
+      --it;
+    }
+    return ReturnSecondary(I, table, *index, it, nullptr, args[1].i32,
+                           out);
+  }
+
+  template <int I>
+  HostStatus IdxFindPrimary(const HostValue* args, HostValue* out) {
+    TableId table{args[0].i64, args[1].i64, args[2].i64};
+    uint32_t ptr = args[3].i32;
+    uint64_t id = args[KeyArgCount(I) + 3].i64;
+    CHECK_TRAP(CheckKeyArgs(I, args + 3));
+    auto found = db_.indices[I].find(table);
+    if (found == db_.indices[I].end()) {
+      out->i32 = -1;
+      return HostStatus::Ok;
+    }
+    auto row = found->second.by_primary.find(id);
+    if (row == found->second.by_primary.end()) {
+      out->i32 = iterators_[I + 1].End(table);
+      return HostStatus::Ok;
+    }
+    memcpy(At(ptr), row->second.first.bytes.data(), s_secondary_indices[I].size);
+    out->i32 = iterators_[I + 1].Row(table, id);
+    return HostStatus::Ok;
+  }
+
+  template <int I>
+  HostStatus IdxFindSecondary(const HostValue* args, HostValue* out) {
+    return FindSecondary(I, args, out, [](const SecondaryTable& index,
+                                          const SecondaryKey& key)
+                                           -> SecondarySet::const_iterator {
+      auto it = index.by_secondary.lower_bound(std::make_pair(key, 0));
+      return it != index.by_secondary.end() && it->first == key
+                 ? it
+                 : index.by_secondary.end();
+    }, false);
+  }
+
+  template <int I>
+  HostStatus IdxLowerbound(const HostValue* args, HostValue* out) {
+    return FindSecondary(I, args, out, [](const SecondaryTable& index,
+                                          const SecondaryKey& key) {
+      return index.by_secondary.lower_bound(std::make_pair(key, 0));
+    }, true);
+  }
+
+  template <int I>
+  HostStatus IdxUpperbound(const HostValue* args, HostValue* out) {
+    return FindSecondary(I, args, out, [](const SecondaryTable& index,
+                                          const SecondaryKey& key) {
+      return index.by_secondary.upper_bound(
+          std::make_pair(key, std::numeric_limits<uint64_t>::max()));
+    }, true);
+  }
+
+  template <int I>
+  HostStatus IdxEnd(const HostValue* args, HostValue* out) {
+    TableId table{args[0].i64, args[1].i64, args[2].i64};
+    out->i32 =
+        db_.indices[I].count(table) ? iterators_[I + 1].End(table) : -1;
+    return HostStatus::Ok;
+  }
+
+  /* compiler builtins */
+  template <int Kind>
+  HostStatus Shift128(const HostValue* args, HostValue* out) {
+    uint128 value = Arg128(args + 1);
+    uint32_t shift = args[3].i32;
+    switch (Kind) {
+      case 0:
+        value = shift >= 128 ? 0 : value << shift;
+        break;
+      case 1:
+        value = shift >= 128 ? (static_cast<int128>(value) < 0 ? ~uint128(0) : 0)
+                             : static_cast<uint128>(static_cast<int128>(value) >> shift);
+        break;
+      default:
+        value = shift >= 128 ? 0 : value >> shift;
+        break;
+    }
+    return Return128(args[0].i32, value);
+  }
+
+  template <int Kind>
+  HostStatus Arithmetic128(const HostValue* args, HostValue* out) {
+    uint128 a = Arg128(args + 1), b = Arg128(args + 3);
+    const int128 min = static_cast<int128>(uint128(1) << 127);
+    if (Kind != 4 && b == 0) {
+      return Fail("divide by zero");
+    }
+    switch (Kind) {
+      case 0:
+        if (static_cast<int128>(a) == min && static_cast<int128>(b) == -1) {
+          return Return128(args[0].i32, a);
+        }
+        return Return128(args[0].i32,
+                         static_cast<int128>(a) / static_cast<int128>(b));
+      case 1:
+        return Return128(args[0].i32, a / b);
+      case 2:
+        if (static_cast<int128>(a) == min && static_cast<int128>(b) == -1) {
+          return Return128(args[0].i32, 0);
+        }
+        return Return128(args[0].i32,
+                         static_cast<int128>(a) % static_cast<int128>(b));
+      case 3:
+        return Return128(args[0].i32, a % b);
+      default:
+        return Return128(args[0].i32, a * b);
+    }
+  }
+
+  HostStatus Negtf2(const HostValue* args, HostValue* out) {
+    return Return128(args[0].i32, Arg128(args + 1) ^ (uint128(1) << 127));
+  }
+
+  HostStatus Floatsidf(const HostValue* args, HostValue* out) {
+    return ReturnDouble(out, static_cast<int32_t>(args[0].i32));
+  }
+
+  HostStatus Floattidf(const HostValue* args, HostValue* out) {
+    return ReturnDouble(out, static_cast<int128>(Arg128(args)));
+  }
+
+  HostStatus Floatuntidf(const HostValue* args, HostValue* out) {
+    return ReturnDouble(out, Arg128(args));
+  }
+
+#if defined(__SIZEOF_FLOAT128__)
+  template <int Kind>
+  HostStatus ArithmeticF128(const HostValue* args, HostValue* out) {
+    __float128 a = ArgF128(args + 1), b = ArgF128(args + 3);
+    switch (Kind) {
+      case 0: return ReturnF128(args[0].i32, a + b);
+      case 1: return ReturnF128(args[0].i32, a - b);
+      case 2: return ReturnF128(args[0].i32, a * b);
+      default: return ReturnF128(args[0].i32, a / b);
+    }
+  }
+
+  // Mirrors the comparisons of the chain: -1, 0 or 1, or NanResult if either
+  // operand is a NaN.
+  template <int NanResult>
+  HostStatus CompareF128(const HostValue* args, HostValue* out) {
+    __float128 a = ArgF128(args), b = ArgF128(args + 2);
+    out->i32 = (a != a || b != b) ? NanResult : a < b ? -1 : a == b ? 0 : 1;
+    return HostStatus::Ok;
+  }
+
+  HostStatus Unordtf2(const HostValue* args, HostValue* out) {
+    __float128 a = ArgF128(args), b = ArgF128(args + 2);
+    out->i32 = a != a || b != b;
+    return HostStatus::Ok;
+  }
+
+  HostStatus Printqf(const HostValue* args, HostValue* out) {
+    uint128 bits;
+    if (!Load(args[0].i32, &bits)) {
+      return OutOfBounds();
+    }
+    __float128 value;
+    memcpy(&value, &bits, sizeof(value));
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.18Le", static_cast<long double>(value));
+    trace_->console += buffer;
+    return HostStatus::Ok;
+  }
+
+  HostStatus Extendsftf2(const HostValue* args, HostValue* out) {
+    float value;
+    memcpy(&value, &args[1].f32_bits, sizeof(value));
+    return ReturnF128(args[0].i32, value);
+  }
+
+  HostStatus Extenddftf2(const HostValue* args, HostValue* out) {
+    double value;
+    memcpy(&value, &args[1].f64_bits, sizeof(value));
+    return ReturnF128(args[0].i32, value);
+  }
+
+  HostStatus Floatsitf(const HostValue* args, HostValue* out) {
+    return ReturnF128(args[0].i32, static_cast<int32_t>(args[1].i32));
+  }
+
+  HostStatus Floatunsitf(const HostValue* args, HostValue* out) {
+    return ReturnF128(args[0].i32, args[1].i32);
+  }
+
+  HostStatus Floatditf(const HostValue* args, HostValue* out) {
+    return ReturnF128(args[0].i32, static_cast<int64_t>(args[1].i64));
+  }
+
+  HostStatus Floatunditf(const HostValue* args, HostValue* out) {
+    return ReturnF128(args[0].i32, args[1].i64);
+  }
+
+  HostStatus Trunctfdf2(const HostValue* args, HostValue* out) {
+    return ReturnDouble(out, ArgF128(args));
+  }
+
+  HostStatus Trunctfsf2(const HostValue* args, HostValue* out) {
+    float value = ArgF128(args);
+    memcpy(&out->f32_bits, &value, sizeof(value));
+    return HostStatus::Ok;
+  }
+
+  // Truncates towards zero; NaN and out of range values give the integer
+  // indefinite results of the chain's soft float conversions.
+  template <typename T, typename F>
+  static T Truncate(F value, T min, T max, bool is_signed) {
+    if (value != value || value <= static_cast<F>(min) - 1 ||
+        value >= static_cast<F>(max) + 1) {
+      return is_signed ? min : max;
+    }
+    return static_cast<T>(value);
+  }
+
+  template <typename T, typename F>
+  static T Truncate(F value) {
+    return Truncate<T>(value, std::numeric_limits<T>::min(),
+                       std::numeric_limits<T>::max(),
+                       std::numeric_limits<T>::is_signed);
+  }
+
+  template <typename F>
+  static uint128 Truncate128(F value, bool is_signed) {
+    const uint128 kSignedMin = uint128(1) << 127;
+    return is_signed ? static_cast<uint128>(Truncate<int128>(
+                           value, static_cast<int128>(kSignedMin),
+                           static_cast<int128>(kSignedMin - 1), true))
+                     : Truncate<uint128>(value, 0, ~uint128(0), false);
+  }
+
+  template <typename T>
+  HostStatus Fixtf(const HostValue* args, HostValue* out) {
+    T value = Truncate<T>(ArgF128(args));
+    if (sizeof(T) == 4) {
+      out->i32 = value;
+    } else {
+      out->i64 = value;
+    }
+    return HostStatus::Ok;
+  }
+
+  template <bool Signed>
+  HostStatus Fixtfti(const HostValue* args, HostValue* out) {
+    return Return128(args[0].i32, Truncate128(ArgF128(args + 1), Signed));
+  }
+
+  template <typename F, bool Signed>
+  HostStatus FixToTi(const HostValue* args, HostValue* out) {
+    F value;
+    memcpy(&value, &args[1], sizeof(value));
+    return Return128(args[0].i32, Truncate128(value, Signed));
+  }
+#endif
+
+ private:
+  static const unsigned kMaxInlineDepth = 4;
+  static const uint64_t kBlockInterval = 500000;
+
+  bool ExecuteAction(const Action& action,
+                     uint64_t sender,
+                     unsigned depth,
+                     std::vector<ApplyTrace>* traces);
+  bool Apply(uint64_t receiver,
+             const Action& action,
+             uint64_t sender,
+             unsigned depth,
+             std::vector<ApplyTrace>* traces,
+             std::vector<uint64_t>* notified,
+             std::vector<std::pair<uint64_t, Action>>* inline_actions);
+
+  HostStatus Fail(const std::string& message) {
+    if (trace_->error.empty()) {
+      trace_->error = message;
+    }
+    return HostStatus::Trap;
+  }
+
+  HostStatus OutOfBounds() { return Fail("access violation"); }
+
+  bool InBounds(uint32_t ptr, uint32_t size) const {
+    return uint64_t(ptr) + size <= memory_size_;
+  }
+
+  char* At(uint32_t ptr) { return memory_ + ptr; }
+
+  template <typename T>
+  bool Load(uint32_t ptr, T* out) {
+    if (!InBounds(ptr, sizeof(T))) {
+      return false;
+    }
+    memcpy(out, At(ptr), sizeof(T));
+    return true;
+  }
+
+  bool ReadCString(uint32_t ptr, std::string* out) {
+    if (ptr >= memory_size_) {
+      return false;
+    }
+    const char* begin = At(ptr);
+    const char* end =
+        static_cast<const char*>(memchr(begin, 0, memory_size_ - ptr));
+    if (!end) {
+      return false;
+    }
+    out->assign(begin, end);
+    return true;
+  }
+
+  bool HasAuthorization(uint64_t actor, uint64_t permission) const {
+    for (const Permission& level : action_->authorization) {
+      if (level.actor == actor &&
+          (permission == 0 || level.permission == permission)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static std::string Uint128ToString(uint128 value) {
+    std::string str;
+    do {
+      str += static_cast<char>('0' + static_cast<int>(value % 10));
+      value /= 10;
+    } while (value);
+    std::reverse(str.begin(), str.end());
+    return str;
+  }
+
+  static uint128 Arg128(const HostValue* args) {
+    return (uint128(args[1].i64) << 64) | args[0].i64;
+  }
+
+  HostStatus Return128(uint32_t ptr, uint128 value) {
+    if (!InBounds(ptr, sizeof(value))) {
+      return OutOfBounds();
+    }
+    memcpy(At(ptr), &value, sizeof(value));
+    return HostStatus::Ok;
+  }
+
+  static HostStatus ReturnDouble(HostValue* out, double value) {
+    memcpy(&out->f64_bits, &value, sizeof(value));
+    return HostStatus::Ok;
+  }
+
+#if defined(__SIZEOF_FLOAT128__)
+  static __float128 ArgF128(const HostValue* args) {
+    uint128 bits = Arg128(args);
+    __float128 value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  HostStatus ReturnF128(uint32_t ptr, __float128 value) {
+    uint128 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return Return128(ptr, bits);
+  }
+#endif
+
+  // Looks up the row of a primary index iterator; writes require the row to
+  // belong to the receiver.
+  HostStatus GetPrimaryRow(int iterator,
+                           bool write,
+                           TableId* table,
+                           Row** row) {
+    const std::pair<TableId, uint64_t>* entry = iterators_[0].GetRow(iterator);
+    if (!entry) {
+      return Fail(iterator == -1 ? "invalid iterator"
+                                 : "dereference of end iterator");
+    }
+    auto rows = db_.tables.find(entry->first);
+    if (rows == db_.tables.end() || !rows->second.count(entry->second)) {
+      return Fail("dereference of deleted object");
+    }
+    if (write && entry->first.code != receiver_) {
+      return Fail("db access violation");
+    }
+    *table = entry->first;
+    *row = &rows->second[entry->second];
+    return HostStatus::Ok;
+  }
+
+  HostStatus ReturnPrimary(const TableId& table,
+                           const PrimaryTable& rows,
+                           PrimaryTable::const_iterator it,
+                           uint32_t primary_ptr,
+                           HostValue* out) {
+    if (it == rows.end()) {
+      out->i32 = iterators_[0].End(table);
+      return HostStatus::Ok;
+    }
+    if (!InBounds(primary_ptr, sizeof(uint64_t))) {
+      return OutOfBounds();
+    }
+    memcpy(At(primary_ptr), &it->first, sizeof(uint64_t));
+    out->i32 = iterators_[0].Row(table, it->first);
+    return HostStatus::Ok;
+  }
+
+  template <typename Search>
+  HostStatus FindPrimary(const HostValue* args,
+                         HostValue* out,
+                         Search search) {
+    TableId table{args[0].i64, args[1].i64, args[2].i64};
+    auto rows = db_.tables.find(table);
+    if (rows == db_.tables.end()) {
+      out->i32 = -1;
+      return HostStatus::Ok;
+    }
+    auto it = search(rows->second, args[3].i64);
+    out->i32 = it == rows->second.end()
+                         ? iterators_[0].End(table)
+                         : iterators_[0].Row(table, it->first);
+    return HostStatus::Ok;
+  }
+
+  // Number of arguments describing a secondary key: its address, followed by
+  // its size in 128-bit words for idx256.
+  static int KeyArgCount(int index) {
+    return s_secondary_indices[index].kind == KeyKind::U256 ? 2 : 1;
+  }
+
+  HostStatus CheckKeyArgs(int index, const HostValue* args) {
+    const SecondaryIndexInfo& info = s_secondary_indices[index];
+    if (info.kind == KeyKind::U256 && args[1].i32 != 2) {
+      return Fail("invalid size of secondary key array for idx256: given " +
+                  std::to_string(args[1].i32 * 16) +
+                  " bytes but expected 32 bytes");
+    }
+    if (!InBounds(args[0].i32, info.size)) {
+      return OutOfBounds();
+    }
+    return HostStatus::Ok;
+  }
+
+  HostStatus LoadSecondaryKey(int index,
+                              const HostValue* args,
+                              SecondaryKey* key) {
+    CHECK_TRAP(CheckKeyArgs(index, args));
+    if (!MakeSecondaryKey(s_secondary_indices[index],
+                          reinterpret_cast<const uint8_t*>(At(args[0].i32)),
+                          key)) {
+      return Fail("NaN is not an allowed value for a secondary key");
+    }
+    return HostStatus::Ok;
+  }
+
+  HostStatus GetSecondaryRow(int index,
+                             int iterator,
+                             bool write,
+                             TableId* table,
+                             uint64_t* id) {
+    const std::pair<TableId, uint64_t>* entry =
+        iterators_[index + 1].GetRow(iterator);
+    if (!entry) {
+      return Fail(iterator == -1 ? "invalid iterator"
+                                 : "dereference of end iterator");
+    }
+    auto found = db_.indices[index].find(entry->first);
+    if (found == db_.indices[index].end() ||
+        !found->second.by_primary.count(entry->second)) {
+      return Fail("dereference of deleted object");
+    }
+    if (write && entry->first.code != receiver_) {
+      return Fail("db access violation");
+    }
+    *table = entry->first;
+    *id = entry->second;
+    return HostStatus::Ok;
+  }
+
+  HostStatus ReturnSecondary(
+      int index,
+      const TableId& table,
+      const SecondaryTable& rows,
+      SecondarySet::const_iterator it,
+      const uint32_t* key_ptr,
+      uint32_t primary_ptr,
+      HostValue* out) {
+    if (it == rows.by_secondary.end()) {
+      out->i32 = iterators_[index + 1].End(table);
+      return HostStatus::Ok;
+    }
+    if (!InBounds(primary_ptr, sizeof(uint64_t))) {
+      return OutOfBounds();
+    }
+    memcpy(At(primary_ptr), &it->second, sizeof(uint64_t));
+    if (key_ptr) {
+      memcpy(At(*key_ptr), it->first.bytes.data(), s_secondary_indices[index].size);
+    }
+    out->i32 = iterators_[index + 1].Row(table, it->second);
+    return HostStatus::Ok;
+  }
+
+  template <typename Search>
+  HostStatus FindSecondary(int index,
+                           const HostValue* args,
+                           HostValue* out,
+                           Search search,
+                           bool write_key) {
+    TableId table{args[0].i64, args[1].i64, args[2].i64};
+    uint32_t key_ptr = args[3].i32;
+    uint32_t primary_ptr = args[KeyArgCount(index) + 3].i32;
+    SecondaryKey key;
+    CHECK_TRAP(LoadSecondaryKey(index, args + 3, &key));
+    auto found = db_.indices[index].find(table);
+    if (found == db_.indices[index].end()) {
+      out->i32 = -1;
+      return HostStatus::Ok;
+    }
+    return ReturnSecondary(index, table, found->second,
+                           search(found->second, key),
+                           write_key ? &key_ptr : nullptr, primary_ptr, out);
+  }
+
+  std::vector<IntrinsicBinding> bindings_;
+  std::map<uint64_t, std::unique_ptr<Engine>> contracts_;
+  Database db_;
+  uint64_t now_ = 1577836800000000;  // 2020-01-01T00:00:00
+
+  // State of the action being applied.
+  Engine* engine_ = nullptr;
+  char* memory_ = nullptr;
+  uint64_t memory_size_ = 0;
+  const Action* action_ = nullptr;
+  uint64_t receiver_ = 0;
+  uint64_t sender_ = 0;
+  ApplyTrace* trace_ = nullptr;
+  std::vector<uint64_t>* notified_ = nullptr;
+  std::vector<std::pair<uint64_t, Action>>* inline_actions_ = nullptr;
+  bool exited_ = false;
+  FILE* alloc_trace_ = nullptr;
+  IteratorCache iterators_[kSecondaryIndexCount + 1];
+};
+
+struct Intrinsic {
+  const char* name;
+  const char* signature;  // Parameter types, then result types.
+  HostStatus (Emulator::*method)(const HostValue* args, HostValue* out);
+};
+
+#define EOSIO_RUN_SECONDARY_INDEX(I, NAME, KEY)                          \
+  {"db_" NAME "_store", "(IIIIi" KEY ")i", &Emulator::IdxStore<I>},        \
+  {"db_" NAME "_update", "(iIi" KEY ")", &Emulator::IdxUpdate<I>},         \
+  {"db_" NAME "_remove", "(i)", &Emulator::IdxRemove<I>},                  \
+  {"db_" NAME "_next", "(ii)i", &Emulator::IdxNext<I>},                    \
+  {"db_" NAME "_previous", "(ii)i", &Emulator::IdxPrevious<I>},            \
+  {"db_" NAME "_find_primary", "(IIIi" KEY "I)i",                        \
+   &Emulator::IdxFindPrimary<I>},                                          \
+  {"db_" NAME "_find_secondary", "(IIIi" KEY "i)i",                      \
+   &Emulator::IdxFindSecondary<I>},                                        \
+  {"db_" NAME "_lowerbound", "(IIIi" KEY "i)i", &Emulator::IdxLowerbound<I>}, \
+  {"db_" NAME "_upperbound", "(IIIi" KEY "i)i", &Emulator::IdxUpperbound<I>}, \
+  {"db_" NAME "_end", "(III)i", &Emulator::IdxEnd<I>},
+
+static const Intrinsic s_intrinsics[] = {
+    {"eosio_assert", "(ii)", &Emulator::EosioAssert},
+    {"eosio_assert_message", "(iii)", &Emulator::EosioAssertMessage},
+    {"eosio_assert_code", "(iI)", &Emulator::EosioAssertCode},
+    {"eosio_exit", "(i)", &Emulator::EosioExit},
+    {"abort", "()", &Emulator::Abort},
+    {"current_time", "()I", &Emulator::CurrentTime},
+    {"publication_time", "()I", &Emulator::CurrentTime},
+    {"is_feature_activated", "(i)i", &Emulator::IsFeatureActivated},
+    {"get_sender", "()I", &Emulator::GetSender},
+
+    {"read_action_data", "(ii)i", &Emulator::ReadActionData},
+    {"action_data_size", "()i", &Emulator::ActionDataSize},
+    {"current_receiver", "()I", &Emulator::CurrentReceiver},
+    {"require_recipient", "(I)", &Emulator::RequireRecipient},
+    {"require_auth", "(I)", &Emulator::RequireAuth},
+    {"require_auth2", "(II)", &Emulator::RequireAuth2},
+    {"has_auth", "(I)i", &Emulator::HasAuth},
+    {"is_account", "(I)i", &Emulator::IsAccount},
+    {"send_inline", "(ii)", &Emulator::SendInline},
+    {"send_context_free_inline", "(ii)", &Emulator::SendContextFreeInline},
+    {"send_deferred", "(iIiii)", &Emulator::SendDeferred},
+    {"cancel_deferred", "(i)i", &Emulator::CancelDeferred},
+
+    {"trace_alloc", "(iiii)", &Emulator::TraceAlloc},
+
+    {"prints", "(i)", &Emulator::Prints},
+    {"prints_l", "(ii)", &Emulator::PrintsL},
+    {"printi", "(I)", &Emulator::Printi},
+    {"printui", "(I)", &Emulator::Printui},
+    {"printi128", "(i)", &Emulator::Printi128},
+    {"printui128", "(i)", &Emulator::Printui128},
+    {"printsf", "(f)", &Emulator::Printsf},
+    {"printdf", "(F)", &Emulator::Printdf},
+    {"printn", "(I)", &Emulator::Printn},
+    {"printhex", "(ii)", &Emulator::Printhex},
+
+    {"sha1", "(iii)", &Emulator::Hash<Sha1, 20>},
+    {"sha256", "(iii)", &Emulator::Hash<Sha256, 32>},
+    {"sha512", "(iii)", &Emulator::Hash<Sha512, 64>},
+    {"ripemd160", "(iii)", &Emulator::Hash<Ripemd160, 20>},
+    {"assert_sha1", "(iii)", &Emulator::AssertHash<Sha1, 20>},
+    {"assert_sha256", "(iii)", &Emulator::AssertHash<Sha256, 32>},
+    {"assert_sha512", "(iii)", &Emulator::AssertHash<Sha512, 64>},
+    {"assert_ripemd160", "(iii)", &Emulator::AssertHash<Ripemd160, 20>},
+
+    {"memcpy", "(iii)i", &Emulator::Memcpy},
+    {"memmove", "(iii)i", &Emulator::Memmove},
+    {"memcmp", "(iii)i", &Emulator::Memcmp},
+    {"memset", "(iii)i", &Emulator::Memset},
+
+    {"db_store_i64", "(IIIIii)i", &Emulator::DbStoreI64},
+    {"db_update_i64", "(iIii)", &Emulator::DbUpdateI64},
+    {"db_remove_i64", "(i)", &Emulator::DbRemoveI64},
+    {"db_get_i64", "(iii)i", &Emulator::DbGetI64},
+    {"db_next_i64", "(ii)i", &Emulator::DbNextI64},
+    {"db_previous_i64", "(ii)i", &Emulator::DbPreviousI64},
+    {"db_find_i64", "(IIII)i", &Emulator::DbFindI64},
+    {"db_lowerbound_i64", "(IIII)i", &Emulator::DbLowerboundI64},
+    {"db_upperbound_i64", "(IIII)i", &Emulator::DbUpperboundI64},
+    {"db_end_i64", "(III)i", &Emulator::DbEndI64},
+    EOSIO_RUN_SECONDARY_INDEX(0, "idx64", "")
+    EOSIO_RUN_SECONDARY_INDEX(1, "idx128", "")
+    EOSIO_RUN_SECONDARY_INDEX(2, "idx256", "i")
+    EOSIO_RUN_SECONDARY_INDEX(3, "idx_double", "")
+    EOSIO_RUN_SECONDARY_INDEX(4, "idx_long_double", "")
+
+    {"__ashlti3", "(iIIi)", &Emulator::Shift128<0>},
+    {"__lshlti3", "(iIIi)", &Emulator::Shift128<0>},
+    {"__ashrti3", "(iIIi)", &Emulator::Shift128<1>},
+    {"__lshrti3", "(iIIi)", &Emulator::Shift128<2>},
+    {"__divti3", "(iIIII)", &Emulator::Arithmetic128<0>},
+    {"__udivti3", "(iIIII)", &Emulator::Arithmetic128<1>},
+    {"__modti3", "(iIIII)", &Emulator::Arithmetic128<2>},
+    {"__umodti3", "(iIIII)", &Emulator::Arithmetic128<3>},
+    {"__multi3", "(iIIII)", &Emulator::Arithmetic128<4>},
+    {"__negtf2", "(iII)", &Emulator::Negtf2},
+    {"__floatsidf", "(i)F", &Emulator::Floatsidf},
+    {"__floattidf", "(II)F", &Emulator::Floattidf},
+    {"__floatuntidf", "(II)F", &Emulator::Floatuntidf},
+#if defined(__SIZEOF_FLOAT128__)
+    {"printqf", "(i)", &Emulator::Printqf},
+    {"__addtf3", "(iIIII)", &Emulator::ArithmeticF128<0>},
+    {"__subtf3", "(iIIII)", &Emulator::ArithmeticF128<1>},
+    {"__multf3", "(iIIII)", &Emulator::ArithmeticF128<2>},
+    {"__divtf3", "(iIIII)", &Emulator::ArithmeticF128<3>},
+    {"__eqtf2", "(IIII)i", &Emulator::CompareF128<1>},
+    {"__netf2", "(IIII)i", &Emulator::CompareF128<1>},
+    {"__getf2", "(IIII)i", &Emulator::CompareF128<-1>},
+    {"__gttf2", "(IIII)i", &Emulator::CompareF128<0>},
+    {"__letf2", "(IIII)i", &Emulator::CompareF128<1>},
+    {"__lttf2", "(IIII)i", &Emulator::CompareF128<0>},
+    {"__cmptf2", "(IIII)i", &Emulator::CompareF128<1>},
+    {"__unordtf2", "(IIII)i", &Emulator::Unordtf2},
+    {"__extendsftf2", "(if)", &Emulator::Extendsftf2},
+    {"__extenddftf2", "(iF)", &Emulator::Extenddftf2},
+    {"__floatsitf", "(ii)", &Emulator::Floatsitf},
+    {"__floatunsitf", "(ii)", &Emulator::Floatunsitf},
+    {"__floatditf", "(iI)", &Emulator::Floatditf},
+    {"__floatunditf", "(iI)", &Emulator::Floatunditf},
+    {"__trunctfdf2", "(II)F", &Emulator::Trunctfdf2},
+    {"__trunctfsf2", "(II)f", &Emulator::Trunctfsf2},
+    {"__fixtfsi", "(II)i", &Emulator::Fixtf<int32_t>},
+    {"__fixtfdi", "(II)I", &Emulator::Fixtf<int64_t>},
+    {"__fixunstfsi", "(II)i", &Emulator::Fixtf<uint32_t>},
+    {"__fixunstfdi", "(II)I", &Emulator::Fixtf<uint64_t>},
+    {"__fixtfti", "(iII)", &Emulator::Fixtfti<true>},
+    {"__fixunstfti", "(iII)", &Emulator::Fixtfti<false>},
+    {"__fixsfti", "(if)", &Emulator::FixToTi<float, true>},
+    {"__fixdfti", "(iF)", &Emulator::FixToTi<double, true>},
+    {"__fixunssfti", "(if)", &Emulator::FixToTi<float, false>},
+    {"__fixunsdfti", "(iF)", &Emulator::FixToTi<double, false>},
+#endif
+};
+
+#undef EOSIO_RUN_SECONDARY_INDEX
+
+static const Intrinsic* FindIntrinsic(const std::string& name) {
+  for (const Intrinsic& intrinsic : s_intrinsics) {
+    if (name == intrinsic.name) {
+      return &intrinsic;
+    }
+  }
+  return nullptr;
+}
+
+int Emulator::Bind(const std::string& name,
+                   const std::string& signature,
+                   std::string* error) {
+  const Intrinsic* intrinsic = FindIntrinsic(name);
+  if (intrinsic && signature != intrinsic->signature) {
+    *error = "import \"env." + name + "\" has signature " + signature +
+             ", expected " + intrinsic->signature;
+    return -1;
+  }
+  bindings_.push_back(IntrinsicBinding{intrinsic, name});
+  return static_cast<int>(bindings_.size() - 1);
+}
+
+HostStatus Emulator::Call(int binding,
+                          const HostValue* args,
+                          HostValue* out) {
+  const IntrinsicBinding& bound = bindings_[binding];
+  if (!bound.intrinsic) {
+    return Fail("intrinsic " + bound.name + " is not supported");
+  }
+  // The memory may have grown since the last call.
+  memory_ = reinterpret_cast<char*>(engine_->memory_data());
+  memory_size_ = engine_->memory_size();
+  return (this->*bound.intrinsic->method)(args, out);
+}
+
+bool Emulator::PushTransaction(const Action& action,
+                               std::vector<ApplyTrace>* traces) {
+  Database saved = db_;
+  bool ok = ExecuteAction(action, 0, 0, traces);
+  if (!ok) {
+    db_ = std::move(saved);
+  }
+  now_ += kBlockInterval;
+  return ok;
+}
+
+// Applies an action to its account and to every account notified, then
+// executes the inline actions they sent.
+bool Emulator::ExecuteAction(const Action& action,
+                             uint64_t sender,
+                             unsigned depth,
+                             std::vector<ApplyTrace>* traces) {
+  std::vector<uint64_t> notified = {action.account};
+  std::vector<std::pair<uint64_t, Action>> inline_actions;
+  for (size_t i = 0; i < notified.size(); ++i) {
+    if (!Apply(notified[i], action, sender, depth, traces, &notified,
+               &inline_actions)) {
+      return false;
+    }
+  }
+  for (const auto& inline_action : inline_actions) {
+    if (depth + 1 >= kMaxInlineDepth) {
+      traces->back().ok = false;
+      traces->back().error = "max inline action depth per transaction reached";
+      return false;
+    }
+    if (!ExecuteAction(inline_action.second, inline_action.first, depth + 1,
+                       traces)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Emulator::Apply(
+    uint64_t receiver,
+    const Action& action,
+    uint64_t sender,
+    unsigned depth,
+    std::vector<ApplyTrace>* traces,
+    std::vector<uint64_t>* notified,
+    std::vector<std::pair<uint64_t, Action>>* inline_actions) {
+  traces->emplace_back();
+  ApplyTrace& trace = traces->back();
+  trace.receiver = receiver;
+  trace.action = action;
+  trace.depth = depth;
+
+  auto found = contracts_.find(receiver);
+  if (found == contracts_.end()) {
+    return true;
+  }
+
+  engine_ = found->second.get();
+  action_ = &action;
+  receiver_ = receiver;
+  sender_ = sender;
+  trace_ = &trace;
+  notified_ = notified;
+  inline_actions_ = inline_actions;
+  exited_ = false;
+  for (IteratorCache& iterators : iterators_) {
+    iterators.Clear();
+  }
+
+  if (alloc_trace_) {
+    fprintf(alloc_trace_, "action %s %s %s\n", NameToString(receiver).c_str(),
+            NameToString(action.account).c_str(),
+            NameToString(action.name).c_str());
+  }
+
+  std::string trap;
+  uint64_t instructions = 0;
+  auto start = std::chrono::steady_clock::now();
+  bool returned = engine_->Apply(receiver, action.account, action.name, &trap,
+                                 &instructions);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  engine_ = nullptr;
+
+  trace.ran = true;
+  trace.counts_instructions = found->second->counts_instructions();
+  trace.instructions = instructions;
+  trace.microseconds =
+      std::chrono::duration<double, std::micro>(elapsed).count();
+  if (returned || exited_) {
+    return true;
+  }
+  trace.ok = false;
+  if (trace.error.empty()) {
+    trace.error = trap;
+  }
+  return false;
+}
+
+static void WriteTraces(size_t index,
+                        const Action& action,
+                        bool ok,
+                        const std::vector<ApplyTrace>& traces) {
+  printf("transaction %zu: %s::%s %s\n", index,
+         NameToString(action.account).c_str(),
+         NameToString(action.name).c_str(), ok ? "executed" : "failed");
+  for (const ApplyTrace& trace : traces) {
+    std::string indent(2 * (trace.depth + 1), ' ');
+    printf("%s%s <= %s::%s", indent.c_str(),
+           NameToString(trace.receiver).c_str(),
+           NameToString(trace.action.account).c_str(),
+           NameToString(trace.action.name).c_str());
+    if (!trace.ran) {
+      printf("  (no contract)\n");
+      continue;
+    }
+    if (trace.counts_instructions) {
+      printf("  %" PRIu64 " instructions", trace.instructions);
+    }
+    printf("  %.1f us\n", trace.microseconds);
+    if (!trace.console.empty()) {
+      size_t begin = 0;
+      while (begin < trace.console.size()) {
+        size_t end = trace.console.find('\n', begin);
+        if (end == std::string::npos) {
+          end = trace.console.size();
+        }
+        printf("%s  >> %s\n", indent.c_str(),
+               trace.console.substr(begin, end - begin).c_str());
+        begin = end + 1;
+      }
+    }
+    for (const std::string& note : trace.notes) {
+      printf("%s  note: %s\n", indent.c_str(), note.c_str());
+    }
+    if (!trace.ok) {
+      printf("%s  error: %s\n", indent.c_str(), trace.error.c_str());
+    }
+  }
+}
+
+/*
+ * Host
+ */
+
+Host::Host() : emulator_(new Emulator) {}
+
+Host::~Host() {}
+
+int Host::Bind(const std::string& name,
+               const std::string& signature,
+               std::string* error) {
+  return emulator_->Bind(name, signature, error);
+}
+
+bool Host::IsSupported(int binding) const {
+  return emulator_->IsSupported(binding);
+}
+
+HostStatus Host::Call(int binding, const HostValue* args, HostValue* out) {
+  return emulator_->Call(binding, args, out);
+}
+
+void Host::Deploy(uint64_t account, std::unique_ptr<Engine> engine) {
+  emulator_->Deploy(account, std::move(engine));
+}
+
+void Host::TraceAllocations(FILE* file) {
+  emulator_->TraceAllocations(file);
+}
+
+bool Host::PushTransaction(const Action& action,
+                           std::vector<ApplyTrace>* traces) {
+  return emulator_->PushTransaction(action, traces);
+}
+
+int RunTransactions(Host* host, const std::vector<Action>& actions) {
+  size_t failed = 0;
+  bool counts_instructions = true;
+  uint64_t total_instructions = 0;
+  double total_microseconds = 0;
+  for (size_t i = 0; i < actions.size(); ++i) {
+    std::vector<ApplyTrace> traces;
+    bool ok = host->PushTransaction(actions[i], &traces);
+    WriteTraces(i + 1, actions[i], ok, traces);
+    failed += !ok;
+    for (const ApplyTrace& trace : traces) {
+      counts_instructions &= !trace.ran || trace.counts_instructions;
+      total_instructions += trace.instructions;
+      total_microseconds += trace.microseconds;
+    }
+  }
+  printf("%zu transactions, %zu failed, ", actions.size(), failed);
+  if (counts_instructions) {
+    printf("%" PRIu64 " instructions, ", total_instructions);
+  }
+  printf("%.1f us\n", total_microseconds);
+  return failed != 0;
+}
+
+}  // namespace eosio
+}  // namespace wabt
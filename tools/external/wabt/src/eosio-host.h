@@ -0,0 +1,145 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WABT_EOSIO_HOST_H_
+#define WABT_EOSIO_HOST_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Emulation of the EOSIO intrinsics shared by the tools running contracts
+// locally: an in-memory table store, action data, authorization, console
+// capture and hashing. It does not depend on how the contract code itself is
+// executed, which is left to an Engine.
+
+namespace wabt {
+namespace eosio {
+
+bool StringToName(const std::string& str, uint64_t* out);
+std::string NameToString(uint64_t value);
+
+struct Permission {
+  uint64_t actor;
+  uint64_t permission;
+};
+
+struct Action {
+  uint64_t account = 0;
+  uint64_t name = 0;
+  std::vector<Permission> authorization;
+  std::vector<uint8_t> data;
+};
+
+// Reads a JSON array of actions, their data being the hex encoded binary
+// serialization of the action arguments. Errors are reported on stderr.
+bool ReadActions(const std::string& filename, std::vector<Action>* out);
+
+// The raw bits of a WebAssembly value passed to or returned by an intrinsic.
+union HostValue {
+  uint32_t i32;
+  uint64_t i64;
+  uint32_t f32_bits;
+  uint64_t f64_bits;
+};
+
+enum class HostStatus {
+  Ok,
+  Trap,  // The action stops; the trace records why.
+};
+
+struct ApplyTrace {
+  uint64_t receiver = 0;
+  Action action;
+  unsigned depth = 0;
+  bool ran = false;
+  bool ok = true;
+  std::string error;
+  std::string console;
+  std::vector<std::string> notes;
+  bool counts_instructions = false;
+  uint64_t instructions = 0;
+  double microseconds = 0;
+};
+
+// Executes the code of one deployed contract.
+class Engine {
+ public:
+  virtual ~Engine() {}
+
+  // Linear memory of the running instance. It may move when the memory grows,
+  // so it is queried again on every intrinsic call.
+  virtual uint8_t* memory_data() = 0;
+  virtual uint64_t memory_size() = 0;
+
+  // Whether Apply reports the number of instructions executed.
+  virtual bool counts_instructions() const { return false; }
+
+  // Name of the function `depth` calls up the stack from the one calling the
+  // current intrinsic, empty if it is unknown.
+  virtual std::string GetCaller(unsigned depth) { return std::string(); }
+
+  // Calls apply(receiver, code, action) on a fresh instance of the contract,
+  // returning false with a description of the trap if it does not return.
+  virtual bool Apply(uint64_t receiver,
+                     uint64_t code,
+                     uint64_t action,
+                     std::string* trap,
+                     uint64_t* instructions) = 0;
+};
+
+class Emulator;
+
+class Host {
+ public:
+  Host();
+  ~Host();
+
+  // Resolves an intrinsic imported from "env", given its signature as
+  // parameter types then result types ("(iiI)i", using i, I, f and F for i32,
+  // i64, f32 and f64). Intrinsics that cannot be emulated are bound to a stub
+  // failing the action calling them. Returns -1 on a signature mismatch.
+  int Bind(const std::string& name,
+           const std::string& signature,
+           std::string* error);
+  bool IsSupported(int binding) const;
+  HostStatus Call(int binding, const HostValue* args, HostValue* out);
+
+  void Deploy(uint64_t account, std::unique_ptr<Engine> engine);
+
+  // Writes the allocations the contracts linked with -fmalloc-trace report
+  // through the trace_alloc intrinsic to `file`, after a line naming the
+  // action applied.
+  void TraceAllocations(FILE* file);
+
+  // Runs an action as its own transaction, rolling back its table changes if
+  // it fails.
+  bool PushTransaction(const Action& action, std::vector<ApplyTrace>* traces);
+
+ private:
+  std::unique_ptr<Emulator> emulator_;
+};
+
+// Pushes every action as a transaction and prints their traces followed by a
+// summary. Returns the exit code of the run.
+int RunTransactions(Host* host, const std::vector<Action>& actions);
+
+}  // namespace eosio
+}  // namespace wabt
+
+#endif /* WABT_EOSIO_HOST_H_ */
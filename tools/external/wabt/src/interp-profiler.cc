@@ -0,0 +1,211 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "src/interp-profiler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+
+#include "src/cast.h"
+
+namespace wabt {
+namespace interp {
+
+Profiler::Profiler(Environment* env) : env_(env) {
+  nodes_.emplace_back(kInvalidIndex, kInvalidIndex);
+}
+
+void Profiler::AddModule(const std::string& root,
+                         Index first_func,
+                         const std::vector<std::string>& names) {
+  AddFuncs();
+  for (Index i = 0; i < names.size() && first_func + i < funcs_.size(); ++i) {
+    funcs_[first_func + i].name = names[i];
+    roots_[first_func + i] = root;
+  }
+}
+
+void Profiler::AddFuncs() {
+  Index count = env_->GetFuncCount();
+  funcs_.resize(count);
+  roots_.resize(count);
+  active_.resize(count);
+  for (; func_count_ < count; ++func_count_) {
+    if (auto* func = dyn_cast<DefinedFunc>(env_->GetFunc(func_count_))) {
+      funcs_by_offset_[func->offset] = func_count_;
+    }
+  }
+}
+
+Index Profiler::FindFunc(IstreamOffset func_offset) {
+  auto found = funcs_by_offset_.find(func_offset);
+  if (found == funcs_by_offset_.end()) {
+    AddFuncs();
+    found = funcs_by_offset_.find(func_offset);
+    assert(found != funcs_by_offset_.end());
+  }
+  return found->second;
+}
+
+Index Profiler::GetChild(Index node, Index func_index) {
+  auto found = nodes_[node].children.find(func_index);
+  if (found != nodes_[node].children.end()) {
+    return found->second;
+  }
+  Index child = nodes_.size();
+  nodes_.emplace_back(func_index, node);
+  nodes_[node].children.emplace(func_index, child);
+  return child;
+}
+
+// Charges the instructions executed since the last event to the function on
+// top of the stack.
+void Profiler::Charge(uint64_t instruction_count) {
+  if (!frames_.empty()) {
+    uint64_t delta = instruction_count - last_count_;
+    funcs_[frames_.back().func_index].exclusive += delta;
+    nodes_[frames_.back().node].instructions += delta;
+  }
+  last_count_ = instruction_count;
+}
+
+void Profiler::Enter(IstreamOffset func_offset, uint64_t instruction_count) {
+  Charge(instruction_count);
+  Index func_index = FindFunc(func_offset);
+  Index parent = frames_.empty() ? 0 : frames_.back().node;
+  frames_.push_back({func_index, GetChild(parent, func_index),
+                     instruction_count});
+  funcs_[func_index].calls++;
+  active_[func_index]++;
+}
+
+void Profiler::Return(uint64_t instruction_count) {
+  Charge(instruction_count);
+  if (frames_.empty()) {
+    // The outermost call was not reported with Enter.
+    return;
+  }
+  const Frame& frame = frames_.back();
+  if (--active_[frame.func_index] == 0) {
+    funcs_[frame.func_index].inclusive += instruction_count - frame.start;
+  }
+  frames_.pop_back();
+}
+
+void Profiler::CallHost(Index func_index, uint64_t instruction_count) {
+  Charge(instruction_count);
+  if (func_index >= funcs_.size()) {
+    AddFuncs();
+  }
+  funcs_[func_index].calls++;
+  if (!frames_.empty()) {
+    funcs_[frames_.back().func_index].host_calls++;
+  }
+}
+
+void Profiler::Unwind(uint64_t instruction_count) {
+  while (!frames_.empty()) {
+    Return(instruction_count);
+  }
+}
+
+std::string Profiler::FuncName(Index func_index) const {
+  if (!funcs_[func_index].name.empty()) {
+    return funcs_[func_index].name;
+  }
+  if (auto* func = dyn_cast<HostFunc>(env_->GetFunc(func_index))) {
+    return func->module_name + "." + func->field_name;
+  }
+  return "func[" + std::to_string(func_index) + "]";
+}
+
+std::string Profiler::QualifiedName(Index func_index) const {
+  if (roots_[func_index].empty()) {
+    return FuncName(func_index);
+  }
+  return roots_[func_index] + ":" + FuncName(func_index);
+}
+
+void Profiler::WriteStack(Stream* stream, Index node) const {
+  Index parent = nodes_[node].parent;
+  Index func_index = nodes_[node].func_index;
+  if (parent != 0) {
+    WriteStack(stream, parent);
+    stream->WriteChar(';');
+  } else if (!roots_[func_index].empty()) {
+    stream->Writef("%s;", roots_[func_index].c_str());
+  }
+  stream->Writef("%s", FuncName(func_index).c_str());
+}
+
+void Profiler::WriteCollapsedStacks(Stream* stream) const {
+  for (Index node = 1; node < nodes_.size(); ++node) {
+    if (nodes_[node].instructions) {
+      WriteStack(stream, node);
+      stream->Writef(" %" PRIu64 "\n", nodes_[node].instructions);
+    }
+  }
+}
+
+void Profiler::WriteReport(Stream* stream) const {
+  uint64_t total = 0;
+  std::vector<Index> defined;
+  std::vector<Index> host;
+  for (Index i = 0; i < funcs_.size(); ++i) {
+    if (!funcs_[i].calls) {
+      continue;
+    }
+    if (env_->GetFunc(i)->is_host) {
+      host.push_back(i);
+    } else {
+      defined.push_back(i);
+      total += funcs_[i].exclusive;
+    }
+  }
+  auto by_cost = [this](Index a, Index b) {
+    if (funcs_[a].exclusive != funcs_[b].exclusive) {
+      return funcs_[a].exclusive > funcs_[b].exclusive;
+    }
+    return funcs_[a].inclusive > funcs_[b].inclusive;
+  };
+  std::sort(defined.begin(), defined.end(), by_cost);
+  std::sort(host.begin(), host.end(), [this](Index a, Index b) {
+    return funcs_[a].calls > funcs_[b].calls;
+  });
+
+  stream->Writef("%" PRIu64 " instructions executed\n\n", total);
+  stream->Writef("%14s %7s %14s %10s %10s  %s\n", "exclusive", "%",
+                 "inclusive", "calls", "host calls", "function");
+  for (Index i : defined) {
+    const FuncProfile& func = funcs_[i];
+    stream->Writef("%14" PRIu64 " %6.2f%% %14" PRIu64 " %10" PRIu64
+                   " %10" PRIu64 "  %s\n",
+                   func.exclusive, total ? 100.0 * func.exclusive / total : 0,
+                   func.inclusive, func.calls, func.host_calls,
+                   QualifiedName(i).c_str());
+  }
+  if (!host.empty()) {
+    stream->Writef("\n%10s  %s\n", "calls", "host function");
+    for (Index i : host) {
+      stream->Writef("%10" PRIu64 "  %s\n", funcs_[i].calls,
+                     QualifiedName(i).c_str());
+    }
+  }
+}
+
+}  // namespace interp
+}  // namespace wabt
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WABT_INTERP_PROFILER_H_
+#define WABT_INTERP_PROFILER_H_
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "src/common.h"
+#include "src/interp.h"
+#include "src/stream.h"
+
+// Dynamic profile of the code run by a Thread: calls, instructions executed
+// and host calls of every function, and the instructions executed under every
+// distinct call stack. The thread reports its calls and returns to the
+// profiler it was given with Thread::set_profiler; the code running it reports
+// the outermost call with Enter and abandoned calls with Unwind.
+
+namespace wabt {
+namespace interp {
+
+struct FuncProfile {
+  std::string name;
+  uint64_t calls = 0;
+  // Instructions executed by the function itself.
+  uint64_t exclusive = 0;
+  // Instructions executed by the function and everything it called, counted
+  // once for recursive calls.
+  uint64_t inclusive = 0;
+  // Calls made by the function to host functions.
+  uint64_t host_calls = 0;
+};
+
+class Profiler {
+ public:
+  explicit Profiler(Environment* env);
+
+  // Names the functions of a module loaded in the environment, `names[i]`
+  // being the name of the environment function `first_func + i`. Stacks of
+  // the functions of the module start with the frame `root`, if not empty.
+  void AddModule(const std::string& root,
+                 Index first_func,
+                 const std::vector<std::string>& names);
+
+  // Called with the instruction count of the thread (Thread::instruction_count)
+  // when it enters a function.
+  void Enter(IstreamOffset func_offset, uint64_t instruction_count);
+  // Called when a defined function returns, including the outermost one.
+  void Return(uint64_t instruction_count);
+  void CallHost(Index func_index, uint64_t instruction_count);
+  // Drops the calls left on the stack when the thread stops on a trap.
+  void Unwind(uint64_t instruction_count);
+
+  const FuncProfile& GetFuncProfile(Index func_index) const {
+    return funcs_[func_index];
+  }
+
+  // Writes a line "root;caller;callee COUNT" per call stack under which
+  // instructions were executed, the format of flamegraph.pl.
+  void WriteCollapsedStacks(Stream* stream) const;
+  // Writes the functions that ran, by descending exclusive instruction count,
+  // followed by the number of calls of every host function.
+  void WriteReport(Stream* stream) const;
+
+ private:
+  struct Node {
+    Node(Index func_index, Index parent)
+        : func_index(func_index), parent(parent) {}
+
+    Index func_index;
+    Index parent;
+    uint64_t instructions = 0;
+    std::map<Index, Index> children;
+  };
+
+  struct Frame {
+    Index func_index;
+    Index node;
+    uint64_t start;
+  };
+
+  void AddFuncs();
+  Index FindFunc(IstreamOffset func_offset);
+  Index GetChild(Index node, Index func_index);
+  void Charge(uint64_t instruction_count);
+  std::string FuncName(Index func_index) const;
+  std::string QualifiedName(Index func_index) const;
+  void WriteStack(Stream* stream, Index node) const;
+
+  Environment* env_;
+  std::vector<FuncProfile> funcs_;
+  // The root frame of the stacks of every function.
+  std::vector<std::string> roots_;
+  std::unordered_map<IstreamOffset, Index> funcs_by_offset_;
+  // Number of environment functions in funcs_by_offset_ and funcs_.
+  Index func_count_ = 0;
+  std::vector<Index> active_;
+  // nodes_[0] is the root of the call tree.
+  std::vector<Node> nodes_;
+  std::vector<Frame> frames_;
+  uint64_t last_count_ = 0;
+};
+
+}  // namespace interp
+}  // namespace wabt
+
+#endif /* WABT_INTERP_PROFILER_H_ */
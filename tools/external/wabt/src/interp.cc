@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "src/cast.h"
+#include "src/interp-profiler.h"
 #include "src/stream.h"
 
 namespace wabt {
@@ -1443,6 +1444,7 @@ Result Thread::Run(int num_instructions) {
   for (int i = 0; i < num_instructions; ++i) {
     Opcode opcode = ReadOpcode(&pc);
     assert(!opcode.IsInvalid());
+    ++instruction_count_;
     switch (opcode) {
       case Opcode::Select: {
         uint32_t cond = Pop<uint32_t>();
@@ -1481,6 +1483,9 @@ Result Thread::Run(int num_instructions) {
       }
 
       case Opcode::Return:
+        if (profiler_) {
+          profiler_->Return(instruction_count_);
+        }
         if (call_stack_top_ == 0) {
           result = Result::Returned;
           goto exit_loop;
@@ -1541,6 +1546,9 @@ Result Thread::Run(int num_instructions) {
       case Opcode::Call: {
         IstreamOffset offset = ReadU32(&pc);
         CHECK_TRAP(PushCall(pc));
+        if (profiler_) {
+          profiler_->Enter(offset, instruction_count_);
+        }
         GOTO(offset);
         break;
       }
@@ -1557,9 +1565,16 @@ Result Thread::Run(int num_instructions) {
         TRAP_UNLESS(env_->FuncSignaturesAreEqual(func->sig_index, sig_index),
                     IndirectCallSignatureMismatch);
         if (func->is_host) {
+          if (profiler_) {
+            profiler_->CallHost(func_index, instruction_count_);
+          }
           CallHost(cast<HostFunc>(func));
         } else {
           CHECK_TRAP(PushCall(pc));
+          if (profiler_) {
+            profiler_->Enter(cast<DefinedFunc>(func)->offset,
+                             instruction_count_);
+          }
           GOTO(cast<DefinedFunc>(func)->offset);
         }
         break;
@@ -1567,7 +1582,10 @@ Result Thread::Run(int num_instructions) {
 
       case Opcode::InterpCallHost: {
         Index func_index = ReadU32(&pc);
-        CallHost(cast<HostFunc>(env_->funcs_[func_index].get()));
+        if (profiler_) {
+          profiler_->CallHost(func_index, instruction_count_);
+        }
+        CHECK_TRAP(CallHost(cast<HostFunc>(env_->funcs_[func_index].get())));
         break;
       }
 
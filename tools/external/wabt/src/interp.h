@@ -463,6 +463,8 @@ class Environment {
   BindingHash registered_module_bindings_;
 };
 
+class Profiler;
+
 class Thread {
  public:
   struct Options {
@@ -492,6 +494,18 @@ class Thread {
   void Trace(Stream*);
   Result Run(int num_instructions = 1);
 
+  // Number of instructions run by the thread since it was created.
+  uint64_t instruction_count() const { return instruction_count_; }
+  // Reports the calls and returns of the thread to `profiler` while set.
+  void set_profiler(Profiler* profiler) { profiler_ = profiler; }
+
+  // Number of calls on the call stack, and the offset a call returns to,
+  // `depth` calls from the innermost one.
+  Index call_stack_depth() const { return call_stack_top_; }
+  IstreamOffset call_stack_at(Index depth) const {
+    return call_stack_[call_stack_top_ - 1 - depth];
+  }
+
   Result CallHost(HostFunc*);
 
  private:
@@ -568,6 +582,8 @@ class Thread {
   uint32_t value_stack_top_ = 0;
   uint32_t call_stack_top_ = 0;
   IstreamOffset pc_ = 0;
+  uint64_t instruction_count_ = 0;
+  Profiler* profiler_ = nullptr;
 };
 
 struct ExecResult {
@@ -0,0 +1,644 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "src/apply-names.h"
+#include "src/binary-reader-ir.h"
+#include "src/binary-reader.h"
+#include "src/c-writer.h"
+#include "src/cast.h"
+#include "src/error-handler.h"
+#include "src/feature.h"
+#include "src/generate-names.h"
+#include "src/ir.h"
+#include "src/option-parser.h"
+#include "src/stream.h"
+#include "src/validator.h"
+
+using namespace wabt;
+
+static int s_verbose;
+static std::string s_infile;
+static std::string s_outfile;
+static std::string s_account;
+static std::vector<std::string> s_deploy;
+static std::string s_cc;
+static std::string s_cxx;
+static std::string s_runtime_dir;
+static std::string s_c_dir;
+static std::string s_opt_level = "2";
+static bool s_shared;
+static Features s_features;
+static std::unique_ptr<FileStream> s_log_stream;
+
+static const char s_description[] =
+R"(  Compile contracts in the WebAssembly binary format ahead of time to a native executable
+  running actions against the emulated EOSIO intrinsics of eosio-run.
+
+  Every contract is translated to C with wasm2c, then compiled with the host C compiler and
+  linked against the eosio-aot runtime. The resulting executable takes the actions file of
+  eosio-run and prints the same traces, without instruction counts, at native speed; it
+  executes the compiled contract rather than a -fnative rebuild of its sources.
+
+  $ eosio-aot hello.wasm -o hello
+  $ ./hello actions.json
+
+  # also deploy token.wasm on the account eosio.token
+  $ eosio-aot hello.wasm --account hello --deploy eosio.token:token.wasm -o replay
+
+  # build a shared object exporting eosio_aot_run(argc, argv)
+  $ eosio-aot hello.wasm --shared -o hello.so
+)";
+
+static void ParseOptions(int argc, char** argv) {
+  OptionParser parser("eosio-aot", s_description);
+
+  parser.AddOption('v', "verbose", "Use multiple times for more info", []() {
+    s_verbose++;
+    s_log_stream = FileStream::CreateStdout();
+  });
+  parser.AddHelpOption();
+  parser.AddOption('o', "output", "FILENAME",
+                   "Output file, defaults to the input file without its "
+                   "extension",
+                   [](const std::string& argument) { s_outfile = argument; });
+  parser.AddOption('a', "account", "ACCOUNT",
+                   "Account the contract is deployed on, defaults to the "
+                   "account of the first action of the run",
+                   [](const std::string& argument) { s_account = argument; });
+  parser.AddOption('d', "deploy", "ACCOUNT:FILENAME",
+                   "Also compile the contract FILENAME, deployed on ACCOUNT, "
+                   "to handle notifications and inline actions",
+                   [](const std::string& argument) {
+                     s_deploy.push_back(argument);
+                   });
+  parser.AddOption("shared", "Build a shared object instead of an executable",
+                   []() { s_shared = true; });
+  parser.AddOption('O', "opt-level", "LEVEL",
+                   "Optimization level passed to the C compiler, defaults "
+                   "to 2",
+                   [](const std::string& argument) { s_opt_level = argument; });
+  auto add_long_option = [&parser](const char* long_name,
+                                   const char* metavar, const char* help,
+                                   std::string* out) {
+    parser.AddOption(OptionParser::Option(
+        '\0', long_name, metavar, OptionParser::HasArgument::Yes, help,
+        [out](const char* argument) { *out = argument; }));
+  };
+  add_long_option("cc", "COMPILER", "C compiler, defaults to $CC or cc",
+                  &s_cc);
+  add_long_option("cxx", "COMPILER",
+                  "C++ compiler used to link, defaults to $CXX or c++",
+                  &s_cxx);
+  add_long_option("runtime", "DIRECTORY",
+                  "Directory of the eosio-aot runtime library and sources, "
+                  "defaults to ../lib/eosio-aot next to eosio-aot",
+                  &s_runtime_dir);
+  add_long_option("c-dir", "DIRECTORY",
+                  "Write the generated C sources to DIRECTORY and keep them",
+                  &s_c_dir);
+  parser.AddArgument("filename", OptionParser::ArgumentCount::One,
+                     [](const char* argument) { s_infile = argument; });
+  parser.Parse(argc, argv);
+}
+
+struct Contract {
+  std::string account;  // Empty for the account given at run time.
+  std::string filename;
+  std::string prefix;
+  bool has_table = false;
+};
+
+struct ImportedFunc {
+  std::string field_name;
+  TypeVector param_types;
+  TypeVector result_types;
+};
+
+// Mirrors the mangling of names by the C writer.
+static std::string MangleName(string_view name) {
+  std::string result = "Z_";
+  for (char c : name) {
+    if ((isalnum(c) && c != 'Z') || c == '_') {
+      result += c;
+    } else {
+      static const char kHexDigits[] = "0123456789ABCDEF";
+      uint8_t byte = static_cast<uint8_t>(c);
+      result += 'Z';
+      result += kHexDigits[byte >> 4];
+      result += kHexDigits[byte & 0xf];
+    }
+  }
+  return result;
+}
+
+static std::string MangleTypes(const TypeVector& types) {
+  if (types.empty()) {
+    return "v";
+  }
+  std::string result;
+  for (Type type : types) {
+    switch (type) {
+      case Type::I32: result += 'i'; break;
+      case Type::I64: result += 'j'; break;
+      case Type::F32: result += 'f'; break;
+      case Type::F64: result += 'd'; break;
+      default: WABT_UNREACHABLE;
+    }
+  }
+  return result;
+}
+
+static const char* CType(Type type) {
+  switch (type) {
+    case Type::I32: return "uint32_t";
+    case Type::I64: return "uint64_t";
+    case Type::F32: return "float";
+    case Type::F64: return "double";
+    default: WABT_UNREACHABLE;
+  }
+}
+
+static const char* ValueField(Type type) {
+  switch (type) {
+    case Type::I32: return "i32";
+    case Type::I64: return "i64";
+    case Type::F32: return "f32_bits";
+    case Type::F64: return "f64_bits";
+    default: WABT_UNREACHABLE;
+  }
+}
+
+// The signature of an intrinsic, as expected by eosio::Host::Bind.
+static std::string HostSignature(const ImportedFunc& func) {
+  auto type_char = [](Type type) {
+    switch (type) {
+      case Type::I32: return 'i';
+      case Type::I64: return 'I';
+      case Type::F32: return 'f';
+      default: return 'F';
+    }
+  };
+  std::string str = "(";
+  for (Type type : func.param_types) {
+    str += type_char(type);
+  }
+  str += ")";
+  for (Type type : func.result_types) {
+    str += type_char(type);
+  }
+  return str;
+}
+
+static std::string CString(const std::string& str) {
+  std::string result = "\"";
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+    }
+    result += c;
+  }
+  return result + "\"";
+}
+
+static bool IsSupportedType(Type type) {
+  return type == Type::I32 || type == Type::I64 || type == Type::F32 ||
+         type == Type::F64;
+}
+
+static void AddExport(Module* module,
+                      const std::string& name,
+                      ExternalKind kind,
+                      Index index) {
+  auto field = MakeUnique<ExportModuleField>();
+  field->export_.name = name;
+  field->export_.kind = kind;
+  field->export_.var = Var(index);
+  module->AppendField(std::move(field));
+}
+
+// Translates a contract to C, exporting its memory and table under reserved
+// names so the glue can reset and inspect every instance, and records the
+// intrinsics it imports.
+static Result TranslateContract(Contract* contract,
+                                const std::string& c_filename,
+                                const std::string& h_filename,
+                                std::map<std::string, ImportedFunc>* imports) {
+  std::vector<uint8_t> file_data;
+  CHECK_RESULT(ReadFile(contract->filename.c_str(), &file_data));
+
+  ErrorHandlerFile error_handler(Location::Type::Binary);
+  Module module;
+  const bool kReadDebugNames = true;
+  const bool kStopOnFirstError = true;
+  const bool kFailOnCustomSectionError = true;
+  // A single -v only prints the compiler commands.
+  Stream* log_stream = s_verbose > 1 ? s_log_stream.get() : nullptr;
+  ReadBinaryOptions options(s_features, log_stream, kReadDebugNames,
+                            kStopOnFirstError, kFailOnCustomSectionError);
+  CHECK_RESULT(ReadBinaryIr(contract->filename.c_str(), file_data.data(),
+                            file_data.size(), &options, &error_handler,
+                            &module));
+  ValidateOptions validate_options(s_features);
+  WastLexer* lexer = nullptr;
+  CHECK_RESULT(
+      ValidateModule(lexer, &module, &error_handler, &validate_options));
+
+  const char* filename = contract->filename.c_str();
+  for (const Import* import : module.imports) {
+    if (import->kind() != ExternalKind::Func || import->module_name != "env") {
+      fprintf(stderr, "%s: import \"%s.%s\" is not an intrinsic\n", filename,
+              import->module_name.c_str(), import->field_name.c_str());
+      return Result::Error;
+    }
+    const FuncSignature& sig = cast<FuncImport>(import)->func.decl.sig;
+    ImportedFunc func{import->field_name, sig.param_types, sig.result_types};
+    if (!std::all_of(sig.param_types.begin(), sig.param_types.end(),
+                     IsSupportedType) ||
+        !std::all_of(sig.result_types.begin(), sig.result_types.end(),
+                     IsSupportedType)) {
+      fprintf(stderr, "%s: intrinsic %s has an unsupported signature\n",
+              filename, import->field_name.c_str());
+      return Result::Error;
+    }
+    std::string mangled =
+        MangleName(import->module_name) + MangleName(import->field_name) +
+        MangleName(MangleTypes(sig.result_types) +
+                   MangleTypes(sig.param_types));
+    imports->emplace(mangled, func);
+  }
+
+  const Export* apply = module.GetExport("apply");
+  const Func* apply_func = apply && apply->kind == ExternalKind::Func
+                               ? module.GetFunc(apply->var)
+                               : nullptr;
+  if (!apply_func || apply_func->decl.sig.param_types !=
+                         TypeVector{Type::I64, Type::I64, Type::I64} ||
+      !apply_func->decl.sig.result_types.empty()) {
+    fprintf(stderr, "%s: no exported apply(i64, i64, i64) function\n",
+            filename);
+    return Result::Error;
+  }
+  if (module.memories.empty()) {
+    fprintf(stderr, "%s: no memory defined\n", filename);
+    return Result::Error;
+  }
+  if (!module.starts.empty()) {
+    fprintf(stderr, "%s: contracts cannot have a start function\n", filename);
+    return Result::Error;
+  }
+  AddExport(&module, "eosio_aot_memory", ExternalKind::Memory, 0);
+  if (!module.tables.empty()) {
+    AddExport(&module, "eosio_aot_table", ExternalKind::Table, 0);
+    contract->has_table = true;
+  }
+
+  CHECK_RESULT(GenerateNames(&module));
+  Result dummy_result = ApplyNames(&module);
+  WABT_USE(dummy_result);
+
+  FileStream c_stream(c_filename);
+  FileStream h_stream(h_filename);
+  if (!c_stream.is_open() || !h_stream.is_open()) {
+    fprintf(stderr, "unable to write %s\n", c_filename.c_str());
+    return Result::Error;
+  }
+  std::string header_name = h_filename.substr(h_filename.rfind('/') + 1);
+  WriteCOptions write_c_options;
+  return WriteC(&c_stream, &h_stream, header_name.c_str(), &module,
+                &write_c_options);
+}
+
+// Writes the C glue: the definitions of the imported intrinsics, forwarding
+// to the runtime, the reset and apply entry points of every contract, and the
+// main function of the executable.
+static Result WriteGlue(const std::string& filename,
+                        const std::vector<Contract>& contracts,
+                        const std::map<std::string, ImportedFunc>& imports) {
+  FileStream stream(filename);
+  if (!stream.is_open()) {
+    fprintf(stderr, "unable to write %s\n", filename.c_str());
+    return Result::Error;
+  }
+  stream.Writef("/* Generated by eosio-aot. */\n\n");
+  stream.Writef("#include <stdint.h>\n#include <stdlib.h>\n#include <string.h>\n\n");
+  stream.Writef("#include \"eosio-aot-rt.h\"\n#include \"wasm-rt-impl.h\"\n");
+
+  size_t index = 0;
+  for (const auto& pair : imports) {
+    const ImportedFunc& func = pair.second;
+    std::string result_type =
+        func.result_types.empty() ? "void" : CType(func.result_types[0]);
+    std::string params;
+    std::string param_types;
+    for (size_t i = 0; i < func.param_types.size(); ++i) {
+      const char* separator = i ? ", " : "";
+      std::string type = CType(func.param_types[i]);
+      params += separator + type + " a" + std::to_string(i);
+      param_types += separator + type;
+    }
+    if (params.empty()) {
+      params = param_types = "void";
+    }
+
+    stream.Writef("\n/* import: 'env' '%s' */\n", func.field_name.c_str());
+    stream.Writef("static int eosio_aot_binding_%zu;\n", index);
+    stream.Writef("static %s eosio_aot_import_%zu(%s) {\n", result_type.c_str(),
+                  index, params.c_str());
+    stream.Writef("  eosio_aot_value args[%zu], result;\n",
+                  func.param_types.empty() ? 1 : func.param_types.size());
+    for (size_t i = 0; i < func.param_types.size(); ++i) {
+      stream.Writef("  memcpy(&args[%zu].%s, &a%zu, sizeof(a%zu));\n", i,
+                    ValueField(func.param_types[i]), i, i);
+    }
+    stream.Writef("  result.i64 = 0;\n");
+    stream.Writef("  if (eosio_aot_call(eosio_aot_binding_%zu, args, &result))\n",
+                  index);
+    stream.Writef("    wasm_rt_trap(WASM_RT_TRAP_UNREACHABLE);\n");
+    if (!func.result_types.empty()) {
+      stream.Writef("  %s value;\n", result_type.c_str());
+      stream.Writef("  memcpy(&value, &result.%s, sizeof(value));\n",
+                    ValueField(func.result_types[0]));
+      stream.Writef("  return value;\n");
+    }
+    stream.Writef("}\n");
+    stream.Writef("%s (*%s)(%s) = eosio_aot_import_%zu;\n", result_type.c_str(),
+                  pair.first.c_str(), param_types.c_str(), index);
+    ++index;
+  }
+
+  for (const Contract& contract : contracts) {
+    const char* prefix = contract.prefix.c_str();
+    stream.Writef("\n/* contract: %s */\n", contract.filename.c_str());
+    stream.Writef("extern void %sinit(void);\n", prefix);
+    stream.Writef("extern void (*%sZ_applyZ_vjjj)(uint64_t, uint64_t, uint64_t);\n",
+                  prefix);
+    stream.Writef("extern wasm_rt_memory_t (*%sZ_eosio_aot_memory);\n", prefix);
+    if (contract.has_table) {
+      stream.Writef("extern wasm_rt_table_t (*%sZ_eosio_aot_table);\n", prefix);
+    }
+    stream.Writef("\nstatic void %sreset(void) {\n", prefix);
+    stream.Writef("  if (%sZ_eosio_aot_memory)\n", prefix);
+    stream.Writef("    free(%sZ_eosio_aot_memory->data);\n", prefix);
+    if (contract.has_table) {
+      stream.Writef("  if (%sZ_eosio_aot_table)\n", prefix);
+      stream.Writef("    free(%sZ_eosio_aot_table->data);\n", prefix);
+    }
+    stream.Writef("  %sinit();\n}\n", prefix);
+    stream.Writef("\nstatic wasm_rt_trap_t %sapply(uint64_t receiver, "
+                  "uint64_t code, uint64_t action) {\n", prefix);
+    stream.Writef("  wasm_rt_trap_t trap = (wasm_rt_trap_t)wasm_rt_impl_try();\n");
+    stream.Writef("  if (trap != WASM_RT_TRAP_NONE) {\n");
+    stream.Writef("    wasm_rt_call_stack_depth = 0;\n");
+    stream.Writef("    return trap;\n  }\n");
+    stream.Writef("  (*%sZ_applyZ_vjjj)(receiver, code, action);\n", prefix);
+    stream.Writef("  return WASM_RT_TRAP_NONE;\n}\n");
+    stream.Writef("\nstatic wasm_rt_memory_t* %smemory(void) {\n", prefix);
+    stream.Writef("  return %sZ_eosio_aot_memory;\n}\n", prefix);
+  }
+
+  stream.Writef("\nstatic const eosio_aot_contract eosio_aot_contracts[] = {\n");
+  for (const Contract& contract : contracts) {
+    const char* prefix = contract.prefix.c_str();
+    std::string account =
+        contract.account.empty() ? "NULL" : CString(contract.account);
+    stream.Writef("  {%s, %s, %sreset, %sapply, %smemory},\n", account.c_str(),
+                  CString(contract.filename).c_str(), prefix, prefix, prefix);
+  }
+  stream.Writef("};\n");
+
+  stream.Writef("\nstatic int eosio_aot_bind_imports(void) {\n");
+  index = 0;
+  for (const auto& pair : imports) {
+    stream.Writef("  if ((eosio_aot_binding_%zu = eosio_aot_bind(%s, \"%s\")) < 0)\n",
+                  index, CString(pair.second.field_name).c_str(),
+                  HostSignature(pair.second).c_str());
+    stream.Writef("    return -1;\n");
+    ++index;
+  }
+  stream.Writef("  return 0;\n}\n");
+
+  stream.Writef("\nint eosio_aot_run(int argc, char** argv) {\n");
+  stream.Writef("  return eosio_aot_main(argc, argv, eosio_aot_contracts, %zu,\n",
+                contracts.size());
+  stream.Writef("                        eosio_aot_bind_imports);\n}\n");
+  if (!s_shared) {
+    stream.Writef("\nint main(int argc, char** argv) {\n");
+    stream.Writef("  return eosio_aot_run(argc, argv);\n}\n");
+  }
+  return Result::Ok;
+}
+
+static std::string ShellQuote(const std::string& str) {
+  std::string result = "'";
+  for (char c : str) {
+    if (c == '\'') {
+      result += "'\\''";
+    } else {
+      result += c;
+    }
+  }
+  return result + "'";
+}
+
+static Result RunCommand(const std::string& command) {
+  if (s_verbose) {
+    s_log_stream->Writef("%s\n", command.c_str());
+  }
+  if (system(command.c_str()) != 0) {
+    fprintf(stderr, "command failed: %s\n", command.c_str());
+    return Result::Error;
+  }
+  return Result::Ok;
+}
+
+static std::string Dirname(const std::string& path) {
+  size_t slash = path.rfind('/');
+  return slash == std::string::npos ? "." : path.substr(0, slash);
+}
+
+// The runtime is installed in lib/eosio-aot, next to the bin directory of
+// eosio-aot.
+static std::string DefaultRuntimeDir(const char* argv0) {
+  char path[PATH_MAX];
+  ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+  if (length > 0) {
+    path[length] = '\0';
+  } else if (!realpath(argv0, path)) {
+    return "lib/eosio-aot";
+  }
+  return Dirname(Dirname(path)) + "/lib/eosio-aot";
+}
+
+static std::string EnvironmentOr(const char* name, const char* fallback) {
+  const char* value = getenv(name);
+  return value && *value ? value : fallback;
+}
+
+static bool IsValidName(const std::string& name) {
+  return !name.empty() && name.size() <= 13 &&
+         name.find_first_not_of(".12345abcdefghijklmnopqrstuvwxyz") ==
+             std::string::npos;
+}
+
+static bool ParseDeploy(const std::string& argument, Contract* out) {
+  size_t colon = argument.find(':');
+  if (colon == std::string::npos || !IsValidName(argument.substr(0, colon))) {
+    return false;
+  }
+  out->account = argument.substr(0, colon);
+  out->filename = argument.substr(colon + 1);
+  return true;
+}
+
+int ProgramMain(int argc, char** argv) {
+  InitStdio();
+
+  ParseOptions(argc, argv);
+
+  if (!s_account.empty() && !IsValidName(s_account)) {
+    fprintf(stderr, "invalid account name %s\n", s_account.c_str());
+    return 1;
+  }
+
+  std::vector<Contract> contracts(1);
+  contracts[0].account = s_account;
+  contracts[0].filename = s_infile;
+  for (const std::string& deploy : s_deploy) {
+    Contract contract;
+    if (!ParseDeploy(deploy, &contract)) {
+      fprintf(stderr, "invalid deployment %s, expected ACCOUNT:FILENAME\n",
+              deploy.c_str());
+      return 1;
+    }
+    contracts.push_back(contract);
+  }
+  for (size_t i = 0; i < contracts.size(); ++i) {
+    contracts[i].prefix = "eosio_aot_c" + std::to_string(i) + "_";
+  }
+
+  if (s_outfile.empty()) {
+    s_outfile = s_infile.substr(0, s_infile.rfind(".wasm"));
+    if (s_outfile == s_infile || s_shared) {
+      s_outfile += s_shared ? ".so" : ".out";
+    }
+  }
+  if (s_runtime_dir.empty()) {
+    s_runtime_dir = DefaultRuntimeDir(argv[0]);
+  }
+  std::string runtime_library = s_runtime_dir + "/libeosio-aot-rt.a";
+  if (access(runtime_library.c_str(), R_OK) != 0) {
+    fprintf(stderr, "eosio-aot runtime not found in %s, use --runtime\n",
+            s_runtime_dir.c_str());
+    return 1;
+  }
+
+  bool keep_sources = !s_c_dir.empty();
+  std::string dir = s_c_dir;
+  if (keep_sources) {
+    if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+      fprintf(stderr, "unable to create directory %s\n", dir.c_str());
+      return 1;
+    }
+  } else {
+    std::string templ = EnvironmentOr("TMPDIR", "/tmp") + "/eosio-aot-XXXXXX";
+    std::vector<char> buffer(templ.begin(), templ.end());
+    buffer.push_back('\0');
+    if (!mkdtemp(buffer.data())) {
+      fprintf(stderr, "unable to create a temporary directory\n");
+      return 1;
+    }
+    dir = buffer.data();
+  }
+
+  std::vector<std::string> files;
+  auto add_file = [&](const std::string& name) {
+    files.push_back(dir + "/" + name);
+    return files.back();
+  };
+
+  std::string cc = s_cc.empty() ? EnvironmentOr("CC", "cc") : s_cc;
+  std::string cxx = s_cxx.empty() ? EnvironmentOr("CXX", "c++") : s_cxx;
+  // Mirror the maximum call depth of the chain.
+  std::string cflags = "-O" + s_opt_level + (s_shared ? " -fPIC" : "") +
+                       " -DWASM_RT_MAX_CALL_STACK_DEPTH=250 -I" +
+                       ShellQuote(s_runtime_dir);
+  std::string link = ShellQuote(cxx) + (s_shared ? " -shared" : "");
+
+  Result result = Result::Ok;
+  std::map<std::string, ImportedFunc> imports;
+  for (size_t i = 0; i < contracts.size() && Succeeded(result); ++i) {
+    std::string base = "contract" + std::to_string(i);
+    std::string c_file = add_file(base + ".c");
+    std::string h_file = add_file(base + ".h");
+    std::string o_file = add_file(base + ".o");
+    result = TranslateContract(&contracts[i], c_file, h_file, &imports);
+    if (Succeeded(result)) {
+      result = RunCommand(ShellQuote(cc) + " " + cflags +
+                          " -DWASM_RT_MODULE_PREFIX=" + contracts[i].prefix +
+                          " -c " + ShellQuote(c_file) + " -o " +
+                          ShellQuote(o_file));
+    }
+    link += " " + ShellQuote(o_file);
+  }
+  if (Succeeded(result)) {
+    std::string c_file = add_file("eosio-aot-main.c");
+    std::string o_file = add_file("eosio-aot-main.o");
+    result = WriteGlue(c_file, contracts, imports);
+    if (Succeeded(result)) {
+      result = RunCommand(ShellQuote(cc) + " " + cflags + " -c " +
+                          ShellQuote(c_file) + " -o " + ShellQuote(o_file));
+    }
+    link += " " + ShellQuote(o_file);
+  }
+  if (Succeeded(result)) {
+    std::string o_file = add_file("wasm-rt-impl.o");
+    result = RunCommand(ShellQuote(cc) + " " + cflags + " -c " +
+                        ShellQuote(s_runtime_dir + "/wasm-rt-impl.c") +
+                        " -o " + ShellQuote(o_file));
+    link += " " + ShellQuote(o_file);
+  }
+  if (Succeeded(result)) {
+    result = RunCommand(link + " " + ShellQuote(runtime_library) +
+                        " -lm -o " + ShellQuote(s_outfile));
+  }
+
+  if (!keep_sources) {
+    for (const std::string& file : files) {
+      remove(file.c_str());
+    }
+    rmdir(dir.c_str());
+  }
+  return result != Result::Ok;
+}
+
+int main(int argc, char** argv) {
+  WABT_TRY
+  return ProgramMain(argc, argv);
+  WABT_CATCH_BAD_ALLOC_AND_EXIT
+}
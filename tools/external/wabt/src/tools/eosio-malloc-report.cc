@@ -0,0 +1,272 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif
+
+#include "src/option-parser.h"
+
+using namespace wabt;
+
+static std::string s_infile;
+static size_t s_rows = 20;
+static bool s_demangle = true;
+
+static const char s_description[] =
+R"(  Read the allocations traced by a contract linked with -fmalloc-trace, written by
+  eosio-run --malloc-trace or, in native mode, to the file named by EOSIO_MALLOC_TRACE, and
+  report for every action:
+
+    - the calls to malloc (and calloc), free and realloc, and the bytes allocated,
+    - the peak of the bytes allocated and not yet freed, and the bytes never freed,
+    - the span of the heap the allocations were placed in, and how much of it was not
+      live at the peak (the fragmentation, or the memory an allocator that never frees
+      leaves behind),
+    - the pages the memory grew by.
+
+  followed by the functions allocating the most bytes over all the actions. The actions run
+  on fresh instances of the contracts; a native trace is reported as a single run.
+
+  $ eosio-run hello.wasm actions.json --malloc-trace hello.trace
+  $ eosio-malloc-report hello.trace
+)";
+
+static void ParseOptions(int argc, char** argv) {
+  OptionParser parser("eosio-malloc-report", s_description);
+
+  parser.AddHelpOption();
+  parser.AddOption('n', "rows", "COUNT",
+                   "Report the COUNT functions allocating the most bytes, 20 "
+                   "by default, or all of them if 0",
+                   [](const std::string& argument) {
+                     s_rows = strtoul(argument.c_str(), nullptr, 10);
+                   });
+  parser.AddOption('m', "mangled", "Do not demangle the function names",
+                   []() { s_demangle = false; });
+  parser.AddArgument("filename", OptionParser::ArgumentCount::One,
+                     [](const char* argument) { s_infile = argument; });
+  parser.Parse(argc, argv);
+}
+
+static std::string Demangle(const std::string& name) {
+#if defined(__GNUC__)
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+  if (status == 0 && demangled) {
+    std::string result = demangled;
+    free(demangled);
+    return result;
+  }
+#endif
+  return name;
+}
+
+struct ActionStats {
+  explicit ActionStats(const std::string& name) : name(name) {}
+
+  void Malloc(uint64_t ptr, uint64_t size) {
+    mallocs++;
+    if (!ptr) {
+      failed++;
+      return;
+    }
+    allocated += size;
+    live += size;
+    peak_live = std::max(peak_live, live);
+    blocks[ptr] = size;
+    low = std::min(low, ptr);
+    high = std::max(high, ptr + size);
+  }
+
+  void Free(uint64_t ptr) {
+    auto found = blocks.find(ptr);
+    if (found == blocks.end()) {
+      return;
+    }
+    live -= found->second;
+    blocks.erase(found);
+  }
+
+  uint64_t span() const { return high > low ? high - low : 0; }
+
+  std::string name;
+  uint64_t mallocs = 0;
+  uint64_t frees = 0;
+  uint64_t reallocs = 0;
+  uint64_t failed = 0;
+  uint64_t allocated = 0;
+  uint64_t live = 0;
+  uint64_t peak_live = 0;
+  uint64_t low = UINT64_MAX;
+  uint64_t high = 0;
+  uint64_t pages_grown = 0;
+  // The live allocations, by address.
+  std::map<uint64_t, uint64_t> blocks;
+};
+
+struct SiteStats {
+  uint64_t count = 0;
+  uint64_t bytes = 0;
+};
+
+// Reads the trace, a line per event:
+//
+//   action RECEIVER CODE ACTION
+//   malloc PTR SIZE SITE
+//   free PTR SITE
+//   realloc OLD_PTR PTR SIZE SITE
+//   grow OLD_PAGES PAGES SITE
+//
+// SITE being the rest of the line: the function that called the allocator, or
+// its address in native mode.
+static bool ReadTrace(const std::string& filename,
+                      std::vector<ActionStats>* actions,
+                      std::map<std::string, SiteStats>* sites) {
+  std::ifstream file(filename);
+  if (!file) {
+    fprintf(stderr, "unable to read %s\n", filename.c_str());
+    return false;
+  }
+  std::string line;
+  size_t line_number = 0;
+  while (std::getline(file, line)) {
+    line_number++;
+    std::istringstream stream(line);
+    std::string event;
+    if (!(stream >> event)) {
+      continue;
+    }
+    if (event == "action") {
+      std::string receiver, code, action;
+      stream >> receiver >> code >> action;
+      actions->emplace_back(receiver + " <= " + code + "::" + action);
+      continue;
+    }
+    if (actions->empty()) {
+      actions->emplace_back("(run)");
+    }
+    ActionStats& stats = actions->back();
+    uint64_t a = 0, b = 0, c = 0;
+    bool ok;
+    if (event == "malloc" || event == "grow") {
+      ok = static_cast<bool>(stream >> a >> b);
+    } else if (event == "free") {
+      ok = static_cast<bool>(stream >> a);
+    } else if (event == "realloc") {
+      ok = static_cast<bool>(stream >> a >> b >> c);
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      fprintf(stderr, "%s:%zu: invalid trace event\n", filename.c_str(),
+              line_number);
+      return false;
+    }
+    std::string site;
+    std::getline(stream >> std::ws, site);
+
+    if (event == "malloc") {
+      stats.Malloc(a, b);
+      (*sites)[site].count++;
+      (*sites)[site].bytes += b;
+    } else if (event == "free") {
+      stats.frees++;
+      stats.Free(a);
+    } else if (event == "realloc") {
+      // realloc(OLD_PTR, SIZE) returning PTR
+      stats.reallocs++;
+      stats.Free(a);
+      if (c) {
+        stats.Malloc(b, c);
+        stats.mallocs--;
+        (*sites)[site].count++;
+        (*sites)[site].bytes += c;
+      }
+    } else {
+      stats.pages_grown += b > a ? b - a : 0;
+    }
+  }
+  return true;
+}
+
+static void WriteReport(const std::vector<ActionStats>& actions,
+                        const std::map<std::string, SiteStats>& sites) {
+  printf("%-32s %8s %8s %8s %10s %10s %10s %10s %6s %6s\n", "action", "mallocs",
+         "frees", "reallocs", "allocated", "peak live", "not freed", "span",
+         "frag", "pages");
+  for (const ActionStats& stats : actions) {
+    uint64_t span = stats.span();
+    double fragmentation = span ? 100.0 * (span - std::min(span, stats.peak_live)) / span : 0;
+    printf("%-32s %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %10" PRIu64
+           " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %5.1f%% %6" PRIu64 "\n",
+           stats.name.c_str(), stats.mallocs, stats.frees, stats.reallocs,
+           stats.allocated, stats.peak_live, stats.live, span, fragmentation,
+           stats.pages_grown);
+    if (stats.failed) {
+      printf("  %" PRIu64 " allocations failed\n", stats.failed);
+    }
+  }
+
+  std::vector<std::pair<std::string, SiteStats>> by_bytes(sites.begin(),
+                                                          sites.end());
+  std::sort(by_bytes.begin(), by_bytes.end(),
+            [](const std::pair<std::string, SiteStats>& a,
+               const std::pair<std::string, SiteStats>& b) {
+              if (a.second.bytes != b.second.bytes) {
+                return a.second.bytes > b.second.bytes;
+              }
+              return a.first < b.first;
+            });
+  if (s_rows && by_bytes.size() > s_rows) {
+    by_bytes.resize(s_rows);
+  }
+  printf("\n%10s %12s  %s\n", "calls", "bytes", "allocated by");
+  for (const auto& site : by_bytes) {
+    printf("%10" PRIu64 " %12" PRIu64 "  %s\n", site.second.count,
+           site.second.bytes,
+           s_demangle ? Demangle(site.first).c_str() : site.first.c_str());
+  }
+}
+
+int ProgramMain(int argc, char** argv) {
+  InitStdio();
+  ParseOptions(argc, argv);
+
+  std::vector<ActionStats> actions;
+  std::map<std::string, SiteStats> sites;
+  if (!ReadTrace(s_infile, &actions, &sites)) {
+    return 1;
+  }
+  WriteReport(actions, sites);
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  WABT_TRY
+  return ProgramMain(argc, argv);
+  WABT_CATCH_BAD_ALLOC_AND_EXIT
+}
@@ -0,0 +1,582 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/binary-reader-interp.h"
+#include "src/binary-reader-ir.h"
+#include "src/binary-reader.h"
+#include "src/cast.h"
+#include "src/eosio-host.h"
+#include "src/error-handler.h"
+#include "src/feature.h"
+#include "src/generate-names.h"
+#include "src/interp-profiler.h"
+#include "src/interp.h"
+#include "src/ir.h"
+#include "src/option-parser.h"
+#include "src/stream.h"
+
+using namespace wabt;
+using namespace wabt::interp;
+
+static int s_verbose;
+static std::string s_infile;
+static std::string s_actions_file;
+static std::string s_account;
+static std::vector<std::string> s_deploy;
+static uint64_t s_max_instructions;
+static std::string s_profile_file;
+static std::string s_malloc_trace_file;
+static Features s_features;
+static Thread::Options s_thread_options;
+static std::unique_ptr<FileStream> s_log_stream;
+
+static const char s_description[] =
+R"(  Run a contract in the WebAssembly binary format locally against emulated EOSIO intrinsics
+  (an in-memory table store, action data, authorization, console capture and hashing), and
+  report the console output, execution time and interpreter instruction count of every action.
+
+  The actions file holds a JSON array of actions, their data being the hex encoded binary
+  serialization of the action arguments:
+
+    [ { "account": "hello", "name": "hi",
+        "authorization": [ { "actor": "alice", "permission": "active" } ],
+        "data": "0000000000855c34" } ]
+
+  Every action of the array runs as its own transaction, whose table changes are rolled back
+  if it fails. Notifications and inline actions run on the contracts deployed for the run;
+  intrinsics that cannot be emulated (key recovery, privileged and transaction intrinsics)
+  fail the action that calls them.
+
+  $ eosio-run hello.wasm actions.json
+
+  # deploy hello.wasm on the account hello and token.wasm on the account eosio.token
+  $ eosio-run hello.wasm actions.json --account hello --deploy eosio.token:token.wasm
+
+  With --profile, the instructions executed under every call stack are written in the
+  collapsed format of flamegraph.pl, and the calls, exclusive and inclusive instruction
+  counts and host calls of every function are reported after the actions. Functions are
+  named after the name section of the contracts (pipe the output through c++filt to
+  demangle them):
+
+  $ eosio-run hello.wasm actions.json --profile hello.stacks
+  $ flamegraph.pl hello.stacks > hello.svg
+
+  Contracts linked with -fmalloc-trace report their allocations through the trace_alloc
+  intrinsic; with --malloc-trace they are written to a file, each attributed to the function
+  that called the allocator, for eosio-malloc-report:
+
+  $ eosio-run hello.wasm actions.json --malloc-trace hello.trace
+  $ eosio-malloc-report hello.trace
+)";
+
+static void ParseOptions(int argc, char** argv) {
+  OptionParser parser("eosio-run", s_description);
+
+  parser.AddOption('v', "verbose", "Use multiple times for more info", []() {
+    s_verbose++;
+    s_log_stream = FileStream::CreateStdout();
+  });
+  parser.AddHelpOption();
+  s_features.AddOptions(&parser);
+  parser.AddOption('a', "account", "ACCOUNT",
+                   "Account the contract is deployed on, defaults to the "
+                   "account of the first action",
+                   [](const std::string& argument) { s_account = argument; });
+  parser.AddOption('d', "deploy", "ACCOUNT:FILENAME",
+                   "Also deploy the contract FILENAME on ACCOUNT, to handle "
+                   "notifications and inline actions",
+                   [](const std::string& argument) {
+                     s_deploy.push_back(argument);
+                   });
+  parser.AddOption('l', "max-instructions", "COUNT",
+                   "Fail actions executing more than COUNT instructions",
+                   [](const std::string& argument) {
+                     s_max_instructions = strtoull(argument.c_str(), nullptr, 10);
+                   });
+  parser.AddOption('p', "profile", "FILENAME",
+                   "Profile the actions, writing the collapsed call stacks "
+                   "to FILENAME",
+                   [](const std::string& argument) {
+                     s_profile_file = argument;
+                   });
+  parser.AddOption('t', "malloc-trace", "FILENAME",
+                   "Write the allocations of the contracts linked with "
+                   "-fmalloc-trace to FILENAME",
+                   [](const std::string& argument) {
+                     s_malloc_trace_file = argument;
+                   });
+  parser.AddOption('V', "value-stack-size", "SIZE",
+                   "Size in elements of the value stack",
+                   [](const std::string& argument) {
+                     s_thread_options.value_stack_size = atoi(argument.c_str());
+                   });
+  parser.AddOption('C', "call-stack-size", "SIZE",
+                   "Size in elements of the call stack",
+                   [](const std::string& argument) {
+                     s_thread_options.call_stack_size = atoi(argument.c_str());
+                   });
+  parser.AddArgument("filename", OptionParser::ArgumentCount::One,
+                     [](const char* argument) { s_infile = argument; });
+  parser.AddArgument("actions", OptionParser::ArgumentCount::One,
+                     [](const char* argument) { s_actions_file = argument; });
+  parser.Parse(argc, argv);
+}
+
+
+/*
+ * Interpreter engine
+ */
+
+// Runs a contract on the interpreter. All the contracts share the environment
+// and the thread of the run; every action starts from the memory and globals
+// the contract had once loaded.
+class InterpEngine : public eosio::Engine {
+ public:
+  InterpEngine(Environment* env,
+               Thread* thread,
+               Profiler* profiler,
+               IstreamOffset apply_offset,
+               Index memory_index,
+               Index first_global)
+      : env_(env),
+        thread_(thread),
+        profiler_(profiler),
+        apply_offset_(apply_offset),
+        memory_index_(memory_index),
+        initial_page_limits_(memory()->page_limits),
+        initial_memory_(memory()->data),
+        first_global_(first_global) {
+    for (Index i = first_global; i < env->GetGlobalCount(); ++i) {
+      initial_globals_.push_back(env->GetGlobal(i)->typed_value);
+    }
+  }
+
+  uint8_t* memory_data() override {
+    return reinterpret_cast<uint8_t*>(memory()->data.data());
+  }
+
+  uint64_t memory_size() override { return memory()->data.size(); }
+
+  bool counts_instructions() const override { return true; }
+
+  std::string GetCaller(unsigned depth) override;
+
+  // Names the functions of the contract, by the offset of their code.
+  void set_funcs(std::vector<std::pair<IstreamOffset, std::string>> funcs) {
+    funcs_ = std::move(funcs);
+    std::sort(funcs_.begin(), funcs_.end());
+  }
+
+  bool Apply(uint64_t receiver,
+             uint64_t code,
+             uint64_t action,
+             std::string* trap,
+             uint64_t* instructions) override;
+
+ private:
+  // Looked up on every use, as loading other contracts may move it.
+  interp::Memory* memory() { return env_->GetMemory(memory_index_); }
+
+  Environment* env_;
+  Thread* thread_;
+  Profiler* profiler_;
+  IstreamOffset apply_offset_;
+  Index memory_index_;
+  Limits initial_page_limits_;
+  std::vector<char> initial_memory_;
+  Index first_global_;
+  std::vector<TypedValue> initial_globals_;
+  std::vector<std::pair<IstreamOffset, std::string>> funcs_;
+};
+
+std::string InterpEngine::GetCaller(unsigned depth) {
+  if (depth == 0 || depth > thread_->call_stack_depth()) {
+    return std::string();
+  }
+  // The call returns right after the call instruction, within the caller.
+  IstreamOffset offset = thread_->call_stack_at(depth - 1) - 1;
+  auto found = std::upper_bound(
+      funcs_.begin(), funcs_.end(), offset,
+      [](IstreamOffset offset,
+         const std::pair<IstreamOffset, std::string>& func) {
+        return offset < func.first;
+      });
+  if (found == funcs_.begin()) {
+    return std::string();
+  }
+  return std::prev(found)->second;
+}
+
+bool InterpEngine::Apply(uint64_t receiver,
+                         uint64_t code,
+                         uint64_t action,
+                         std::string* trap,
+                         uint64_t* instructions) {
+  memory()->page_limits = initial_page_limits_;
+  memory()->data = initial_memory_;
+  for (size_t i = 0; i < initial_globals_.size(); ++i) {
+    env_->GetGlobal(first_global_ + i)->typed_value = initial_globals_[i];
+  }
+
+  interp::Result result = interp::Result::Ok;
+  thread_->Reset();
+  Value args[3];
+  args[0].i64 = receiver;
+  args[1].i64 = code;
+  args[2].i64 = action;
+  for (const Value& arg : args) {
+    if (result == interp::Result::Ok) {
+      result = thread_->Push(arg);
+    }
+  }
+
+  uint64_t count = 0;
+  if (result == interp::Result::Ok) {
+    thread_->set_pc(apply_offset_);
+    if (profiler_) {
+      profiler_->Enter(apply_offset_, thread_->instruction_count());
+    }
+    do {
+      result = thread_->Run(1);
+      ++count;
+    } while (result == interp::Result::Ok &&
+             (!s_max_instructions || count < s_max_instructions));
+  }
+  if (profiler_ && result != interp::Result::Returned) {
+    profiler_->Unwind(thread_->instruction_count());
+  }
+  thread_->Reset();
+
+  *instructions = count;
+  if (result == interp::Result::Returned) {
+    return true;
+  }
+  if (result == interp::Result::Ok) {
+    *trap = "exceeded the limit of " + std::to_string(s_max_instructions) +
+            " instructions";
+  } else {
+    *trap = ResultToString(result);
+  }
+  return false;
+}
+
+static std::string SignatureString(const interp::FuncSignature& sig) {
+  auto type_char = [](Type type) {
+    switch (type) {
+      case Type::I32: return 'i';
+      case Type::I64: return 'I';
+      case Type::F32: return 'f';
+      case Type::F64: return 'F';
+      default: return '?';
+    }
+  };
+  std::string str = "(";
+  for (Type type : sig.param_types) {
+    str += type_char(type);
+  }
+  str += ")";
+  for (Type type : sig.result_types) {
+    str += type_char(type);
+  }
+  return str;
+}
+
+struct ImportBinding {
+  eosio::Host* host;
+  int index;
+};
+
+static interp::Result CallIntrinsic(const HostFunc* func,
+                                    const interp::FuncSignature* sig,
+                                    Index num_args,
+                                    TypedValue* args,
+                                    Index num_results,
+                                    TypedValue* out_results,
+                                    void* user_data) {
+  const ImportBinding* binding = static_cast<const ImportBinding*>(user_data);
+  // Intrinsics take at most 7 arguments; the signature was checked on binding.
+  eosio::HostValue values[8];
+  eosio::HostValue result;
+  for (Index i = 0; i < num_args && i < WABT_ARRAY_SIZE(values); ++i) {
+    memcpy(&values[i], &args[i].value, sizeof(values[i]));
+  }
+  result.i64 = 0;
+  eosio::HostStatus status =
+      binding->host->Call(binding->index, values, &result);
+  for (Index i = 0; i < num_results; ++i) {
+    out_results[i].type = sig->result_types[i];
+    memcpy(&out_results[i].value, &result, sizeof(result));
+  }
+  return status == eosio::HostStatus::Ok ? interp::Result::Ok
+                                         : interp::Result::TrapHostTrapped;
+}
+
+// Binds every function imported from "env" to its emulation, or to a stub
+// failing the action that calls an intrinsic which cannot be emulated.
+class EosioRunHostImportDelegate : public HostImportDelegate {
+ public:
+  explicit EosioRunHostImportDelegate(eosio::Host* host) : host_(host) {}
+
+  wabt::Result ImportFunc(interp::FuncImport* import,
+                          interp::Func* func,
+                          interp::FuncSignature* func_sig,
+                          const ErrorCallback& callback) override {
+    std::string name = import->field_name;
+    std::string signature = SignatureString(*func_sig);
+    std::string error;
+    int index = host_->Bind(name, signature, &error);
+    if (index < 0) {
+      callback(error.c_str());
+      return wabt::Result::Error;
+    }
+    if (s_verbose) {
+      s_log_stream->Writef("%s env.%s%s\n",
+                           host_->IsSupported(index) ? "bound" : "unsupported",
+                           name.c_str(), signature.c_str());
+    }
+    bindings_.emplace_back(new ImportBinding{host_, index});
+    HostFunc* host_func = cast<HostFunc>(func);
+    host_func->callback = CallIntrinsic;
+    host_func->user_data = bindings_.back().get();
+    return wabt::Result::Ok;
+  }
+
+  wabt::Result ImportTable(interp::TableImport* import,
+                           interp::Table* table,
+                           const ErrorCallback& callback) override {
+    callback("tables cannot be imported by contracts");
+    return wabt::Result::Error;
+  }
+
+  wabt::Result ImportMemory(interp::MemoryImport* import,
+                            interp::Memory* memory,
+                            const ErrorCallback& callback) override {
+    callback("memories cannot be imported by contracts");
+    return wabt::Result::Error;
+  }
+
+  wabt::Result ImportGlobal(interp::GlobalImport* import,
+                            interp::Global* global,
+                            const ErrorCallback& callback) override {
+    callback("globals cannot be imported by contracts");
+    return wabt::Result::Error;
+  }
+
+ private:
+  eosio::Host* host_;
+  std::vector<std::unique_ptr<ImportBinding>> bindings_;
+};
+
+// Names the functions of a contract after its name section, generating names
+// for the functions it does not name.
+static wabt::Result ReadFuncNames(const std::string& filename,
+                                  const std::vector<uint8_t>& file_data,
+                                  std::vector<std::string>* out) {
+  const bool kReadDebugNames = true;
+  const bool kStopOnFirstError = true;
+  const bool kFailOnCustomSectionError = false;
+  ReadBinaryOptions options(s_features, nullptr, kReadDebugNames,
+                            kStopOnFirstError, kFailOnCustomSectionError);
+  ErrorHandlerFile error_handler(Location::Type::Binary);
+  wabt::Module module;
+  CHECK_RESULT(ReadBinaryIr(filename.c_str(), file_data.data(),
+                            file_data.size(), &options, &error_handler,
+                            &module));
+  CHECK_RESULT(GenerateNames(&module));
+  for (const wabt::Func* func : module.funcs) {
+    string_view name = func->name;
+    if (!name.empty() && name[0] == '$') {
+      name.remove_prefix(1);
+    }
+    out->push_back(name.to_string());
+  }
+  return wabt::Result::Ok;
+}
+
+static wabt::Result LoadContract(Environment* env,
+                                 Thread* thread,
+                                 Profiler* profiler,
+                                 uint64_t account,
+                                 const std::string& filename,
+                                 std::unique_ptr<eosio::Engine>* out) {
+  std::vector<uint8_t> file_data;
+  if (Failed(ReadFile(filename.c_str(), &file_data))) {
+    return wabt::Result::Error;
+  }
+
+  const bool kReadDebugNames = true;
+  const bool kStopOnFirstError = true;
+  const bool kFailOnCustomSectionError = true;
+  ReadBinaryOptions options(s_features, s_log_stream.get(), kReadDebugNames,
+                            kStopOnFirstError, kFailOnCustomSectionError);
+  ErrorHandlerFile error_handler(Location::Type::Binary);
+  Index first_global = env->GetGlobalCount();
+  Index first_func = env->GetFuncCount();
+  DefinedModule* module = nullptr;
+  CHECK_RESULT(ReadBinaryInterp(env, file_data.data(), file_data.size(),
+                                &options, &error_handler, &module));
+
+  interp::Export* apply = module->GetExport("apply");
+  interp::Func* func = apply && apply->kind == ExternalKind::Func
+                   ? env->GetFunc(apply->index)
+                   : nullptr;
+  if (!func || func->is_host ||
+      SignatureString(*env->GetFuncSignature(func->sig_index)) != "(III)") {
+    fprintf(stderr, "%s: no exported apply(i64, i64, i64) function\n",
+            filename.c_str());
+    return wabt::Result::Error;
+  }
+  if (module->memory_index == kInvalidIndex) {
+    fprintf(stderr, "%s: no memory defined\n", filename.c_str());
+    return wabt::Result::Error;
+  }
+  if (module->start_func_index != kInvalidIndex) {
+    fprintf(stderr, "%s: contracts cannot have a start function\n",
+            filename.c_str());
+    return wabt::Result::Error;
+  }
+
+  std::vector<std::string> names;
+  if (profiler || !s_malloc_trace_file.empty()) {
+    CHECK_RESULT(ReadFuncNames(filename, file_data, &names));
+  }
+  if (profiler) {
+    profiler->AddModule(eosio::NameToString(account), first_func, names);
+  }
+
+  InterpEngine* engine = new InterpEngine(env, thread, profiler,
+                                          cast<DefinedFunc>(func)->offset,
+                                          module->memory_index, first_global);
+  out->reset(engine);
+  std::vector<std::pair<IstreamOffset, std::string>> funcs;
+  for (Index i = 0; i < names.size() && first_func + i < env->GetFuncCount();
+       ++i) {
+    if (auto* defined = dyn_cast<DefinedFunc>(env->GetFunc(first_func + i))) {
+      funcs.emplace_back(defined->offset, names[i]);
+    }
+  }
+  engine->set_funcs(std::move(funcs));
+  return wabt::Result::Ok;
+}
+
+static bool ParseDeploy(const std::string& argument,
+                        uint64_t* account,
+                        std::string* filename) {
+  size_t colon = argument.find(':');
+  if (colon == std::string::npos ||
+      !eosio::StringToName(argument.substr(0, colon), account)) {
+    return false;
+  }
+  *filename = argument.substr(colon + 1);
+  return true;
+}
+
+int ProgramMain(int argc, char** argv) {
+  InitStdio();
+
+  ParseOptions(argc, argv);
+
+  std::vector<eosio::Action> actions;
+  if (!eosio::ReadActions(s_actions_file, &actions)) {
+    return 1;
+  }
+
+  uint64_t account = 0;
+  if (!s_account.empty()) {
+    if (!eosio::StringToName(s_account, &account)) {
+      fprintf(stderr, "invalid account name %s\n", s_account.c_str());
+      return 1;
+    }
+  } else if (!actions.empty()) {
+    account = actions[0].account;
+  }
+
+  std::vector<std::pair<uint64_t, std::string>> contracts = {
+      {account, s_infile}};
+  for (const std::string& deploy : s_deploy) {
+    uint64_t deploy_account;
+    std::string filename;
+    if (!ParseDeploy(deploy, &deploy_account, &filename)) {
+      fprintf(stderr, "invalid deployment %s, expected ACCOUNT:FILENAME\n",
+              deploy.c_str());
+      return 1;
+    }
+    contracts.emplace_back(deploy_account, filename);
+  }
+
+  eosio::Host host;
+  Environment env;
+  Thread thread(&env, s_thread_options);
+  std::unique_ptr<Profiler> profiler;
+  if (!s_profile_file.empty()) {
+    profiler.reset(new Profiler(&env));
+    thread.set_profiler(profiler.get());
+  }
+  HostModule* host_module = env.AppendHostModule("env");
+  host_module->import_delegate.reset(new EosioRunHostImportDelegate(&host));
+  for (const auto& contract : contracts) {
+    std::unique_ptr<eosio::Engine> engine;
+    if (Failed(LoadContract(&env, &thread, profiler.get(), contract.first,
+                            contract.second, &engine))) {
+      return 1;
+    }
+    host.Deploy(contract.first, std::move(engine));
+  }
+
+  FILE* malloc_trace = nullptr;
+  if (!s_malloc_trace_file.empty()) {
+    malloc_trace = fopen(s_malloc_trace_file.c_str(), "w");
+    if (!malloc_trace) {
+      fprintf(stderr, "unable to write %s\n", s_malloc_trace_file.c_str());
+      return 1;
+    }
+    host.TraceAllocations(malloc_trace);
+  }
+
+  int result = eosio::RunTransactions(&host, actions);
+  if (malloc_trace) {
+    fclose(malloc_trace);
+  }
+
+  if (profiler) {
+    FileStream stacks(s_profile_file);
+    if (!stacks.is_open()) {
+      fprintf(stderr, "unable to write %s\n", s_profile_file.c_str());
+      return 1;
+    }
+    profiler->WriteCollapsedStacks(&stacks);
+    printf("\nprofile\n");
+    FileStream report(stdout);
+    profiler->WriteReport(&report);
+  }
+  return result;
+}
+
+int main(int argc, char** argv) {
+  WABT_TRY
+  return ProgramMain(argc, argv);
+  WABT_CATCH_BAD_ALLOC_AND_EXIT
+}
@@ -0,0 +1,498 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif
+
+#include "src/binary-reader-nop.h"
+#include "src/binary-reader.h"
+#include "src/binary.h"
+#include "src/feature.h"
+#include "src/leb128.h"
+#include "src/option-parser.h"
+#include "src/stream.h"
+
+using namespace wabt;
+
+enum class GroupBy {
+  Sections,
+  Symbols,
+  Templates,
+  Namespaces,
+};
+
+static int s_verbose;
+static std::string s_infile;
+static std::string s_base_file;
+static GroupBy s_group_by = GroupBy::Symbols;
+static size_t s_rows = 20;
+static bool s_demangle = true;
+static Features s_features;
+static std::unique_ptr<FileStream> s_log_stream;
+
+static const char s_description[] =
+R"(  Read a contract in the WebAssembly binary format and report what its bytes are spent on:
+  the size of every function body, data segment and section, the functions being named after
+  the name section (the contract must be linked without stripping it). Every byte of the file
+  is attributed to exactly one row; the bytes of a section not attributed to its functions or
+  segments are reported as the section itself.
+
+  Rows are grouped by symbol (a function or a data segment), by template (every
+  instantiation of a template function or of the members of a class template together), by
+  namespace (the outermost scope of the demangled names) or by section. The debug information
+  emitted with -g is reported as its .debug_* sections.
+
+  With --diff, the sizes are compared to another build of the contract, reporting the rows
+  that grew or shrank.
+
+  $ eosio-size hello.wasm
+  $ eosio-size hello.wasm --group-by templates -n 0
+  $ eosio-size hello.wasm --diff hello.old.wasm
+)";
+
+static void ParseOptions(int argc, char** argv) {
+  OptionParser parser("eosio-size", s_description);
+
+  parser.AddOption('v', "verbose", "Use multiple times for more info", []() {
+    s_verbose++;
+    s_log_stream = FileStream::CreateStdout();
+  });
+  parser.AddHelpOption();
+  s_features.AddOptions(&parser);
+  parser.AddOption(
+      'g', "group-by", "KIND",
+      "Group the rows by symbols (the default), templates, namespaces or "
+      "sections",
+      [](const std::string& argument) {
+        if (argument == "sections") {
+          s_group_by = GroupBy::Sections;
+        } else if (argument == "symbols") {
+          s_group_by = GroupBy::Symbols;
+        } else if (argument == "templates") {
+          s_group_by = GroupBy::Templates;
+        } else if (argument == "namespaces") {
+          s_group_by = GroupBy::Namespaces;
+        } else {
+          fprintf(stderr, "unknown grouping %s\n", argument.c_str());
+          exit(1);
+        }
+      });
+  parser.AddOption('n', "rows", "COUNT",
+                   "Report the COUNT largest rows, 20 by default, or all of "
+                   "them if 0",
+                   [](const std::string& argument) {
+                     s_rows = strtoul(argument.c_str(), nullptr, 10);
+                   });
+  parser.AddOption('m', "mangled", "Do not demangle the function names",
+                   []() { s_demangle = false; });
+  parser.AddOption('d', "diff", "FILENAME",
+                   "Compare the sizes to the contract FILENAME",
+                   [](const std::string& argument) {
+                     s_base_file = argument;
+                   });
+  parser.AddArgument("filename", OptionParser::ArgumentCount::One,
+                     [](const char* argument) { s_infile = argument; });
+  parser.Parse(argc, argv);
+}
+
+// Only mangled function names are demangled: __cxa_demangle also accepts
+// type encodings, and would turn a C function named `f` into `float`.
+static std::string Demangle(const std::string& name) {
+#if defined(__GNUC__)
+  if (name.compare(0, 2, "_Z") != 0) {
+    return name;
+  }
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+  if (status == 0 && demangled) {
+    std::string result = demangled;
+    free(demangled);
+    return result;
+  }
+#endif
+  return name;
+}
+
+// Strips the return type and the parameters from a demangled function name,
+// and with `strip_templates` the arguments of its templates:
+//
+//   void eosio::multi_index<...>::emplace<...>(unsigned long long, ...)
+//
+// becomes eosio::multi_index<>::emplace<>.
+static std::string QualifiedName(const std::string& name,
+                                 bool strip_templates) {
+  static const char kOperator[] = "operator";
+  static const char kAnonymous[] = "(anonymous namespace)";
+  const size_t operator_length = sizeof(kOperator) - 1;
+  const size_t anonymous_length = sizeof(kAnonymous) - 1;
+
+  std::string result;
+  int angles = 0;
+  int nesting = 0;  // Parentheses, brackets and braces.
+  for (size_t i = 0; i < name.size(); ++i) {
+    char c = name[i];
+    if (nesting == 0 && name.compare(i, operator_length, kOperator) == 0 &&
+        (i == 0 || name[i - 1] == ':' || name[i - 1] == ' ')) {
+      // The name of the operator runs up to its parameters.
+      size_t end = i + operator_length;
+      if (name.compare(end, 2, "()") == 0) {
+        end += 2;
+      }
+      end = std::min(name.find('(', end), name.size());
+      if (angles == 0 || !strip_templates) {
+        result.append(name, i, end - i);
+      }
+      i = end - 1;
+      continue;
+    }
+    if (nesting == 0 && angles == 0 &&
+        name.compare(i, anonymous_length, kAnonymous) == 0) {
+      result.append(kAnonymous);
+      i += anonymous_length - 1;
+      continue;
+    }
+    switch (c) {
+      case '<':
+        if (nesting == 0 && angles++ > 0 && strip_templates) {
+          continue;
+        }
+        break;
+      case '>':
+        if (nesting == 0 && --angles > 0 && strip_templates) {
+          continue;
+        }
+        break;
+      case '(':
+        if (nesting == 0 && angles == 0) {
+          // The parameters of the function.
+          return result;
+        }
+        nesting++;
+        break;
+      case '[':
+      case '{':
+        nesting++;
+        break;
+      case ')':
+      case ']':
+      case '}':
+        nesting--;
+        break;
+      case ' ':
+        if (nesting == 0 && angles == 0) {
+          // What came before is the return type.
+          result.clear();
+          continue;
+        }
+        break;
+    }
+    if (angles == 0 || c == '<' || !strip_templates) {
+      result += c;
+    }
+  }
+  return result;
+}
+
+// The outermost scope of a qualified name.
+static std::string Namespace(const std::string& qualified_name) {
+  int angles = 0;
+  for (size_t i = 0; i + 1 < qualified_name.size(); ++i) {
+    char c = qualified_name[i];
+    if (c == '<') {
+      angles++;
+    } else if (c == '>') {
+      angles--;
+    } else if (angles == 0 && c == ':' && qualified_name[i + 1] == ':') {
+      return qualified_name.substr(0, i);
+    }
+  }
+  return "(global)";
+}
+
+struct Symbol {
+  std::string name;
+  Offset size;
+};
+
+struct SizeInfo {
+  Offset file_size = 0;
+  std::vector<Symbol> sections;
+  std::map<Index, Symbol> funcs;
+  std::vector<Symbol> data_segments;
+  // Bytes of every section (by its index in `sections`) attributed to its
+  // functions or data segments.
+  std::map<Index, Offset> attributed;
+};
+
+class BinaryReaderSize : public BinaryReaderNop {
+ public:
+  explicit BinaryReaderSize(SizeInfo* info) : info_(info) {}
+
+  Result BeginModule(uint32_t version) override {
+    info_->sections.push_back({"[wasm header]", state->offset});
+    return Result::Ok;
+  }
+
+  Result BeginSection(BinarySection section_type, Offset size) override {
+    Offset header_size = 1 + U32Leb128Length(size);
+    info_->sections.push_back(
+        {std::string("[section ") + GetSectionName(section_type) + "]",
+         header_size + size});
+    return Result::Ok;
+  }
+
+  Result BeginCustomSection(Offset size, string_view section_name) override {
+    info_->sections.back().name =
+        "[section " + section_name.to_string() + "]";
+    return Result::Ok;
+  }
+
+  Result BeginFunctionBody(Index index) override {
+    start_ = state->offset;
+    return Result::Ok;
+  }
+
+  Result EndFunctionBody(Index index) override {
+    info_->funcs[index].size = state->offset - start_;
+    Attribute(state->offset - start_);
+    return Result::Ok;
+  }
+
+  Result BeginDataSegment(Index index, Index memory_index) override {
+    start_ = state->offset;
+    in_data_segment_ = true;
+    address_ = 0;
+    return Result::Ok;
+  }
+
+  Result OnInitExprI32ConstExpr(Index index, uint32_t value) override {
+    if (in_data_segment_) {
+      address_ = value;
+    }
+    return Result::Ok;
+  }
+
+  Result EndDataSegment(Index index) override {
+    char name[64];
+    snprintf(name, sizeof(name), "[data segment %u @ %u]", index, address_);
+    info_->data_segments.push_back({name, state->offset - start_});
+    Attribute(state->offset - start_);
+    in_data_segment_ = false;
+    return Result::Ok;
+  }
+
+  Result OnExport(Index index,
+                  ExternalKind kind,
+                  Index item_index,
+                  string_view name) override {
+    // Named after the name section instead when it has one.
+    if (kind == ExternalKind::Func && info_->funcs[item_index].name.empty()) {
+      info_->funcs[item_index].name = name.to_string();
+    }
+    return Result::Ok;
+  }
+
+  Result OnFunctionName(Index index, string_view name) override {
+    info_->funcs[index].name = name.to_string();
+    return Result::Ok;
+  }
+
+ private:
+  void Attribute(Offset size) {
+    info_->attributed[info_->sections.size() - 1] += size;
+  }
+
+  SizeInfo* info_;
+  Offset start_ = 0;
+  bool in_data_segment_ = false;
+  uint32_t address_ = 0;
+};
+
+static wabt::Result ReadSizeInfo(const std::string& filename, SizeInfo* out) {
+  std::vector<uint8_t> file_data;
+  CHECK_RESULT(ReadFile(filename.c_str(), &file_data));
+
+  const bool kReadDebugNames = true;
+  const bool kStopOnFirstError = true;
+  const bool kFailOnCustomSectionError = false;
+  ReadBinaryOptions options(s_features, s_log_stream.get(), kReadDebugNames,
+                            kStopOnFirstError, kFailOnCustomSectionError);
+  BinaryReaderSize reader(out);
+  out->file_size = file_data.size();
+  return ReadBinary(file_data.data(), file_data.size(), &reader, &options);
+}
+
+static std::string GroupName(const std::string& name) {
+  std::string demangled = s_demangle ? Demangle(name) : name;
+  switch (s_group_by) {
+    case GroupBy::Templates:
+      return QualifiedName(demangled, true);
+    case GroupBy::Namespaces:
+      return Namespace(QualifiedName(demangled, true));
+    default:
+      return demangled;
+  }
+}
+
+// Sums the sizes of the rows of the report.
+static std::map<std::string, Offset> GroupSizes(const SizeInfo& info) {
+  std::map<std::string, Offset> sizes;
+  for (Index i = 0; i < info.sections.size(); ++i) {
+    Offset size = info.sections[i].size;
+    if (s_group_by != GroupBy::Sections) {
+      auto attributed = info.attributed.find(i);
+      if (attributed != info.attributed.end()) {
+        size -= attributed->second;
+      }
+    }
+    if (size) {
+      sizes[info.sections[i].name] += size;
+    }
+  }
+  if (s_group_by == GroupBy::Sections) {
+    return sizes;
+  }
+  for (const auto& pair : info.funcs) {
+    if (!pair.second.size) {
+      continue;
+    }
+    if (pair.second.name.empty()) {
+      sizes["func[" + std::to_string(pair.first) + "]"] += pair.second.size;
+    } else {
+      sizes[GroupName(pair.second.name)] += pair.second.size;
+    }
+  }
+  for (const Symbol& segment : info.data_segments) {
+    if (s_group_by == GroupBy::Symbols) {
+      sizes[segment.name] += segment.size;
+    } else {
+      sizes["[data segments]"] += segment.size;
+    }
+  }
+  return sizes;
+}
+
+static void WriteSizes(const SizeInfo& info) {
+  std::map<std::string, Offset> sizes = GroupSizes(info);
+  std::vector<std::pair<std::string, Offset>> rows(sizes.begin(), sizes.end());
+  std::stable_sort(rows.begin(), rows.end(),
+                   [](const std::pair<std::string, Offset>& lhs,
+                      const std::pair<std::string, Offset>& rhs) {
+                     return lhs.second > rhs.second;
+                   });
+
+  double total = info.file_size;
+  printf("%10s %7s  %s\n", "size", "%", "name");
+  Offset others = 0;
+  for (size_t i = 0; i < rows.size(); ++i) {
+    if (s_rows && i >= s_rows) {
+      others += rows[i].second;
+      continue;
+    }
+    printf("%10" PRIzd " %6.2f%%  %s\n", rows[i].second,
+           100 * rows[i].second / total, rows[i].first.c_str());
+  }
+  if (others) {
+    printf("%10" PRIzd " %6.2f%%  [%" PRIzd " others]\n", others,
+           100 * others / total, rows.size() - s_rows);
+  }
+  printf("%10" PRIzd " %6.2f%%  total\n", info.file_size, 100.0);
+}
+
+static void WriteDiff(const SizeInfo& info, const SizeInfo& base) {
+  std::map<std::string, Offset> sizes = GroupSizes(info);
+  std::map<std::string, Offset> base_sizes = GroupSizes(base);
+  struct Row {
+    std::string name;
+    Offset size;
+    Offset base_size;
+    int64_t delta() const {
+      return static_cast<int64_t>(size) - static_cast<int64_t>(base_size);
+    }
+  };
+  std::vector<Row> rows;
+  for (const auto& pair : sizes) {
+    auto found = base_sizes.find(pair.first);
+    Offset base_size = found == base_sizes.end() ? 0 : found->second;
+    if (pair.second != base_size) {
+      rows.push_back({pair.first, pair.second, base_size});
+    }
+  }
+  for (const auto& pair : base_sizes) {
+    if (!sizes.count(pair.first)) {
+      rows.push_back({pair.first, 0, pair.second});
+    }
+  }
+  std::stable_sort(rows.begin(), rows.end(),
+                   [](const Row& lhs, const Row& rhs) {
+                     return std::abs(lhs.delta()) > std::abs(rhs.delta());
+                   });
+
+  printf("%10s %10s %10s  %s\n", "delta", "size", "base size", "name");
+  int64_t others = 0;
+  for (size_t i = 0; i < rows.size(); ++i) {
+    if (s_rows && i >= s_rows) {
+      others += rows[i].delta();
+      continue;
+    }
+    printf("%+10" PRId64 " %10" PRIzd " %10" PRIzd "  %s\n", rows[i].delta(),
+           rows[i].size, rows[i].base_size, rows[i].name.c_str());
+  }
+  if (s_rows && rows.size() > s_rows) {
+    printf("%+10" PRId64 " %10s %10s  [%" PRIzd " others]\n", others, "", "",
+           rows.size() - s_rows);
+  }
+  Row total{"total", info.file_size, base.file_size};
+  printf("%+10" PRId64 " %10" PRIzd " %10" PRIzd "  total\n", total.delta(),
+         total.size, total.base_size);
+}
+
+int ProgramMain(int argc, char** argv) {
+  InitStdio();
+
+  ParseOptions(argc, argv);
+
+  SizeInfo info;
+  if (Failed(ReadSizeInfo(s_infile, &info))) {
+    return 1;
+  }
+  if (s_base_file.empty()) {
+    WriteSizes(info);
+    return 0;
+  }
+
+  SizeInfo base;
+  if (Failed(ReadSizeInfo(s_base_file, &base))) {
+    return 1;
+  }
+  WriteDiff(info, base);
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  WABT_TRY
+  return ProgramMain(argc, argv);
+  WABT_CATCH_BAD_ALLOC_AND_EXIT
+}
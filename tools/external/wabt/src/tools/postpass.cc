@@ -14,15 +14,24 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cinttypes>
 #include <cstdio>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 #include "src/apply-names.h"
 #include "src/binary-reader.h"
+#include "src/binary-reader-nop.h"
 #include "src/binary-writer.h"
+#include "src/cast.h"
 #include "src/binary-reader-ir.h"
 #include "src/error-handler.h"
 #include "src/feature.h"
@@ -43,12 +52,31 @@ static std::string s_outfile;
 static Features s_features;
 static WriteBinaryOptions s_write_binary_options;
 static std::unique_ptr<FileStream> s_log_stream;
+static int s_opt_level = 0;
+static bool s_check_stack = false;
+static bool s_allow_unbounded_stack = false;
+static bool s_shrink_stack = false;
+static uint32_t s_stack_size = 0;
+// Dynamic stack allocations (alloca) are assumed to take at most this many
+// bytes, the size up to which the eosio library allocates buffers on the stack
+static uint32_t s_max_alloca = 512;
+// Function bodies are read by this many threads
+static unsigned s_jobs = std::max(1u, std::thread::hardware_concurrency());
 
 static const char s_description[] =
-R"(  Read a file in the WebAssembly binary format, strip bss or any data segment that is only initialized to zeros, and other post processing.
+R"(  Read a file in the WebAssembly binary format, strip bss and zero runs from the data segments,
+  drop static data nothing can address, merge nearby segments, replace the linear action and
+  notification name comparisons in apply with binary searches, and other post processing.
 
   $ eosio-pp test.wasm -o test.stripped.wasm
 
+  # also run the size optimizations and report what each pass saved
+  $ eosio-pp -v -O 2 test.wasm
+
+  # check that the deepest call chain fits in the 8KiB stack the contract was linked with, and
+  # with -fno-stack-first hand the stack it can not use over to the heap
+  $ eosio-pp --check-stack --shrink-stack -S 8192 test.wasm
+
   # or original replacement
   $ wasm2wat test.wasm 
 )";
@@ -61,6 +89,42 @@ static void ParseOptions(int argc, char** argv) {
     s_log_stream = FileStream::CreateStdout();
   });
   parser.AddHelpOption();
+  parser.AddOption(
+      'O', "opt-level", "LEVEL",
+      "0 (default) no optimizations, 1 remove dead and duplicate functions, 2 also coalesce locals and globals",
+      [](const char* argument) {
+        s_opt_level = atoi(argument);
+      });
+  parser.AddOption("check-stack",
+                   "Fail if the deepest call chain can overflow the stack",
+                   []() { s_check_stack = true; });
+  parser.AddOption("allow-unbounded-stack",
+                   "With --check-stack, accept a worst case made unbounded "
+                   "by recursion or stack allocations in loops",
+                   []() { s_allow_unbounded_stack = true; });
+  parser.AddOption("shrink-stack",
+                   "Shrink the stack to the deepest call chain, when the "
+                   "stack is not laid out first",
+                   []() { s_shrink_stack = true; });
+  parser.AddOption(
+      'S', "stack-size", "BYTES",
+      "Stack size the contract was linked with, needed to shrink it",
+      [](const char* argument) {
+        s_stack_size = strtoul(argument, nullptr, 10);
+      });
+  parser.AddOption(OptionParser::Option(
+      '\0', "max-alloca", "BYTES", OptionParser::HasArgument::Yes,
+      "Size assumed for dynamic stack allocations, 512 (the limit of the "
+      "eosio library) by default",
+      [](const char* argument) {
+        s_max_alloca = strtoul(argument, nullptr, 10);
+      }));
+  parser.AddOption(
+      'j', "jobs", "N",
+      "Number of threads reading the function bodies, one per core by default",
+      [](const char* argument) {
+        s_jobs = std::max(1, atoi(argument));
+      });
   parser.AddOption(
       'o', "output", "FILENAME",
       "Output file for the generated wast file, by default use stdout",
@@ -76,18 +140,23 @@ static void ParseOptions(int argc, char** argv) {
   parser.Parse(argc, argv);
 }
 
-uint32_t GetHeapPtr( Module& mod, const std::vector<uint8_t>& buff ) {
-   size_t offset = mod.GetGlobal(Var(1))->init_expr.begin()->loc.offset;
-   uint32_t heap_ptr;
-   ReadS32Leb128(buff.data()+offset+4, buff.data()+offset+9, &heap_ptr);
-   return heap_ptr;
+// The initializer of an i32 global, read from the module so the passes
+// below see each other's changes
+static ConstExpr* GetGlobalInit( Module& mod, Index index ) {
+   Global* global = mod.GetGlobal(Var(index));
+   if (!global || global->type != Type::I32 || global->init_expr.size() != 1)
+      return nullptr;
+   return dyn_cast<ConstExpr>(&global->init_expr.front());
 }
 
-uint32_t GetStackPtr( Module& mod, const std::vector<uint8_t>& buff ) {
-   size_t offset = mod.GetGlobal(Var(0))->init_expr.begin()->loc.offset;
-   uint32_t stack_ptr;
-   ReadS32Leb128(buff.data()+offset+4, buff.data()+offset+9, &stack_ptr);
-   return stack_ptr;
+uint32_t GetHeapPtr( Module& mod ) {
+   ConstExpr* init = GetGlobalInit(mod, 1);
+   return init ? init->const_.u32 : 0;
+}
+
+uint32_t GetStackPtr( Module& mod ) {
+   ConstExpr* init = GetGlobalInit(mod, 0);
+   return init ? init->const_.u32 : 0;
 }
 
 void StripZeroedData( Module& mod, size_t& fix_bytes ) {
@@ -106,8 +175,314 @@ void StripZeroedData( Module& mod, size_t& fix_bytes ) {
    mod.data_segments = ds;
 }
 
-void AddHeapPointerData( Module& mod, size_t fixup, const std::vector<uint8_t>& buff, DataSegment& ds ) {
-   uint32_t heap_ptr  = ((GetHeapPtr(mod, buff)) + 7) & ~7; // align to 8 bytes
+// Calls f on exprs and every expression list nested in it
+template <typename F>
+static void ForEachExprList( ExprList& exprs, F&& f ) {
+   f(exprs);
+   for ( Expr& expr : exprs ) {
+      switch (expr.type()) {
+         case ExprType::Block:
+            ForEachExprList(cast<BlockExpr>(&expr)->block.exprs, f);
+            break;
+         case ExprType::Loop:
+            ForEachExprList(cast<LoopExpr>(&expr)->block.exprs, f);
+            break;
+         case ExprType::If:
+            ForEachExprList(cast<IfExpr>(&expr)->true_.exprs, f);
+            ForEachExprList(cast<IfExpr>(&expr)->false_, f);
+            break;
+         case ExprType::Try:
+            ForEachExprList(cast<TryExpr>(&expr)->block.exprs, f);
+            ForEachExprList(cast<TryExpr>(&expr)->catch_, f);
+            break;
+         case ExprType::IfExcept:
+            ForEachExprList(cast<IfExceptExpr>(&expr)->true_.exprs, f);
+            ForEachExprList(cast<IfExceptExpr>(&expr)->false_, f);
+            break;
+         default:
+            break;
+      }
+   }
+}
+
+// Calls f on every expression in exprs, nested ones included
+template <typename F>
+static void ForEachExpr( ExprList& exprs, F&& f ) {
+   ForEachExprList(exprs, [&]( ExprList& list ) {
+      for ( Expr& expr : list )
+         f(expr);
+   });
+}
+
+// Zero runs at least this long split a segment in two; shorter gaps between
+// data are merged, as a new segment costs about as much as the zeros it saves
+static const uint32_t s_min_zero_run = 16;
+
+struct DataRange {
+   uint32_t begin;
+   uint64_t end;
+};
+
+static bool GetDataOffset( const DataSegment& ds, uint32_t& offset ) {
+   if (ds.offset.size() != 1)
+      return false;
+   auto* c = dyn_cast<ConstExpr>(&ds.offset.front());
+   if (!c || c->const_.type != Type::I32)
+      return false;
+   offset = c->const_.u32;
+   return true;
+}
+
+// What the function bodies can read or write of memory. Only addresses that
+// are constants in the code are known; once any address is computed at runtime
+// (a local, a loaded value, pointer arithmetic) every byte may be accessed.
+// Constants passed to imported or indirectly called functions may be pointers
+// the callee reads from, up to a length of its choosing.
+struct DataAccesses {
+   std::vector<DataRange> ranges;
+   uint32_t escaped = UINT32_MAX;
+   bool computed = false;
+
+   void Merge( const DataAccesses& other ) {
+      ranges.insert(ranges.end(), other.ranges.begin(), other.ranges.end());
+      escaped = std::min(escaped, other.escaped);
+      computed |= other.computed;
+   }
+};
+
+// Pushed by constants that cannot be addresses
+static const uint64_t s_not_address = UINT64_MAX;
+
+// Follows the instructions of a function body in order. The constants pushed
+// right before an instruction are the top of the stack it consumes, so a load,
+// store or call preceded by enough of them has constant operands.
+class AccessTracker {
+ public:
+   AccessTracker( const Module& mod, DataAccesses& accesses ) : mod(mod), accesses(accesses) {}
+
+   void OnConst( uint64_t value ) {
+      pushed.push_back(value);
+   }
+   // before every instruction other than a constant
+   void OnInstr() {
+      operands.swap(pushed);
+      pushed.clear();
+   }
+   void OnLoad( Opcode op, Address offset ) {
+      Access(operands.size() >= 1, 1, op, offset);
+   }
+   void OnStore( Opcode op, Address offset ) {
+      Access(operands.size() >= 2, 2, op, offset);
+   }
+   void OnCall( Index func ) {
+      if (func < mod.num_func_imports)
+         Escape(mod.funcs[func]->GetNumParams());
+   }
+   void OnCallIndirect( Index sig ) {
+      // the table may hold imported functions
+      Escape(mod.func_types[sig]->GetNumParams() + 1);
+   }
+   // an access this pass does not follow, such as an atomic one
+   void OnUnknownAccess() {
+      accesses.computed = true;
+   }
+
+ private:
+   void Access( bool constant, size_t depth, Opcode op, Address offset ) {
+      if (!constant) {
+         accesses.computed = true;
+         return;
+      }
+      uint64_t begin = operands[operands.size() - depth] + offset;
+      if (begin <= UINT32_MAX)
+         accesses.ranges.push_back({static_cast<uint32_t>(begin), begin + op.GetMemorySize()});
+   }
+   void Escape( size_t params ) {
+      if (operands.size() < params) {
+         accesses.computed = true;
+         return;
+      }
+      for ( size_t i = operands.size() - params; i < operands.size(); i++ )
+         if (operands[i] <= UINT32_MAX)
+            accesses.escaped = std::min<uint32_t>(accesses.escaped, operands[i]);
+   }
+
+   const Module& mod;
+   DataAccesses& accesses;
+   std::vector<uint64_t> pushed;
+   std::vector<uint64_t> operands;
+};
+
+static void CollectAccesses( const Module& mod, ExprList& exprs, DataAccesses& accesses ) {
+   ForEachExprList(exprs, [&]( ExprList& list ) {
+      AccessTracker tracker(mod, accesses);
+      for ( Expr& expr : list ) {
+         if (expr.type() == ExprType::Const) {
+            const Const& c = cast<ConstExpr>(&expr)->const_;
+            tracker.OnConst(c.type == Type::I32 ? c.u32 :
+                            c.type == Type::I64 ? c.u64 : s_not_address);
+            continue;
+         }
+         tracker.OnInstr();
+         switch (expr.type()) {
+            case ExprType::Load: {
+               auto* load = cast<LoadExpr>(&expr);
+               tracker.OnLoad(load->opcode, load->offset);
+               break;
+            }
+            case ExprType::Store: {
+               auto* store = cast<StoreExpr>(&expr);
+               tracker.OnStore(store->opcode, store->offset);
+               break;
+            }
+            case ExprType::Call: {
+               const Var& var = cast<CallExpr>(&expr)->var;
+               tracker.OnCall(var.is_index() ? var.index() : mod.GetFuncIndex(var));
+               break;
+            }
+            case ExprType::CallIndirect:
+               tracker.OnCallIndirect(mod.GetFuncTypeIndex(cast<CallIndirectExpr>(&expr)->decl));
+               break;
+            case ExprType::AtomicLoad:
+            case ExprType::AtomicStore:
+            case ExprType::AtomicRmw:
+            case ExprType::AtomicRmwCmpxchg:
+            case ExprType::AtomicWait:
+            case ExprType::AtomicWake:
+               tracker.OnUnknownAccess();
+               break;
+            default:
+               break;
+         }
+      }
+   });
+}
+
+// Lays the static data out again: zero runs are cut out and nearby data is
+// merged into one segment. Data is never moved, so addresses in the code stay
+// valid. Bytes the function bodies provably never access are dropped as well,
+// which is only possible when no address is computed at runtime; accesses are
+// collected from the function bodies by ReadFuncBodies.
+void CompactData( Module& mod, const DataAccesses& accesses ) {
+   struct Segment {
+      uint32_t offset;
+      DataSegment* ds;
+   };
+   std::vector<Segment> segs;
+   for ( auto ds : mod.data_segments ) {
+      uint32_t offset;
+      // only a single memory with constant offsets can be reasoned about
+      if (!GetDataOffset(*ds, offset) || (ds->memory_var.is_index() && ds->memory_var.index() != 0) ||
+          uint64_t(offset) + ds->data.size() > UINT32_MAX) {
+         size_t ignored = 0;
+         StripZeroedData(mod, ignored);
+         return;
+      }
+      segs.push_back({offset, ds});
+   }
+   std::stable_sort(segs.begin(), segs.end(), []( const Segment& a, const Segment& b ) {
+      return a.offset < b.offset;
+   });
+   for ( size_t i=1; i < segs.size(); i++ ) {
+      // overlapping segments depend on initialization order, leave them be
+      if (segs[i].offset < segs[i-1].offset + segs[i-1].ds->data.size()) {
+         size_t ignored = 0;
+         StripZeroedData(mod, ignored);
+         return;
+      }
+   }
+
+   // memory starts zeroed, so data that is never accessed can be zeroed too
+   // and is then cut out with the zero runs
+   size_t original_size = 0;
+   for ( const auto& seg : segs )
+      original_size += seg.ds->data.size();
+   if (accesses.computed) {
+      if (s_verbose)
+         s_log_stream->Writef("data: addresses are computed at runtime, all data is kept\n");
+   } else {
+      std::vector<DataRange> live = accesses.ranges;
+      live.push_back({accesses.escaped, uint64_t(UINT32_MAX) + 1});
+      std::sort(live.begin(), live.end(), []( const DataRange& a, const DataRange& b ) {
+         return a.begin < b.begin;
+      });
+      for ( auto& seg : segs ) {
+         auto& data = seg.ds->data;
+         uint64_t pos = seg.offset;
+         const uint64_t end = seg.offset + data.size();
+         for ( const auto& range : live ) {
+            if (range.end <= pos)
+               continue;
+            if (range.begin >= end)
+               break;
+            if (range.begin > pos)
+               std::fill(data.begin() + (pos - seg.offset), data.begin() + (range.begin - seg.offset), 0);
+            pos = std::max(pos, range.end);
+            if (pos >= end)
+               break;
+         }
+         if (pos < end)
+            std::fill(data.begin() + (pos - seg.offset), data.end(), 0);
+      }
+   }
+
+   std::vector<DataRange> runs;
+   for ( auto& seg : segs ) {
+      const auto& data = seg.ds->data;
+      for ( uint32_t i=0; i < data.size(); ) {
+         if (data[i] == 0) {
+            i++;
+            continue;
+         }
+         uint32_t start = i;
+         while (i < data.size() && data[i] != 0)
+            i++;
+         uint32_t begin = seg.offset + start;
+         if (!runs.empty() && begin - runs.back().end < s_min_zero_run)
+            runs.back().end = seg.offset + i;
+         else
+            runs.push_back({begin, seg.offset + i});
+      }
+   }
+
+   auto source = segs.begin();
+   std::vector<DataSegment*> compacted;
+   size_t compacted_size = 0;
+   for ( const auto& run : runs ) {
+      auto field = MakeUnique<DataSegmentModuleField>();
+      DataSegment& ds = field->data_segment;
+      ds.memory_var = Var(0);
+      ds.offset.push_back(MakeUnique<ConstExpr>(Const::I32(run.begin)));
+      ds.data.resize(run.end - run.begin, 0);
+      // copy from every original segment the run covers, gaps stay zero
+      while (source->offset + source->ds->data.size() <= run.begin)
+         ++source;
+      for ( auto it = source; it != segs.end() && it->offset < run.end; ++it ) {
+         uint32_t from = std::max(run.begin, it->offset);
+         uint32_t to   = std::min<uint64_t>(run.end, it->offset + it->ds->data.size());
+         std::copy(it->ds->data.begin() + (from - it->offset), it->ds->data.begin() + (to - it->offset),
+                   ds.data.begin() + (from - run.begin));
+      }
+      compacted_size += ds.data.size();
+      compacted.push_back(&ds);
+      mod.fields.push_back(std::move(field));
+   }
+   mod.data_segments = compacted;
+
+   if (s_verbose)
+      s_log_stream->Writef("data: %" PRIzd " bytes in %" PRIzd " segments compacted to %" PRIzd " bytes in %" PRIzd " segments\n",
+                           original_size, segs.size(), compacted_size, compacted.size());
+}
+
+void AddHeapPointerData( Module& mod, DataSegment& ds ) {
+   uint32_t heap_ptr = GetHeapPtr(mod);
+   // the heap must start past all initialized data
+   for ( auto seg : mod.data_segments ) {
+      uint32_t offset;
+      if (GetDataOffset(*seg, offset))
+         heap_ptr = std::max<uint64_t>(heap_ptr, uint64_t(offset) + seg->data.size());
+   }
+   heap_ptr = (heap_ptr + 7) & ~7; // align to 8 bytes
    Const c;
    c.I32(0);
    std::unique_ptr<Expr> ce(new ConstExpr(c));
@@ -121,7 +496,1241 @@ void AddHeapPointerData( Module& mod, size_t fixup, const std::vector<uint8_t>&
    mod.data_segments.push_back(&ds);
 }
 
+// Chains of `if (local == const) {...} else if (local == const) {...} else {...}`
+// shorter than this are left as they are
+static const size_t s_min_dispatch_cases = 4;
+// Ranges of at most this many cases are tested linearly at the leaves of the search tree
+static const size_t s_max_leaf_cases = 3;
+
+struct DispatchCase {
+   uint64_t value;
+   ExprList body;
+};
+
+// Matches `local.get L; i64.const C; i64.eq; if` (either operand order) starting at it
+static bool MatchEqIf( ExprList& exprs, ExprList::iterator it, Index& local, uint64_t& value ) {
+   Expr* ops[4];
+   for ( size_t i=0; i < 4; i++, ++it ) {
+      if (it == exprs.end())
+         return false;
+      ops[i] = &*it;
+   }
+   if (!isa<GetLocalExpr>(ops[0]))
+      std::swap(ops[0], ops[1]);
+   auto* get = dyn_cast<GetLocalExpr>(ops[0]);
+   auto* cnst = dyn_cast<ConstExpr>(ops[1]);
+   auto* cmp = dyn_cast<CompareExpr>(ops[2]);
+   auto* branch = dyn_cast<IfExpr>(ops[3]);
+   if (!get || !cnst || !cmp || !branch || !get->var.is_index())
+      return false;
+   if (cnst->const_.type != Type::I64 || cmp->opcode != Opcode::I64Eq)
+      return false;
+   if (branch->true_.decl.GetNumParams() != 0 || branch->true_.decl.GetNumResults() != 0)
+      return false;
+   local = get->var.index();
+   value = cnst->const_.u64;
+   return true;
+}
+
+// True if a branch inside exprs targets a label outside of them, so the exprs
+// can not be moved to a different block depth
+static bool HasEscapingBranch( const ExprList& exprs, Index depth = 0 ) {
+   auto escapes = [&]( const Var& v ) { return !v.is_index() || v.index() >= depth; };
+   for ( const Expr& expr : exprs ) {
+      switch (expr.type()) {
+         case ExprType::Br:
+            if (escapes(cast<BrExpr>(&expr)->var))
+               return true;
+            break;
+         case ExprType::BrIf:
+            if (escapes(cast<BrIfExpr>(&expr)->var))
+               return true;
+            break;
+         case ExprType::BrTable: {
+            auto* bt = cast<BrTableExpr>(&expr);
+            if (escapes(bt->default_target))
+               return true;
+            for ( const Var& v : bt->targets )
+               if (escapes(v))
+                  return true;
+            break;
+         }
+         case ExprType::Block:
+            if (HasEscapingBranch(cast<BlockExpr>(&expr)->block.exprs, depth+1))
+               return true;
+            break;
+         case ExprType::Loop:
+            if (HasEscapingBranch(cast<LoopExpr>(&expr)->block.exprs, depth+1))
+               return true;
+            break;
+         case ExprType::If: {
+            auto* branch = cast<IfExpr>(&expr);
+            if (HasEscapingBranch(branch->true_.exprs, depth+1) || HasEscapingBranch(branch->false_, depth+1))
+               return true;
+            break;
+         }
+         case ExprType::Try:
+         case ExprType::IfExcept:
+            return true;
+         default:
+            break;
+      }
+   }
+   return false;
+}
+
+static void AppendLocalCompare( ExprList& exprs, Index local, uint64_t value, Opcode op ) {
+   exprs.push_back(MakeUnique<GetLocalExpr>(Var(local)));
+   exprs.push_back(MakeUnique<ConstExpr>(Const::I64(value)));
+   exprs.push_back(MakeUnique<CompareExpr>(op));
+}
+
+// Emits a binary search over cases[first, last) sorted by value. A matching
+// case runs its body and branches out of the dispatch block; no match falls
+// through. depth is the number of labels between exprs and the miss block.
+static void BuildSearchTree( ExprList& exprs, Index local, std::vector<DispatchCase>& cases,
+                             size_t first, size_t last, Index depth ) {
+   if (last - first <= s_max_leaf_cases) {
+      for ( size_t i=first; i < last; i++ ) {
+         AppendLocalCompare(exprs, local, cases[i].value, Opcode::I64Eq);
+         auto branch = MakeUnique<IfExpr>();
+         branch->true_.exprs = std::move(cases[i].body);
+         // labels: this if, the enclosing search ifs, the miss block, then the dispatch block
+         branch->true_.exprs.push_back(MakeUnique<BrExpr>(Var(depth+2)));
+         exprs.push_back(std::move(branch));
+      }
+      return;
+   }
+   size_t mid = first + (last - first) / 2;
+   AppendLocalCompare(exprs, local, cases[mid].value, Opcode::I64LtU);
+   auto branch = MakeUnique<IfExpr>();
+   BuildSearchTree(branch->true_.exprs, local, cases, first, mid, depth+1);
+   BuildSearchTree(branch->false_, local, cases, mid, last, depth+1);
+   exprs.push_back(std::move(branch));
+}
+
+static void RebuildDispatch( ExprList& exprs );
+
+// Collects the chain starting at it, and replaces it with a balanced search
+// over the compared constants when it is long enough. On success it is moved
+// past the replacement.
+static bool RebuildChain( ExprList& exprs, ExprList::iterator& it ) {
+   Index local;
+   uint64_t value;
+   if (!MatchEqIf(exprs, it, local, value))
+      return false;
+
+   std::vector<std::pair<uint64_t, IfExpr*>> links;
+   IfExpr* link = cast<IfExpr>(&*std::next(it, 3));
+   for (;;) {
+      if (HasEscapingBranch(link->true_.exprs))
+         return false;
+      links.emplace_back(value, link);
+      Index next_local;
+      if (link->false_.size() != 4 ||
+          !MatchEqIf(link->false_, link->false_.begin(), next_local, value) || next_local != local)
+         break;
+      link = cast<IfExpr>(&*std::next(link->false_.begin(), 3));
+   }
+   if (links.size() < s_min_dispatch_cases || HasEscapingBranch(link->false_))
+      return false;
+
+   // the chain is accepted, take it out of exprs and move the bodies out of it
+   ExprList chain;
+   auto next = std::next(it, 4);
+   while (it != next)
+      chain.push_back(exprs.extract(it++));
+
+   std::vector<DispatchCase> cases;
+   std::set<uint64_t> seen;
+   for ( auto& l : links ) {
+      // a repeated constant can never be reached, the first test wins
+      if (seen.insert(l.first).second)
+         cases.push_back({l.first, std::move(l.second->true_.exprs)});
+   }
+   ExprList fallback = std::move(link->false_);
+
+   for ( auto& c : cases )
+      RebuildDispatch(c.body);
+   RebuildDispatch(fallback);
+
+   std::sort(cases.begin(), cases.end(), []( const DispatchCase& a, const DispatchCase& b ) {
+      return a.value < b.value;
+   });
+
+   // block $dispatch { block $miss { search } fallback }
+   auto miss = MakeUnique<BlockExpr>();
+   BuildSearchTree(miss->block.exprs, local, cases, 0, cases.size(), 0);
+   auto dispatch = MakeUnique<BlockExpr>();
+   dispatch->block.exprs.push_back(std::move(miss));
+   dispatch->block.exprs.splice(dispatch->block.exprs.end(), fallback);
+   exprs.insert(next, std::move(dispatch));
+   return true;
+}
+
+static void RebuildDispatch( ExprList& exprs ) {
+   for ( auto it = exprs.begin(); it != exprs.end(); ) {
+      if (RebuildChain(exprs, it))
+         continue;
+      switch (it->type()) {
+         case ExprType::Block:
+            RebuildDispatch(cast<BlockExpr>(&*it)->block.exprs);
+            break;
+         case ExprType::Loop:
+            RebuildDispatch(cast<LoopExpr>(&*it)->block.exprs);
+            break;
+         case ExprType::If: {
+            auto* branch = cast<IfExpr>(&*it);
+            RebuildDispatch(branch->true_.exprs);
+            RebuildDispatch(branch->false_);
+            break;
+         }
+         default:
+            break;
+      }
+      ++it;
+   }
+}
+
+// Replaces the linear name comparisons that select the action (and, for
+// notifications, the code) in apply with balanced binary searches over the
+// 64-bit names, so dispatch costs O(log n) compares instead of O(n)
 void construct_apply( Module& mod ) {
+   const Export* apply = mod.GetExport("apply");
+   if (!apply || apply->kind != ExternalKind::Func || mod.IsImport(*apply))
+      return;
+   Func* func = mod.GetFunc(apply->var);
+   if (func)
+      RebuildDispatch(func->exprs);
+}
+
+size_t GetModuleSize( const Module& mod ) {
+   MemoryStream stream;
+   if (Failed(WriteBinaryModule(&stream, &mod, &s_write_binary_options)))
+      return 0;
+   return stream.output_buffer().size();
+}
+
+// Function references are renumbered by the passes below, they must all be indices
+static bool HasOnlyFuncIndices( Module& mod ) {
+   bool indices = true;
+   for ( Index i=mod.num_func_imports; i < mod.funcs.size(); i++ ) {
+      ForEachExpr(mod.funcs[i]->exprs, [&]( Expr& expr ) {
+         if (auto* call = dyn_cast<CallExpr>(&expr))
+            indices &= call->var.is_index();
+      });
+   }
+   for ( auto exp : mod.exports )
+      indices &= exp->kind != ExternalKind::Func || exp->var.is_index();
+   for ( auto es : mod.elem_segments )
+      for ( const auto& v : es->vars )
+         indices &= v.is_index();
+   for ( auto start : mod.starts )
+      indices &= start->is_index();
+   return indices;
+}
+
+// Points every call, export, table entry and start reference at remap[index]
+static void RemapFuncRefs( Module& mod, const std::vector<Index>& remap, bool with_table ) {
+   auto fix = [&]( Var& v ) { v.set_index(remap[v.index()]); };
+   for ( Index i=mod.num_func_imports; i < mod.funcs.size(); i++ ) {
+      ForEachExpr(mod.funcs[i]->exprs, [&]( Expr& expr ) {
+         if (auto* call = dyn_cast<CallExpr>(&expr))
+            fix(call->var);
+      });
+   }
+   for ( auto exp : mod.exports )
+      if (exp->kind == ExternalKind::Func)
+         fix(exp->var);
+   if (with_table)
+      for ( auto es : mod.elem_segments )
+         for ( auto& v : es->vars )
+            fix(v);
+   for ( auto start : mod.starts )
+      fix(*start);
+}
+
+// Removes the functions, imported or defined, whose live entry is false
+static void RemoveFuncs( Module& mod, const std::vector<bool>& live ) {
+   std::vector<Index> remap(mod.funcs.size(), kInvalidIndex);
+   std::vector<Func*> funcs;
+   Index num_func_imports = 0;
+   for ( Index i=0; i < mod.funcs.size(); i++ ) {
+      if (!live[i])
+         continue;
+      remap[i] = funcs.size();
+      funcs.push_back(mod.funcs[i]);
+      num_func_imports += i < mod.num_func_imports;
+   }
+
+   std::vector<Import*> imports;
+   Index func_import = 0;
+   for ( auto imp : mod.imports ) {
+      if (imp->kind() == ExternalKind::Func && !live[func_import++])
+         continue;
+      imports.push_back(imp);
+   }
+
+   // drop the dead bodies first so only live calls are renumbered
+   for ( Index i=mod.num_func_imports; i < mod.funcs.size(); i++ )
+      if (!live[i])
+         mod.funcs[i]->exprs.clear();
+   RemapFuncRefs(mod, remap, true);
+
+   mod.funcs = funcs;
+   mod.imports = imports;
+   mod.num_func_imports = num_func_imports;
+   mod.func_bindings.clear();
+}
+
+// Removes functions and function imports not reachable from the exports, the
+// start function or the table
+void EliminateDeadFuncs( Module& mod ) {
+   std::vector<bool> live(mod.funcs.size(), false);
+   std::vector<Index> work;
+   auto mark = [&]( const Var& v ) {
+      if (!live[v.index()]) {
+         live[v.index()] = true;
+         work.push_back(v.index());
+      }
+   };
+   for ( auto exp : mod.exports )
+      if (exp->kind == ExternalKind::Func)
+         mark(exp->var);
+   for ( auto es : mod.elem_segments )
+      for ( const auto& v : es->vars )
+         mark(v);
+   for ( auto start : mod.starts )
+      mark(*start);
+
+   while (!work.empty()) {
+      Index i = work.back();
+      work.pop_back();
+      if (i < mod.num_func_imports)
+         continue;
+      ForEachExpr(mod.funcs[i]->exprs, [&]( Expr& expr ) {
+         if (auto* call = dyn_cast<CallExpr>(&expr))
+            mark(call->var);
+      });
+   }
+   RemoveFuncs(mod, live);
+}
+
+// The [begin, end) byte range of the code section of a binary module, from its
+// id, and of the function bodies in it, from their locals
+struct CodeSection {
+   size_t begin = 0;
+   size_t end = 0;
+   std::vector<std::pair<size_t, size_t>> bodies;
+};
+
+static CodeSection GetCodeSection( const std::vector<uint8_t>& wasm ) {
+   CodeSection code;
+   const uint8_t* data = wasm.data();
+   const uint8_t* end = data + wasm.size();
+   const uint8_t* pos = data + 8; // magic and version
+   while (pos < end) {
+      const uint8_t* section = pos;
+      uint8_t id = *pos++;
+      uint32_t size;
+      pos += ReadU32Leb128(pos, end, &size);
+      const uint8_t* section_end = pos + size;
+      if (id == 10) { // code section
+         code.begin = section - data;
+         code.end = section_end - data;
+         uint32_t count;
+         pos += ReadU32Leb128(pos, section_end, &count);
+         for ( uint32_t i=0; i < count; i++ ) {
+            uint32_t body_size;
+            pos += ReadU32Leb128(pos, section_end, &body_size);
+            code.bodies.emplace_back(pos - data, pos - data + body_size);
+            pos += body_size;
+         }
+      }
+      pos = section_end;
+   }
+   return code;
+}
+
+// Redirects references to functions whose type and encoded body match an
+// earlier function to that function. Functions in the table keep their own
+// address. Returns true if anything was folded.
+bool FoldDuplicateFuncs( Module& mod ) {
+   MemoryStream stream;
+   if (Failed(WriteBinaryModule(&stream, &mod, &s_write_binary_options)))
+      return false;
+   const auto& wasm = stream.output_buffer().data;
+   auto bodies = GetCodeSection(wasm).bodies;
+   if (bodies.size() != mod.funcs.size() - mod.num_func_imports)
+      return false;
+
+   std::vector<bool> in_table(mod.funcs.size(), false);
+   for ( auto es : mod.elem_segments )
+      for ( const auto& v : es->vars )
+         in_table[v.index()] = true;
+
+   std::map<std::pair<Index, std::string>, Index> canonical;
+   std::vector<Index> remap(mod.funcs.size());
+   bool folded = false;
+   for ( Index i=0; i < mod.funcs.size(); i++ ) {
+      remap[i] = i;
+      if (i < mod.num_func_imports)
+         continue;
+      const auto& body = bodies[i - mod.num_func_imports];
+      std::pair<Index, std::string> key{mod.GetFuncTypeIndex(mod.funcs[i]->decl),
+                                        std::string(wasm.begin() + body.first, wasm.begin() + body.second)};
+      auto it = canonical.emplace(std::move(key), i);
+      if (!it.second && !in_table[i]) {
+         remap[i] = it.first->second;
+         folded = true;
+      }
+   }
+   if (folded)
+      RemapFuncRefs(mod, remap, false);
+   return folded;
+}
+
+// Replaces reads of globals that are never written, imported or exported
+// with their constant initializer
+void PropagateConstGlobals( Module& mod ) {
+   std::vector<bool> fixed(mod.globals.size(), true);
+   for ( Index i=0; i < mod.num_global_imports; i++ )
+      fixed[i] = false;
+   for ( auto exp : mod.exports )
+      if (exp->kind == ExternalKind::Global && exp->var.is_index())
+         fixed[exp->var.index()] = false;
+   for ( Index i=mod.num_func_imports; i < mod.funcs.size(); i++ ) {
+      ForEachExpr(mod.funcs[i]->exprs, [&]( Expr& expr ) {
+         if (auto* set = dyn_cast<SetGlobalExpr>(&expr))
+            if (set->var.is_index())
+               fixed[set->var.index()] = false;
+      });
+   }
+   for ( Index i=0; i < mod.globals.size(); i++ ) {
+      auto& init = mod.globals[i]->init_expr;
+      if (init.size() != 1 || !isa<ConstExpr>(&init.front()))
+         fixed[i] = false;
+   }
+
+   for ( Index i=mod.num_func_imports; i < mod.funcs.size(); i++ ) {
+      ForEachExprList(mod.funcs[i]->exprs, [&]( ExprList& exprs ) {
+         for ( auto it = exprs.begin(); it != exprs.end(); ++it ) {
+            auto* get = dyn_cast<GetGlobalExpr>(&*it);
+            if (!get || !get->var.is_index() || !fixed[get->var.index()])
+               continue;
+            const Const& c = cast<ConstExpr>(&mod.globals[get->var.index()]->init_expr.front())->const_;
+            it = exprs.insert(it, MakeUnique<ConstExpr>(c));
+            exprs.erase(std::next(it));
+         }
+      });
+   }
+}
+
+// Finds the locals that may be read before they are written on some path, and
+// so rely on being zero initialized. Returns false for unsupported control flow.
+class LocalAssignment {
+   public:
+      explicit LocalAssignment( Index num_locals ) : zero_read(num_locals, false) {}
+
+      bool Analyze( Func& func ) {
+         State state{std::vector<bool>(func.GetNumParamsAndLocals(), false), false};
+         for ( Index i=0; i < func.GetNumParams(); i++ )
+            state.assigned[i] = true;
+         return Walk(func.exprs, state);
+      }
+
+      std::vector<bool> zero_read;
+
+   private:
+      struct State {
+         std::vector<bool> assigned;
+         bool unreachable;
+      };
+
+      struct Label {
+         bool is_loop;
+         State merged;
+      };
+
+      static State Meet( const State& a, const State& b ) {
+         if (a.unreachable)
+            return b;
+         if (b.unreachable)
+            return a;
+         State r = a;
+         for ( size_t i=0; i < r.assigned.size(); i++ )
+            r.assigned[i] = a.assigned[i] && b.assigned[i];
+         return r;
+      }
+
+      void Branch( const Var& v, const State& state ) {
+         if (v.index() >= labels.size())
+            return; // leaves the function
+         Label& label = labels[labels.size() - 1 - v.index()];
+         if (!label.is_loop)
+            label.merged = Meet(label.merged, state);
+      }
+
+      bool WalkBlock( ExprList& exprs, State& state, bool is_loop ) {
+         labels.push_back({is_loop, State{state.assigned, true}});
+         if (!Walk(exprs, state))
+            return false;
+         state = Meet(state, labels.back().merged);
+         labels.pop_back();
+         return true;
+      }
+
+      bool Walk( ExprList& exprs, State& state ) {
+         for ( Expr& expr : exprs ) {
+            switch (expr.type()) {
+               case ExprType::GetLocal: {
+                  Index i = cast<GetLocalExpr>(&expr)->var.index();
+                  if (!state.unreachable && !state.assigned[i])
+                     zero_read[i] = true;
+                  break;
+               }
+               case ExprType::SetLocal:
+                  state.assigned[cast<SetLocalExpr>(&expr)->var.index()] = true;
+                  break;
+               case ExprType::TeeLocal:
+                  state.assigned[cast<TeeLocalExpr>(&expr)->var.index()] = true;
+                  break;
+               case ExprType::Block:
+                  if (!WalkBlock(cast<BlockExpr>(&expr)->block.exprs, state, false))
+                     return false;
+                  break;
+               case ExprType::Loop:
+                  if (!WalkBlock(cast<LoopExpr>(&expr)->block.exprs, state, true))
+                     return false;
+                  break;
+               case ExprType::If: {
+                  auto* branch = cast<IfExpr>(&expr);
+                  State other = state;
+                  labels.push_back({false, State{state.assigned, true}});
+                  if (!Walk(branch->true_.exprs, state) || !Walk(branch->false_, other))
+                     return false;
+                  state = Meet(Meet(state, other), labels.back().merged);
+                  labels.pop_back();
+                  break;
+               }
+               case ExprType::Br:
+                  Branch(cast<BrExpr>(&expr)->var, state);
+                  state.unreachable = true;
+                  break;
+               case ExprType::BrIf:
+                  Branch(cast<BrIfExpr>(&expr)->var, state);
+                  break;
+               case ExprType::BrTable: {
+                  auto* table = cast<BrTableExpr>(&expr);
+                  for ( const auto& v : table->targets )
+                     Branch(v, state);
+                  Branch(table->default_target, state);
+                  state.unreachable = true;
+                  break;
+               }
+               case ExprType::Return:
+               case ExprType::Unreachable:
+                  state.unreachable = true;
+                  break;
+               case ExprType::Try:
+               case ExprType::IfExcept:
+                  return false;
+               default:
+                  break;
+            }
+         }
+         return true;
+      }
+
+      std::vector<Label> labels;
+};
+
+// Lets locals whose live ranges do not overlap share one slot, and drops
+// locals that are never used
+void CoalesceLocals( Func& func ) {
+   const Index num_params = func.GetNumParams();
+   const Index num_all = func.GetNumParamsAndLocals();
+   if (num_all == num_params)
+      return;
+
+   bool indices = true;
+   ForEachExpr(func.exprs, [&]( Expr& expr ) {
+      if (auto* get = dyn_cast<GetLocalExpr>(&expr))
+         indices &= get->var.is_index();
+      else if (auto* set = dyn_cast<SetLocalExpr>(&expr))
+         indices &= set->var.is_index();
+      else if (auto* tee = dyn_cast<TeeLocalExpr>(&expr))
+         indices &= tee->var.is_index();
+   });
+   LocalAssignment assignment(num_all);
+   if (!indices || !assignment.Analyze(func))
+      return;
+
+   // number the local accesses in execution order and note where the loops are
+   struct Range {
+      uint32_t begin = UINT32_MAX;
+      uint32_t end = 0;
+   };
+   std::vector<Range> live(num_all);
+   std::vector<Range> loops;
+   uint32_t pos = 0;
+   std::function<void(ExprList&)> number = [&]( ExprList& exprs ) {
+      for ( Expr& expr : exprs ) {
+         Var* var = nullptr;
+         switch (expr.type()) {
+            case ExprType::GetLocal: var = &cast<GetLocalExpr>(&expr)->var; break;
+            case ExprType::SetLocal: var = &cast<SetLocalExpr>(&expr)->var; break;
+            case ExprType::TeeLocal: var = &cast<TeeLocalExpr>(&expr)->var; break;
+            case ExprType::Block: number(cast<BlockExpr>(&expr)->block.exprs); break;
+            case ExprType::Loop: {
+               Range loop;
+               loop.begin = pos;
+               number(cast<LoopExpr>(&expr)->block.exprs);
+               loop.end = pos;
+               loops.push_back(loop);
+               break;
+            }
+            case ExprType::If:
+               number(cast<IfExpr>(&expr)->true_.exprs);
+               number(cast<IfExpr>(&expr)->false_);
+               break;
+            default:
+               break;
+         }
+         if (var) {
+            Range& r = live[var->index()];
+            r.begin = std::min(r.begin, pos);
+            r.end = std::max(r.end, pos);
+            pos++;
+         }
+      }
+   };
+   number(func.exprs);
+
+   // a value that is live on both sides of a loop boundary is live through
+   // every iteration of the loop
+   for ( Index i=num_params; i < num_all; i++ ) {
+      Range& r = live[i];
+      for ( bool changed = true; changed; ) {
+         changed = false;
+         for ( const auto& loop : loops ) {
+            bool overlaps = r.begin < loop.end && loop.begin <= r.end;
+            bool inside = loop.begin <= r.begin && r.end < loop.end;
+            if (overlaps && !inside) {
+               uint32_t begin = std::min(r.begin, loop.begin);
+               uint32_t end = std::max(r.end, loop.end);
+               changed |= begin != r.begin || end != r.end;
+               r.begin = begin;
+               r.end = end;
+            }
+         }
+      }
+   }
+
+   // assign slots, reusing a slot of the same type once its last user is done
+   struct Slot {
+      Type type;
+      uint32_t end;
+      bool shared;
+   };
+   std::vector<Slot> slots;
+   std::vector<Index> order;
+   for ( Index i=num_params; i < num_all; i++ )
+      if (live[i].begin != UINT32_MAX)
+         order.push_back(i);
+   std::stable_sort(order.begin(), order.end(), [&]( Index a, Index b ) {
+      return live[a].begin < live[b].begin;
+   });
+   std::vector<Index> slot_of(num_all, kInvalidIndex);
+   for ( Index i : order ) {
+      Type type = func.GetLocalType(i);
+      bool shareable = !assignment.zero_read[i];
+      Index chosen = kInvalidIndex;
+      if (shareable) {
+         for ( Index s=0; s < slots.size(); s++ ) {
+            if (slots[s].shared && slots[s].type == type && slots[s].end < live[i].begin) {
+               chosen = s;
+               break;
+            }
+         }
+      }
+      if (chosen == kInvalidIndex) {
+         chosen = slots.size();
+         slots.push_back({type, 0, shareable});
+      }
+      slots[chosen].end = live[i].end;
+      slot_of[i] = chosen;
+   }
+
+   // group the slots by type so the local declarations stay short
+   std::vector<Index> slot_order(slots.size());
+   for ( Index s=0; s < slots.size(); s++ )
+      slot_order[s] = s;
+   std::stable_sort(slot_order.begin(), slot_order.end(), [&]( Index a, Index b ) {
+      return slots[a].type < slots[b].type;
+   });
+   std::vector<Index> slot_index(slots.size());
+   TypeVector types;
+   for ( Index s : slot_order ) {
+      slot_index[s] = num_params + types.size();
+      types.push_back(slots[s].type);
+   }
+
+   auto fix = [&]( Var& v ) {
+      if (v.index() >= num_params)
+         v.set_index(slot_index[slot_of[v.index()]]);
+   };
+   ForEachExpr(func.exprs, [&]( Expr& expr ) {
+      if (auto* get = dyn_cast<GetLocalExpr>(&expr))
+         fix(get->var);
+      else if (auto* set = dyn_cast<SetLocalExpr>(&expr))
+         fix(set->var);
+      else if (auto* tee = dyn_cast<TeeLocalExpr>(&expr))
+         fix(tee->var);
+   });
+   func.local_types.Set(types);
+   func.local_bindings.clear();
+}
+
+// Runs the optimization passes enabled at level, logging the bytes each saved
+void Optimize( Module& mod, int level ) {
+   if (level <= 0 || !HasOnlyFuncIndices(mod))
+      return;
+   // the module is encoded to measure it, only for the report
+   size_t size = s_verbose ? GetModuleSize(mod) : 0;
+   auto report = [&]( const char* pass ) {
+      if (!s_verbose)
+         return;
+      size_t new_size = GetModuleSize(mod);
+      s_log_stream->Writef("%-24s %" PRIzd " bytes saved\n", pass, size - new_size);
+      size = new_size;
+   };
+
+   EliminateDeadFuncs(mod);
+   report("dead functions/imports");
+   while (FoldDuplicateFuncs(mod))
+      EliminateDeadFuncs(mod);
+   report("duplicate functions");
+   if (level < 2)
+      return;
+   for ( Index i=mod.num_func_imports; i < mod.funcs.size(); i++ )
+      CoalesceLocals(*mod.funcs[i]);
+   report("local coalescing");
+   PropagateConstGlobals(mod);
+   report("constant globals");
+}
+
+// A value of the stack pointer analysis: unknown, an i32 constant, or the
+// stack pointer on entry to the function plus offset
+struct StackValue {
+   enum Kind { Unknown, Constant, StackPointer } kind = Unknown;
+   int64_t value = 0;
+   // derived from a size not known statically, i.e. an alloca
+   bool dynamic = false;
+};
+
+struct StackFrame {
+   // bytes below the stack pointer on entry, dynamic allocations excluded
+   uint64_t size = 0;
+   Index dynamic_allocs = 0;
+   // allocates on the stack in a loop
+   bool unbounded = false;
+   bool indirect_calls = false;
+   std::vector<Index> callees;
+};
+
+// Follows the values derived from the stack pointer (global 0) through the
+// operand stack and the locals, to find how far below its value on entry the
+// function moves it. The operand stack is only followed within straight line
+// code; any expression not modeled here clears it. The code emitted by the
+// compiler adjusts the stack pointer with straight line sequences such as
+// `global.get 0; i32.const 32; i32.sub; local.tee 1; global.set 0`.
+class StackFrameAnalysis {
+   public:
+      StackFrameAnalysis( Module& mod, StackFrame& frame ) : mod(mod), frame(frame) {}
+
+      void Analyze( Func& func ) {
+         Walk(func.exprs, false);
+         frame.size = uint64_t(-lowest);
+      }
+
+   private:
+      StackValue Pop( std::vector<StackValue>& stack ) {
+         if (stack.empty())
+            return StackValue();
+         StackValue v = stack.back();
+         stack.pop_back();
+         return v;
+      }
+
+      static StackValue Offset( const StackValue& sp, int64_t offset, bool dynamic ) {
+         StackValue v = sp;
+         v.value += offset;
+         v.dynamic |= dynamic;
+         return v;
+      }
+
+      StackValue Binary( Opcode op, const StackValue& a, const StackValue& b ) {
+         bool a_sp = a.kind == StackValue::StackPointer;
+         bool b_sp = b.kind == StackValue::StackPointer;
+         bool a_const = a.kind == StackValue::Constant;
+         bool b_const = b.kind == StackValue::Constant;
+         switch (op) {
+            case Opcode::I32Sub:
+               if (a_sp)
+                  return b_const ? Offset(a, -b.value, false) : Offset(a, 0, true);
+               break;
+            case Opcode::I32Add:
+               if (a_sp && b_const)
+                  return Offset(a, b.value, false);
+               if (b_sp && a_const)
+                  return Offset(b, a.value, false);
+               break;
+            case Opcode::I32And:
+               // aligning down, by at most the alignment minus one
+               if (a_sp && b_const && b.value < 0)
+                  return Offset(a, b.value + 1, false);
+               if (b_sp && a_const && a.value < 0)
+                  return Offset(b, a.value + 1, false);
+               break;
+            default:
+               break;
+         }
+         return StackValue();
+      }
+
+      void Walk( ExprList& exprs, bool in_loop ) {
+         std::vector<StackValue> stack;
+         for ( Expr& expr : exprs ) {
+            switch (expr.type()) {
+               case ExprType::Const: {
+                  const Const& c = cast<ConstExpr>(&expr)->const_;
+                  StackValue v;
+                  if (c.type == Type::I32) {
+                     v.kind = StackValue::Constant;
+                     v.value = int32_t(c.u32);
+                  }
+                  stack.push_back(v);
+                  break;
+               }
+               case ExprType::GetGlobal: {
+                  StackValue v;
+                  if (cast<GetGlobalExpr>(&expr)->var.index() == 0) {
+                     v.kind = StackValue::StackPointer;
+                     v.value = lowest;
+                  }
+                  stack.push_back(v);
+                  break;
+               }
+               case ExprType::SetGlobal: {
+                  StackValue v = Pop(stack);
+                  if (cast<SetGlobalExpr>(&expr)->var.index() == 0 && v.kind == StackValue::StackPointer) {
+                     lowest = std::min(lowest, v.value);
+                     if (v.dynamic) {
+                        frame.dynamic_allocs++;
+                        frame.unbounded |= in_loop;
+                     }
+                  }
+                  break;
+               }
+               case ExprType::GetLocal:
+                  stack.push_back(locals[cast<GetLocalExpr>(&expr)->var.index()]);
+                  break;
+               case ExprType::SetLocal:
+                  locals[cast<SetLocalExpr>(&expr)->var.index()] = Pop(stack);
+                  break;
+               case ExprType::TeeLocal:
+                  locals[cast<TeeLocalExpr>(&expr)->var.index()] = stack.empty() ? StackValue() : stack.back();
+                  break;
+               case ExprType::Binary: {
+                  StackValue b = Pop(stack);
+                  StackValue a = Pop(stack);
+                  stack.push_back(Binary(cast<BinaryExpr>(&expr)->opcode, a, b));
+                  break;
+               }
+               case ExprType::Call:
+                  frame.callees.push_back(cast<CallExpr>(&expr)->var.index());
+                  stack.clear();
+                  break;
+               case ExprType::CallIndirect: {
+                  Index type = mod.GetFuncTypeIndex(cast<CallIndirectExpr>(&expr)->decl);
+                  for ( auto es : mod.elem_segments )
+                     for ( const auto& v : es->vars )
+                        if (mod.GetFuncTypeIndex(mod.funcs[v.index()]->decl) == type)
+                           frame.callees.push_back(v.index());
+                  frame.indirect_calls = true;
+                  stack.clear();
+                  break;
+               }
+               case ExprType::Block:
+                  stack.clear();
+                  Walk(cast<BlockExpr>(&expr)->block.exprs, in_loop);
+                  break;
+               case ExprType::Loop:
+                  stack.clear();
+                  Walk(cast<LoopExpr>(&expr)->block.exprs, true);
+                  break;
+               case ExprType::If:
+                  stack.clear();
+                  Walk(cast<IfExpr>(&expr)->true_.exprs, in_loop);
+                  Walk(cast<IfExpr>(&expr)->false_, in_loop);
+                  break;
+               case ExprType::Try:
+                  stack.clear();
+                  Walk(cast<TryExpr>(&expr)->block.exprs, in_loop);
+                  Walk(cast<TryExpr>(&expr)->catch_, in_loop);
+                  break;
+               case ExprType::IfExcept:
+                  stack.clear();
+                  Walk(cast<IfExceptExpr>(&expr)->true_.exprs, in_loop);
+                  Walk(cast<IfExceptExpr>(&expr)->false_, in_loop);
+                  break;
+               default:
+                  stack.clear();
+                  break;
+            }
+         }
+      }
+
+      Module& mod;
+      StackFrame& frame;
+      std::map<Index, StackValue> locals;
+      // lowest offset the stack pointer is set to, relative to its value on entry
+      int64_t lowest = 0;
+};
+
+static std::string GetFuncName( Module& mod, Index index ) {
+   const std::string& name = mod.funcs[index]->name;
+   if (!name.empty())
+      return name[0] == '$' ? name.substr(1) : name;
+   for ( auto exp : mod.exports )
+      if (exp->kind == ExternalKind::Func && exp->var.index() == index)
+         return exp->name;
+   return "func[" + std::to_string(index) + "]";
+}
+
+// Computes the worst case stack usage of the exported functions, as the
+// largest sum of frames along a call chain, and checks it against the stack
+// the contract was linked with. Recursion, and allocations of unbounded size,
+// make the worst case unbounded; indirect calls may reach any function of the
+// table with the called signature. With s_shrink_stack, and the stack laid out
+// after the static data, the stack is cut to the worst case and the memory
+// left over goes to the heap. Returns false if the stack can overflow, which
+// an unbounded worst case may unless s_allow_unbounded_stack is set.
+bool AnalyzeStack( Module& mod ) {
+   Global* sp = mod.GetGlobal(Var(0));
+   if (!sp || !sp->mutable_ || !GetGlobalInit(mod, 0) || !HasOnlyFuncIndices(mod))
+      return true;
+
+   std::vector<StackFrame> frames(mod.funcs.size());
+   Index dynamic_allocs = 0;
+   Index indirect_calls = 0;
+   for ( Index i=mod.num_func_imports; i < mod.funcs.size(); i++ ) {
+      StackFrameAnalysis(mod, frames[i]).Analyze(*mod.funcs[i]);
+      dynamic_allocs += frames[i].dynamic_allocs;
+      indirect_calls += frames[i].indirect_calls;
+   }
+
+   // depth-first search of the deepest call chain from every function, the
+   // chains closed by recursion being unbounded
+   enum { Unvisited, Visiting, Done };
+   std::vector<int> state(mod.funcs.size(), Unvisited);
+   std::vector<uint64_t> depth(mod.funcs.size(), 0);
+   std::vector<bool> unbounded(mod.funcs.size(), false);
+   std::vector<Index> deepest(mod.funcs.size(), kInvalidIndex);
+   std::vector<Index> path;
+   std::string recursion;
+   std::function<void(Index)> visit = [&]( Index i ) {
+      state[i] = Visiting;
+      path.push_back(i);
+      const StackFrame& frame = frames[i];
+      unbounded[i] = frame.unbounded;
+      for ( Index callee : frame.callees ) {
+         if (state[callee] == Visiting) {
+            unbounded[i] = true;
+            if (recursion.empty()) {
+               auto it = std::find(path.begin(), path.end(), callee);
+               for ( ; it != path.end(); ++it )
+                  recursion += GetFuncName(mod, *it) + " -> ";
+               recursion += GetFuncName(mod, callee);
+            }
+            continue;
+         }
+         if (state[callee] == Unvisited)
+            visit(callee);
+         unbounded[i] = unbounded[i] || unbounded[callee];
+         if (callee < mod.num_func_imports)
+            continue;
+         if (deepest[i] == kInvalidIndex || depth[callee] > depth[deepest[i]])
+            deepest[i] = callee;
+      }
+      depth[i] = frame.size + uint64_t(frame.dynamic_allocs) * s_max_alloca;
+      if (deepest[i] != kInvalidIndex)
+         depth[i] += depth[deepest[i]];
+      path.pop_back();
+      state[i] = Done;
+   };
+
+   Index root = kInvalidIndex;
+   bool is_unbounded = false;
+   for ( auto exp : mod.exports ) {
+      if (exp->kind != ExternalKind::Func)
+         continue;
+      Index i = exp->var.index();
+      if (state[i] == Unvisited)
+         visit(i);
+      is_unbounded |= unbounded[i];
+      if (root == kInvalidIndex || depth[i] > depth[root])
+         root = i;
+   }
+   if (root == kInvalidIndex)
+      return true;
+
+   std::string chain;
+   for ( Index i = root; i != kInvalidIndex; i = deepest[i] )
+      chain += (chain.empty() ? "" : " -> ") + GetFuncName(mod, i);
+
+   // the stack grows down from the initial stack pointer, to the start of
+   // memory when it is laid out first, or else to the end of the static data
+   uint32_t stack_ptr = GetStackPtr(mod);
+   bool stack_first = true;
+   for ( auto seg : mod.data_segments ) {
+      uint32_t offset;
+      if (GetDataOffset(*seg, offset) && offset < stack_ptr)
+         stack_first = false;
+   }
+   uint64_t available = stack_first ? stack_ptr : s_stack_size;
+
+   std::unique_ptr<FileStream> err = FileStream::CreateStderr();
+   if (s_verbose || s_check_stack) {
+      err->Writef("stack: worst case %" PRIu64 " bytes%s (%s)", depth[root],
+                               is_unbounded ? " or more" : "", chain.c_str());
+      if (available)
+         err->Writef(", %" PRIu64 " bytes available", available);
+      else
+         err->Writef(", stack size unknown");
+      err->Writef("\n");
+      if (!recursion.empty())
+         err->Writef("stack: unbounded, recursion through %s\n", recursion.c_str());
+      for ( Index i=mod.num_func_imports; i < mod.funcs.size(); i++ )
+         if (frames[i].unbounded)
+            err->Writef("stack: unbounded, %s allocates on the stack in a loop\n",
+                                     GetFuncName(mod, i).c_str());
+      if (dynamic_allocs)
+         err->Writef("stack: %u dynamic allocations counted as %u bytes each\n",
+                                  dynamic_allocs, s_max_alloca);
+      if (indirect_calls)
+         err->Writef("stack: indirect calls in %u functions, assumed to reach every "
+                                  "function of the table with their signature\n", indirect_calls);
+   }
+
+   // an unbounded worst case is at least depth[root], which must fit as well
+   bool fits = !available || depth[root] <= available;
+   if (!fits)
+      err->Writef("stack: %s can overflow the stack by %" PRIu64 " bytes%s\n",
+                               chain.c_str(), depth[root] - available, is_unbounded ? " or more" : "");
+   else if (is_unbounded && s_check_stack && !s_allow_unbounded_stack)
+      err->Writef("stack: can overflow the stack, its worst case is unbounded "
+                               "(--allow-unbounded-stack to accept it)\n");
+
+   if (s_shrink_stack && is_unbounded)
+      err->Writef("stack: can not shrink an unbounded stack\n");
+   else if (s_shrink_stack && fits) {
+      uint64_t needed = (depth[root] + 15) & ~uint64_t(15);
+      if (stack_first) {
+         err->Writef("stack: can not shrink a stack laid out first, link with "
+                                  "-stack-size=%" PRIu64 " instead\n", needed);
+      } else if (!s_stack_size || s_stack_size > stack_ptr) {
+         err->Writef("stack: the stack size the contract was linked with is needed to shrink it\n");
+      } else if (needed < s_stack_size) {
+         uint32_t new_stack_ptr = stack_ptr - s_stack_size + needed;
+         // the heap starts where the stack ended
+         if (GetHeapPtr(mod) == stack_ptr)
+            GetGlobalInit(mod, 1)->const_.u32 = new_stack_ptr;
+         GetGlobalInit(mod, 0)->const_.u32 = new_stack_ptr;
+         if (s_verbose)
+            s_log_stream->Writef("stack: shrunk from %u to %" PRIu64 " bytes\n", s_stack_size, needed);
+      }
+   }
+   return (fits && (!is_unbounded || s_allow_unbounded_stack)) || !s_check_stack;
+}
+
+// Collects the accesses CollectAccesses would from function bodies, without
+// building their IR
+class BinaryReaderAccesses : public BinaryReaderNop {
+ public:
+   BinaryReaderAccesses( const Module& mod, DataAccesses& accesses ) : mod(mod), accesses(accesses) {}
+
+   Result BeginFunctionBody( Index ) override {
+      tracker.reset(new AccessTracker(mod, accesses));
+      return Result::Ok;
+   }
+   Result OnOpcode( Opcode op ) override {
+      if (op != Opcode::I32Const && op != Opcode::I64Const && op != Opcode::F32Const &&
+          op != Opcode::F64Const && op != Opcode::V128Const)
+         tracker->OnInstr();
+      return Result::Ok;
+   }
+   Result OnI32ConstExpr( uint32_t value ) override { return OnConst(value); }
+   Result OnI64ConstExpr( uint64_t value ) override { return OnConst(value); }
+   Result OnF32ConstExpr( uint32_t ) override { return OnConst(s_not_address); }
+   Result OnF64ConstExpr( uint64_t ) override { return OnConst(s_not_address); }
+   Result OnV128ConstExpr( v128 ) override { return OnConst(s_not_address); }
+   Result OnLoadExpr( Opcode op, uint32_t, Address offset ) override {
+      tracker->OnLoad(op, offset);
+      return Result::Ok;
+   }
+   Result OnStoreExpr( Opcode op, uint32_t, Address offset ) override {
+      tracker->OnStore(op, offset);
+      return Result::Ok;
+   }
+   Result OnCallExpr( Index func ) override {
+      tracker->OnCall(func);
+      return Result::Ok;
+   }
+   Result OnCallIndirectExpr( Index sig ) override {
+      tracker->OnCallIndirect(sig);
+      return Result::Ok;
+   }
+   Result OnAtomicLoadExpr( Opcode, uint32_t, Address ) override { return OnAtomic(); }
+   Result OnAtomicStoreExpr( Opcode, uint32_t, Address ) override { return OnAtomic(); }
+   Result OnAtomicRmwExpr( Opcode, uint32_t, Address ) override { return OnAtomic(); }
+   Result OnAtomicRmwCmpxchgExpr( Opcode, uint32_t, Address ) override { return OnAtomic(); }
+   Result OnAtomicWaitExpr( Opcode, uint32_t, Address ) override { return OnAtomic(); }
+   Result OnAtomicWakeExpr( Opcode, uint32_t, Address ) override { return OnAtomic(); }
+
+ private:
+   Result OnConst( uint64_t value ) {
+      tracker->OnConst(value);
+      return Result::Ok;
+   }
+   Result OnAtomic() {
+      tracker->OnUnknownAccess();
+      return Result::Ok;
+   }
+
+   const Module& mod;
+   DataAccesses& accesses;
+   std::unique_ptr<AccessTracker> tracker;
+};
+
+// Without optimizations only apply is rewritten: the other bodies are copied
+// from the input and, unless the stack is analyzed, never read into the IR
+struct FuncBodies {
+   std::vector<bool> copy;
+   std::vector<bool> keep;
+   unsigned jobs = 1;
+
+   // a thread reads the sections other than code again, it needs enough
+   // bodies to be worth it
+   static const Index min_bodies_per_job = 64;
+
+   void Select( const Module& mod, bool analyze_stack ) {
+      Index count = mod.funcs.size() - mod.num_func_imports;
+      jobs = std::max<Index>(1, std::min<Index>(s_jobs, count / min_bodies_per_job));
+      copy.assign(mod.funcs.size(), false);
+      for ( Index i=mod.num_func_imports; i < copy.size(); i++ )
+         copy[i] = s_opt_level <= 0;
+      const Export* apply = mod.GetExport("apply");
+      if (apply && apply->kind == ExternalKind::Func && apply->var.is_index() &&
+          apply->var.index() < copy.size())
+         copy[apply->var.index()] = false;
+      keep.resize(mod.funcs.size());
+      for ( Index i=0; i < keep.size(); i++ )
+         keep[i] = analyze_stack || !copy[i];
+   }
+
+   // The [first, last) function indices of the bodies job reads
+   std::pair<Index, Index> GetShare( const Module& mod, unsigned job ) const {
+      uint64_t count = mod.funcs.size() - mod.num_func_imports;
+      return {mod.num_func_imports + count * job / jobs,
+              mod.num_func_imports + count * (job + 1) / jobs};
+   }
+};
+
+// Reads the function bodies of mod in bodies.jobs threads, each taking its
+// share. The share of the first one was read into mod with the module; the
+// others are read into modules of their own and moved into mod, for the bodies
+// that are kept. Only the memory accesses of the rest are collected, for CompactData.
+Result ReadFuncBodies( const std::vector<uint8_t>& file_data, Module& mod,
+                       const FuncBodies& bodies, DataAccesses& accesses ) {
+   const auto& keep = bodies.keep;
+   std::vector<Result> results(bodies.jobs, Result::Ok);
+   std::vector<DataAccesses> job_accesses(bodies.jobs);
+
+   auto read = [&]( unsigned job ) {
+      Index first, last;
+      std::tie(first, last) = bodies.GetShare(mod, job);
+      auto begin = keep.begin() + first;
+      auto end = keep.begin() + last;
+      ReadBinaryOptions options(s_features, nullptr, false, true, false);
+      if (std::find(begin, end, false) != end) {
+         options.read_function_body = [&]( Index i ) { return i >= first && i < last && !keep[i]; };
+         BinaryReaderAccesses collector(mod, job_accesses[job]);
+         results[job] = ReadBinary(file_data.data(), file_data.size(), &collector, &options);
+      }
+      if (Failed(results[job]) || std::find(begin, end, true) == end)
+         return;
+
+      Module shard;
+      if (job > 0) {
+         ErrorHandlerFile error_handler(Location::Type::Binary);
+         options.read_function_body = [&]( Index i ) { return i >= first && i < last && keep[i]; };
+         results[job] = ReadBinaryIr(s_infile.c_str(), file_data.data(), file_data.size(),
+                                     &options, &error_handler, &shard);
+         if (Failed(results[job]))
+            return;
+      }
+      for ( Index i=first; i < last; i++ ) {
+         if (!keep[i])
+            continue;
+         if (job > 0)
+            mod.funcs[i]->exprs = std::move(shard.funcs[i]->exprs);
+         CollectAccesses(mod, mod.funcs[i]->exprs, job_accesses[job]);
+      }
+   };
+
+   std::vector<std::thread> threads;
+   for ( unsigned job=1; job < bodies.jobs; job++ )
+      threads.emplace_back(read, job);
+   read(0);
+   for ( auto& thread : threads )
+      thread.join();
+
+   for ( unsigned job=0; job < bodies.jobs; job++ ) {
+      if (Failed(results[job]))
+         return results[job];
+      accesses.Merge(job_accesses[job]);
+   }
+   return Result::Ok;
+}
+
+// Writes out with the bodies of the functions for which copy is set, which
+// the passes left untouched, copied from the input rather than encoded again
+static void CopyFuncBodies( const std::vector<uint8_t>& in, const std::vector<uint8_t>& out,
+                            const Module& mod, const std::vector<bool>& copy, OutputBuffer& result ) {
+   CodeSection in_code = GetCodeSection(in);
+   CodeSection out_code = GetCodeSection(out);
+   Index count = mod.funcs.size() - mod.num_func_imports;
+   assert(in_code.bodies.size() == count && out_code.bodies.size() == count);
+
+   MemoryStream code;
+   WriteU32Leb128(&code, count, "num functions");
+   for ( Index i=0; i < count; i++ ) {
+      bool copied = copy[mod.num_func_imports + i];
+      const auto& body = copied ? in_code.bodies[i] : out_code.bodies[i];
+      const uint8_t* data = (copied ? in : out).data();
+      WriteU32Leb128(&code, body.second - body.first, "func body size");
+      code.WriteData(data + body.first, body.second - body.first);
+   }
+
+   MemoryStream stream;
+   stream.WriteData(out.data(), out_code.begin);
+   stream.WriteU8(10, "section code");
+   WriteU32Leb128(&stream, code.output_buffer().size(), "section size");
+   stream.WriteData(code.output_buffer().data.data(), code.output_buffer().size());
+   stream.WriteData(out.data() + out_code.end, out.size() - out_code.end);
+   result.data = std::move(stream.ReleaseOutputBuffer()->data);
 }
 
 void WriteBufferToFile(string_view filename,
@@ -134,7 +1743,7 @@ int ProgramMain(int argc, char** argv) {
   
   InitStdio();
   ParseOptions(argc, argv);
-  
+
   std::vector<uint8_t> file_data;
   bool stub = false;
   std::unique_ptr<FileStream> s_log_stream_s;
@@ -144,17 +1753,42 @@ int ProgramMain(int argc, char** argv) {
     ErrorHandlerFile error_handler(Location::Type::Binary);
     Module module;
     const bool kStopOnFirstError = true;
+    const bool kAnalyzeStack = s_check_stack || s_shrink_stack || s_verbose;
+    // the names are only used to report the stack usage
+    const bool kReadDebugNames = kAnalyzeStack;
     ReadBinaryOptions options(s_features, s_log_stream_s.get(),
-                              stub, kStopOnFirstError,
+                              kReadDebugNames, kStopOnFirstError,
                               stub);
+    // Only the first share of the bodies the passes need is read with the
+    // module, the code section comes after the exports they are selected by
+    FuncBodies bodies;
+    options.read_function_body = [&]( Index i ) {
+      if (bodies.keep.empty())
+        bodies.Select(module, kAnalyzeStack);
+      return bodies.keep[i] && i < bodies.GetShare(module, 0).second;
+    };
     result = ReadBinaryIr(s_infile.c_str(), file_data.data(),
                           file_data.size(), &options, &error_handler, &module);
 
+    DataAccesses accesses;
     if (Succeeded(result)) {
-      size_t fixup = 0;
-      StripZeroedData(module, fixup);
-      AddHeapPointerData(module, fixup, file_data, _hds);
+      if (bodies.keep.empty())
+        bodies.Select(module, kAnalyzeStack);
+      result = ReadFuncBodies(file_data, module, bodies, accesses);
+    }
+
+    if (Succeeded(result)) {
+      CompactData(module, accesses);
+      if (kAnalyzeStack && !AnalyzeStack(module))
+         result = Result::Error;
+      AddHeapPointerData(module, _hds);
+      construct_apply(module);
+      Optimize(module, s_opt_level);
      if (Succeeded(result)) {
+      // encode only the rewritten bodies
+      for ( Index i=module.num_func_imports; i < module.funcs.size(); i++ )
+         if (bodies.copy[i])
+            module.funcs[i]->exprs.clear();
       MemoryStream stream(s_log_stream.get());
       result =
           WriteBinaryModule(&stream, &module, &s_write_binary_options);
@@ -163,7 +1797,14 @@ int ProgramMain(int argc, char** argv) {
         if (s_outfile.empty()) {
           s_outfile = s_infile;
         }
-        WriteBufferToFile(s_outfile.c_str(), stream.output_buffer());
+        const auto& copy = bodies.copy;
+        if (std::find(copy.begin(), copy.end(), true) != copy.end()) {
+          OutputBuffer output;
+          CopyFuncBodies(file_data, stream.output_buffer().data, module, copy, output);
+          WriteBufferToFile(s_outfile.c_str(), output);
+        } else {
+          WriteBufferToFile(s_outfile.c_str(), stream.output_buffer());
+        }
       }
     }
    } 
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2018 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EOSIO_AOT_RT_H_
+#define EOSIO_AOT_RT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "wasm-rt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The raw bits of a value passed to or returned by an intrinsic. */
+typedef union {
+  uint32_t i32;
+  uint64_t i64;
+  uint32_t f32_bits;
+  uint64_t f64_bits;
+} eosio_aot_value;
+
+/** A contract compiled by eosio-aot. */
+typedef struct {
+  /** The account the contract is deployed on, or NULL for the account of the
+   * first action (or the one given with --account). */
+  const char* account;
+  /** The WebAssembly file the contract was compiled from. */
+  const char* filename;
+  /** Start a fresh instance of the contract, discarding the previous one. */
+  void (*reset)(void);
+  /** Call `apply`, returning the trap that stopped it or `WASM_RT_TRAP_NONE`
+   * if it returned. */
+  wasm_rt_trap_t (*apply)(uint64_t receiver, uint64_t code, uint64_t action);
+  /** The linear memory of the current instance. */
+  wasm_rt_memory_t* (*memory)(void);
+} eosio_aot_contract;
+
+/** Resolve an intrinsic imported from "env", given its signature as parameter
+ * types then result types ("(iiI)i", using i, I, f and F for i32, i64, f32 and
+ * f64). Returns the binding to pass to `eosio_aot_call`, or -1 after reporting
+ * a signature mismatch on stderr. */
+extern int eosio_aot_bind(const char* name, const char* signature);
+
+/** Call a bound intrinsic. A nonzero result means the action must stop; the
+ * caller then traps with `wasm_rt_trap`. */
+extern int eosio_aot_call(int binding,
+                          const eosio_aot_value* args,
+                          eosio_aot_value* result);
+
+/** Run the actions file given on the command line against the contracts, the
+ * way eosio-run does. `bind_imports` binds every intrinsic the contracts
+ * import, returning nonzero on failure. Returns the exit code of the run. */
+extern int eosio_aot_main(int argc,
+                          char** argv,
+                          const eosio_aot_contract* contracts,
+                          size_t count,
+                          int (*bind_imports)(void));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EOSIO_AOT_RT_H_ */
@@ -21,6 +21,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define PAGE_SIZE 65536
 
@@ -103,9 +104,16 @@ uint32_t wasm_rt_grow_memory(wasm_rt_memory_t* memory, uint32_t delta) {
   if (new_pages < old_pages || new_pages > memory->max_pages) {
     return (uint32_t)-1;
   }
-  memory->data = realloc(memory->data, new_pages);
+  uint32_t old_size = memory->size;
+  uint32_t new_size = new_pages * PAGE_SIZE;
+  uint8_t* new_data = realloc(memory->data, new_size);
+  if (new_data == NULL) {
+    return (uint32_t)-1;
+  }
+  memset(new_data + old_size, 0, new_size - old_size);
+  memory->data = new_data;
   memory->pages = new_pages;
-  memory->size = new_pages * PAGE_SIZE;
+  memory->size = new_size;
   return old_pages;
 }
 
@@ -410,9 +410,16 @@ struct generation_utils {
          {"capi_checksum512", "checksum512"},
          {"fixed_bytes_20", "checksum160"},
          {"fixed_bytes_32", "checksum256"},
-         {"fixed_bytes_64", "checksum512"}
+         {"fixed_bytes_64", "checksum512"},
+         {"byte_checksum_20", "checksum160"},
+         {"byte_checksum_32", "checksum256"},
+         {"byte_checksum_64", "checksum512"}
       };
-      
+
+      // fixed_decimal<Precision> serializes as its raw int128 value
+      if (t.rfind("fixed_decimal_", 0) == 0)
+         return "int128";
+
       auto ret = translation_table[t];
 
       if (ret == "")
@@ -457,7 +464,7 @@ struct generation_utils {
    inline std::string translate_type( const clang::QualType& type ) {
       if ( is_template_specialization( type, {"ignore"} ) )
          return translate_type(get_template_argument( type ).getAsType() );
-      else if ( is_template_specialization( type, {"binary_extension"} ) ) {
+      else if ( is_template_specialization( type, {"binary_extension", "packed_extension"} ) ) {
          auto t = translate_type(get_template_argument( type ).getAsType());
          return t+"$";
       }
@@ -42,7 +42,7 @@ class Test(ABC):
         pass
 
     def run(self):
-        cf = self.test_json.get("compile_flags")
+        cf = self.test_json.get("compile-flags")
         args = cf if cf else []
 
         eosio_cpp = os.path.join(Config.cdt_path, "eosio-cpp")